@@ -0,0 +1,138 @@
+/*
+ * Bench.c
+ *
+ *	Bus cost of each public driver operation, measured on the host
+ *	simulator. Every operation runs once from a freshly initialized
+ *	board while the simulator counts what went on the wire and how
+ *	long the firmware sat in DELAY_1MS. Wall time is then modeled
+ *	at each bus rate as wire bits / SCL + blocking delays (CPU time
+ *	is not counted)
+ *
+ *	Output is one CSV row per operation, diffed against Bench.csv
+ *	by make bench-check to catch regressions
+ *
+ */
+
+#include <stdio.h>
+#include "Sim.h"
+#include "SimDevices.h"
+#include "I2C.h"
+#include "MPU6050.h"
+#include "TCS34727.h"
+#include "LCD.h"
+#include "UART0.h"
+#include "util.h"
+
+/* List of Benchmark Macros */
+#define BENCH_BUS_MODULE		(0)						//I2C0, the bus every device sits on
+#define BENCH_RATES					(3)
+
+static const uint32_t Bench_Rates[BENCH_RATES] = {100000, 400000, 1000000};
+
+/* Simulated Devices */
+static SIM_MPU6050_t Sim_MPU;
+static SIM_TCS34727_t Sim_TCS;
+static SIM_LCD_t Sim_LCD;
+
+/* Operation under Test: prepare runs first and is not counted */
+typedef struct{
+	const char* name;
+	void (*prepare)(void);
+	void (*run)(void);
+} BENCH_OP_t;
+
+/*
+ *	-------------------Bench_Setup------------------
+ *	Local function that powers up a fresh board: simulator, devices
+ *	on I2C0, UART0, both wide timers and the bus at 400kHz
+ *	Input: None
+ *	Output: None
+ */
+static void Bench_Setup(void){
+	Sim_Init();
+
+	Sim_I2C_Attach(BENCH_BUS_MODULE, Sim_MPU6050_Init(&Sim_MPU, MPU6050_ADDR_AD0_LOW));
+	Sim_I2C_Attach(BENCH_BUS_MODULE, Sim_TCS34727_Init(&Sim_TCS, TCS34727_ADDR));
+	Sim_I2C_Attach(BENCH_BUS_MODULE, Sim_LCD_Init(&Sim_LCD, LCD_WRITE_ADDR));
+	Sim_MPU6050_Set_Motion(&Sim_MPU, 16384, -8192, 4096, 0, 131, -262, 655);
+	Sim_TCS34727_Set_Color(&Sim_TCS, 1000, 513, 300, 258);
+
+	UART0_Init();
+	WTIMER0_Init();
+	WTIMER1_Init();
+	I2C_Init_Speed(&I2C0_Bus, I2C_SPEED_FAST, SYS_CLOCK_HZ);
+}
+
+/* Operations */
+static void Bench_MPU6050_Prepare(void){ MPU6050_Init(&I2C0_Bus); Sim_Run_NS(2000000); }
+static void Bench_TCS34727_Prepare(void){ TCS34727_Init(&I2C0_Bus); Sim_Run_NS(5000000); }
+static void Bench_LCD_Prepare(void){ LCD_Init(&I2C0_Bus); }
+
+static void Bench_MPU6050_Init(void){ MPU6050_Init(&I2C0_Bus); }
+static void Bench_MPU6050_Get_Accel(void){ MPU6050_ACCEL_t accel; MPU6050_Get_Accel(&accel); }
+static void Bench_MPU6050_Get_Gyro(void){ MPU6050_GYRO_t gyro; MPU6050_Get_Gyro(&gyro); }
+static void Bench_MPU6050_Fifo_Prepare(void){ Bench_MPU6050_Prepare(); MPU6050_Fifo_Start(FIFO_EN_ACCEL|FIFO_EN_GYRO); Sim_Run_NS(20500000); }
+static void Bench_MPU6050_Fifo_Read(void){ uint8_t buf[20*12]; uint16_t frames; MPU6050_Fifo_Read(buf, 20, &frames); }
+static void Bench_MPU6050_Get_Motion(void){ MPU6050_ACCEL_t accel; MPU6050_GYRO_t gyro; MPU6050_TEMP_t temp; MPU6050_Get_Motion(&accel, &gyro, &temp); }
+static void Bench_TCS34727_Init(void){ TCS34727_Init(&I2C0_Bus); }
+static void Bench_TCS34727_GET_RGB(void){ RGB_COLOR_HANDLE_t rgb; TCS34727_GET_RGB(&rgb); }
+static void Bench_LCD_Init(void){ LCD_Init(&I2C0_Bus); }
+static void Bench_LCD_Set_Cursor(void){ LCD_Set_Cursor(ROW2, 3); }
+static void Bench_LCD_Print_Str(void){ LCD_Print_Str((uint8_t*)"HELLO WORLD 0123"); }
+
+static const BENCH_OP_t Bench_Ops[] = {
+	{"MPU6050_Init",						0,												Bench_MPU6050_Init},
+	{"MPU6050_Get_Accel",				Bench_MPU6050_Prepare,		Bench_MPU6050_Get_Accel},
+	{"MPU6050_Get_Gyro",				Bench_MPU6050_Prepare,		Bench_MPU6050_Get_Gyro},
+	{"MPU6050_Get_Motion",			Bench_MPU6050_Prepare,		Bench_MPU6050_Get_Motion},
+	{"MPU6050_Fifo_Read(20)",		Bench_MPU6050_Fifo_Prepare,	Bench_MPU6050_Fifo_Read},
+	{"TCS34727_Init",						0,												Bench_TCS34727_Init},
+	{"TCS34727_GET_RGB",				Bench_TCS34727_Prepare,		Bench_TCS34727_GET_RGB},
+	{"LCD_Init",								0,												Bench_LCD_Init},
+	{"LCD_Set_Cursor",					Bench_LCD_Prepare,				Bench_LCD_Set_Cursor},
+	{"LCD_Print_Str(16)",				Bench_LCD_Prepare,				Bench_LCD_Print_Str},
+};
+
+/*
+ *	-------------------Bench_Run------------------
+ *	Local function that measures one operation and prints its row
+ *	Input: Operation
+ *	Output: None
+ */
+static void Bench_Run(const BENCH_OP_t* op){
+
+	SIM_I2C_COUNTERS_t counters;
+	uint64_t delay_ns;
+	uint8_t i;
+
+	Bench_Setup();
+	if(op->prepare)
+		op->prepare();
+
+	Sim_I2C_Counters(BENCH_BUS_MODULE, 1);
+	Sim_Delay_NS(1);
+
+	op->run();
+
+	counters = Sim_I2C_Counters(BENCH_BUS_MODULE, 0);
+	delay_ns = Sim_Delay_NS(0);
+
+	printf("%s,%u,%u,%u,%u,%u,%llu", op->name, counters.stops, counters.starts, counters.addresses,
+		counters.data_bytes, counters.bits, (unsigned long long)(delay_ns / 1000));
+
+	//Modeled wall time at each rate
+	for(i = 0; i < BENCH_RATES; i++)
+		printf(",%llu", (unsigned long long)((counters.bits * 1000000ULL + Bench_Rates[i] - 1) / Bench_Rates[i] + delay_ns / 1000));
+	printf("\n");
+}
+
+int main(void){
+
+	uint32_t i;
+
+	printf("op,transactions,starts,addresses,data_bytes,bits,delay_us,t_100k_us,t_400k_us,t_1m_us\n");
+	for(i = 0; i < sizeof(Bench_Ops)/sizeof(Bench_Ops[0]); i++)
+		Bench_Run(&Bench_Ops[i]);
+
+	return 0;
+}
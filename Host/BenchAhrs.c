@@ -0,0 +1,167 @@
+/*
+ * BenchAhrs.c
+ *
+ *	CPU cost and convergence of the orientation estimator compiled
+ *	in (make AHRS=MAHONY bench-ahrs for the Mahony one) on synthetic
+ *	motion traces:
+ *
+ *		update		ns and time stamp counter ticks (x86 hosts) per AHRS_Update
+ *		converge	seconds to pull a 60 degree tilt error under 1 degree
+ *		tumble		worst and RMS tilt error, final full error, on 60s of
+ *							tumbling at 1kHz with 1 degree/s gyro noise
+ *		bias			the same with a 0.5 degree/s gyro bias on every axis
+ *
+ *	Timings are host CPU time and vary from run to run, they are
+ *	printed only, never diffed
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "AHRS.h"
+#include "SimMotion.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_TICKS()				(__rdtsc())
+#else
+#define BENCH_TICKS()				(0ULL)
+#endif
+
+/* List of Benchmark Macros */
+#define BENCH_SAMPLES				(60000)				//60s at 1kHz
+#define BENCH_DT_US					(1000)
+
+static MPU6050_ACCEL_t Bench_Accel[BENCH_SAMPLES];
+static MPU6050_GYRO_t Bench_Gyro[BENCH_SAMPLES];
+
+/*
+ *	-------------------Bench_Rate------------------
+ *	Local function, body rates of the tumbling trace
+ *	Input: Sample Index & Rates (filled, degrees/s)
+ *	Output: None
+ */
+static void Bench_Rate(uint32_t i, float rate[3]){
+	rate[0] = 100.0f*sinf(i*0.00314f);
+	rate[1] = 70.0f*sinf(i*0.00188f + 1.0f);
+	rate[2] = 45.0f;
+}
+
+/*
+ *	-------------------Bench_Update------------------
+ *	Local function that times AHRS_Update over a recorded trace
+ *	Input: None
+ *	Output: None
+ */
+static void Bench_Update(void){
+
+	SIM_MOTION_t motion;
+	AHRS_t ahrs;
+	float rate[3];
+	unsigned long long ticks;
+	clock_t start;
+	double seconds;
+	uint32_t i;
+
+	Sim_Motion_Init(&motion, 10.0f, 5.0f, 0, 1.0f);
+	for(i = 0; i < BENCH_SAMPLES; i++){
+		Bench_Rate(i, rate);
+		Sim_Motion_Step(&motion, rate, BENCH_DT_US*1e-6f, &Bench_Accel[i], &Bench_Gyro[i]);
+	}
+
+	AHRS_Init(&ahrs);
+	start = clock();
+	ticks = BENCH_TICKS();
+	for(i = 0; i < BENCH_SAMPLES; i++)
+		AHRS_Update(&ahrs, &Bench_Accel[i], &Bench_Gyro[i], i*BENCH_DT_US);
+	ticks = BENCH_TICKS() - ticks;
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("update,%.1f ns,%.0f ticks\n", seconds * 1e9 / BENCH_SAMPLES, (double)ticks / BENCH_SAMPLES);
+}
+
+/*
+ *	-------------------Bench_Converge------------------
+ *	Local function, time to pull in a 60 degree tilt error
+ *	Input: None
+ *	Output: None
+ */
+static void Bench_Converge(void){
+
+	static const float still[3] = {0, 0, 0};
+	SIM_MOTION_t motion;
+	AHRS_t ahrs;
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	double tilt = 0;
+	uint32_t i;
+
+	AHRS_Init(&ahrs);
+	Sim_Motion_Init(&motion, 0, 0, 0, 0);
+	Sim_Motion_Step(&motion, still, BENCH_DT_US*1e-6f, &accel, &gyro);
+	AHRS_Update(&ahrs, &accel, &gyro, 0);
+
+	Sim_Motion_Init(&motion, 60.0f, 0, 0, 0);
+	for(i = 1; i <= BENCH_SAMPLES; i++){
+		Sim_Motion_Step(&motion, still, BENCH_DT_US*1e-6f, &accel, &gyro);
+		AHRS_Update(&ahrs, &accel, &gyro, i*BENCH_DT_US);
+		Sim_Motion_Error(&motion, ahrs.q, &tilt);
+		if(tilt < 1.0)
+			break;
+	}
+
+	if(tilt < 1.0)
+		printf("converge,%.3f s\n", i * BENCH_DT_US * 1e-6);
+	else
+		printf("converge,never\n");
+}
+
+/*
+ *	-------------------Bench_Tumble------------------
+ *	Local function, tracking error over the tumbling trace
+ *	Input: Trace Name & Gyro Bias in degrees/s
+ *	Output: None
+ */
+static void Bench_Tumble(const char* name, float bias){
+
+	SIM_MOTION_t motion;
+	AHRS_t ahrs;
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	float rate[3];
+	double tilt;
+	double worst = 0;
+	double sum_sq = 0;
+	double error = 0;
+	uint32_t i;
+
+	AHRS_Init(&ahrs);
+	Sim_Motion_Init(&motion, 10.0f, 5.0f, bias, 1.0f);
+	for(i = 0; i < BENCH_SAMPLES; i++){
+		Bench_Rate(i, rate);
+		Sim_Motion_Step(&motion, rate, BENCH_DT_US*1e-6f, &accel, &gyro);
+		AHRS_Update(&ahrs, &accel, &gyro, i*BENCH_DT_US);
+		error = Sim_Motion_Error(&motion, ahrs.q, &tilt);
+		worst = fmax(worst, tilt);
+		sum_sq += tilt*tilt;
+	}
+
+	printf("%s,worst tilt %.3f deg,rms tilt %.3f deg,final error %.2f deg (yaw drifts without a magnetometer)\n",
+		name, worst, sqrt(sum_sq / BENCH_SAMPLES), error);
+}
+
+int main(void){
+
+#ifdef AHRS_MAHONY
+	printf("AHRS Mahony\n");
+#else
+	printf("AHRS Madgwick\n");
+#endif
+	Bench_Update();
+	Bench_Converge();
+	Bench_Tumble("tumble", 0);
+	Bench_Tumble("bias", 0.5f);
+
+	return 0;
+}
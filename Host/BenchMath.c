@@ -0,0 +1,138 @@
+/*
+ * BenchMath.c
+ *
+ *	CPU cost and accuracy of the FastMath kernels next to the libm
+ *	calls they replace, and of MPU6050_Get_Angle_Fast next to
+ *	MPU6050_Get_Angle. Errors are against double precision libm
+ *
+ *	Timings are host CPU time: the host has a double precision FPU,
+ *	the Cortex-M4F doesn't, so the gap on the target is wider. They
+ *	vary from run to run and are printed only, never diffed
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "FastMath.h"
+#include "MPU6050.h"
+
+/* List of Benchmark Macros */
+#define BENCH_POINTS				(4096)				//Inputs, spread over every direction
+#define BENCH_PASSES				(500)
+#define BENCH_PI						(3.14159265358979)
+
+/* One Kernel: computes one input, returns the error against libm */
+typedef struct{
+	const char* name;
+	double (*run)(uint32_t i, uint8_t check);
+} BENCH_KERNEL_t;
+
+static float Bench_X[BENCH_POINTS];
+static float Bench_Y[BENCH_POINTS];
+static int32_t Bench_QX[BENCH_POINTS];
+static int32_t Bench_QY[BENCH_POINTS];
+
+/* Keeps the results from being optimized away */
+static volatile float Bench_Sink;
+
+/* Kernels */
+static double Bench_Libm_Atan2(uint32_t i, uint8_t check){ Bench_Sink = (float)atan2(Bench_Y[i], Bench_X[i]); return 0; }
+static double Bench_Libm_Atan2f(uint32_t i, uint8_t check){ Bench_Sink = atan2f(Bench_Y[i], Bench_X[i]); return check ? fabs(Bench_Sink - atan2(Bench_Y[i], Bench_X[i])) : 0; }
+static double Bench_Fast_Atan2(uint32_t i, uint8_t check){ Bench_Sink = FastMath_Atan2(Bench_Y[i], Bench_X[i]); return check ? fabs(Bench_Sink - atan2(Bench_Y[i], Bench_X[i])) : 0; }
+static double Bench_Fast_Atan2_Q(uint32_t i, uint8_t check){ Bench_Sink = FastMath_Atan2_Q(Bench_QY[i], Bench_QX[i]); return check ? fabs(Bench_Sink / 1000.0 - atan2(Bench_QY[i], Bench_QX[i]) * 180 / BENCH_PI) * BENCH_PI / 180 : 0; }
+static double Bench_Libm_InvSqrt(uint32_t i, uint8_t check){ Bench_Sink = (float)(1 / sqrt(Bench_X[i]*Bench_X[i] + 1)); return 0; }
+static double Bench_Fast_InvSqrt(uint32_t i, uint8_t check){ float v = Bench_X[i]*Bench_X[i] + 1; Bench_Sink = FastMath_InvSqrt(v); return check ? fabs(Bench_Sink * sqrt(v) - 1) : 0; }
+static double Bench_Libm_Hypot(uint32_t i, uint8_t check){ Bench_Sink = (float)sqrt(Bench_X[i]*Bench_X[i] + Bench_Y[i]*Bench_Y[i]); return 0; }
+static double Bench_Fast_Hypot(uint32_t i, uint8_t check){ Bench_Sink = FastMath_Hypot(Bench_X[i], Bench_Y[i]); return check ? fabs(Bench_Sink / hypot(Bench_X[i], Bench_Y[i]) - 1) : 0; }
+static double Bench_Fast_Hypot_Q(uint32_t i, uint8_t check){ Bench_Sink = FastMath_Hypot_Q(Bench_QX[i], Bench_QY[i]); return check ? fabs(Bench_Sink - hypot(Bench_QX[i], Bench_QY[i])) : 0; }
+
+/*
+ *	-------------------Bench_Angle------------------
+ *	Local function, one tilt angle computation (libm or fast)
+ *	Input: Input Index, Check Flag & Fast Flag
+ *	Output: Worst axis error against MPU6050_Get_Angle in degrees
+ */
+static double Bench_Angle(uint32_t i, uint8_t check, uint8_t fast){
+
+	MPU6050_ACCEL_t accel;
+	MPU6050_ANGLE_t angle;
+	MPU6050_ANGLE_t ref;
+
+	accel.Ax = Bench_X[i];
+	accel.Ay = Bench_Y[i];
+	accel.Az = 0.5f - Bench_X[i] * Bench_Y[i];
+	if(fast)
+		MPU6050_Get_Angle_Fast(&accel, 0, &angle);
+	else
+		MPU6050_Get_Angle(&accel, 0, &angle);
+	Bench_Sink = angle.ArX + angle.ArY + angle.ArZ;
+	if(!check)
+		return 0;
+
+	MPU6050_Get_Angle(&accel, 0, &ref);
+	return fmax(fabs(angle.ArX - ref.ArX), fmax(fabs(angle.ArY - ref.ArY), fabs(angle.ArZ - ref.ArZ)));
+}
+static double Bench_Libm_Angle(uint32_t i, uint8_t check){ return Bench_Angle(i, check, 0); }
+static double Bench_Fast_Angle(uint32_t i, uint8_t check){ return Bench_Angle(i, check, 1); }
+
+static const BENCH_KERNEL_t Bench_Kernels[] = {
+	{"atan2 (libm double)",					Bench_Libm_Atan2},
+	{"atan2f (libm)",								Bench_Libm_Atan2f},
+	{"FastMath_Atan2",							Bench_Fast_Atan2},
+	{"FastMath_Atan2_Q",						Bench_Fast_Atan2_Q},
+	{"1/sqrt (libm double)",				Bench_Libm_InvSqrt},
+	{"FastMath_InvSqrt",						Bench_Fast_InvSqrt},
+	{"sqrt(x*x+y*y) (libm double)",	Bench_Libm_Hypot},
+	{"FastMath_Hypot",							Bench_Fast_Hypot},
+	{"FastMath_Hypot_Q",						Bench_Fast_Hypot_Q},
+	{"MPU6050_Get_Angle",						Bench_Libm_Angle},
+	{"MPU6050_Get_Angle_Fast",			Bench_Fast_Angle},
+};
+
+/*
+ *	-------------------Bench_Run------------------
+ *	Local function that times one kernel and prints its row
+ *	Input: Kernel
+ *	Output: None
+ */
+static void Bench_Run(const BENCH_KERNEL_t* kernel){
+
+	double max_err = 0;
+	clock_t start;
+	double seconds;
+	uint32_t pass;
+	uint32_t i;
+
+	start = clock();
+	for(pass = 0; pass < BENCH_PASSES; pass++)
+		for(i = 0; i < BENCH_POINTS; i++)
+			kernel->run(i, 0);
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	for(i = 0; i < BENCH_POINTS; i++)
+		max_err = fmax(max_err, kernel->run(i, 1));
+
+	printf("%s,%.2f,%.3g\n", kernel->name, seconds * 1e9 / ((double)BENCH_PASSES * BENCH_POINTS), max_err);
+}
+
+int main(void){
+
+	double t;
+	uint32_t i;
+
+	//Unit circle at 1.5g for the float kernels, full fixed point range for the integer ones
+	for(i = 0; i < BENCH_POINTS; i++){
+		t = -BENCH_PI + i * (2*BENCH_PI / BENCH_POINTS);
+		Bench_X[i] = (float)(1.5 * cos(t));
+		Bench_Y[i] = (float)(1.5 * sin(t));
+		Bench_QX[i] = (int32_t)(FAST_MATH_Q_MAX * cos(t));
+		Bench_QY[i] = (int32_t)(FAST_MATH_Q_MAX * sin(t));
+	}
+
+	printf("kernel,ns_per_call,max_err (rad, relative, or degrees for the angles)\n");
+	for(i = 0; i < sizeof(Bench_Kernels)/sizeof(Bench_Kernels[0]); i++)
+		Bench_Run(&Bench_Kernels[i]);
+
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * BenchScale.c
+ *
+ *	CPU cost and accuracy of the MPU6050 raw-to-physical conversions
+ *	on the host: the old path (switch on the range, float divided by
+ *	a double literal) next to the multiply by the precomputed scale
+ *	and the integer only Q16 path. Every raw reading is converted at
+ *	every full scale range, errors are against exact double math
+ *
+ *	Timings are host CPU time and vary from run to run, so unlike
+ *	Bench they are printed only, never diffed
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "Sim.h"
+#include "SimDevices.h"
+#include "I2C.h"
+#include "MPU6050.h"
+#include "UART0.h"
+#include "util.h"
+
+/* List of Benchmark Macros */
+#define BENCH_BUS_MODULE		(0)						//I2C0
+#define BENCH_PASSES				(20)					//Sweeps of all 65536 raw readings per range
+
+/* Simulated Devices */
+static SIM_MPU6050_t Sim_MPU;
+
+static const uint8_t Bench_Gyro_Sel[4] = {GYRO_FS_SEL_0, GYRO_FS_SEL_1, GYRO_FS_SEL_2, GYRO_FS_SEL_3};
+static const double Bench_Gyro_LSB[4] = {131.0, 65.5, 32.8, 16.4};
+
+/* Keeps the conversions from being optimized away */
+static volatile float Bench_Sink;
+static volatile int32_t Bench_Sink_Int;
+
+/* Range setting the old path switched on (it read the register cache every call) */
+static volatile uint8_t Bench_Config;
+
+/*
+ *	-------------------Bench_Legacy_Gyro------------------
+ *	Local copy of the conversion before the precomputed scales
+ *	Input: MPU6050 Gyro User Instance Struct
+ *	Output: None
+ */
+static void Bench_Legacy_Gyro(MPU6050_GYRO_t* Gyro_Instance){
+	switch(Bench_Config){
+		case GYRO_FS_SEL_0:
+			Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW / 131.0;
+			Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW / 131.0;
+			Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW / 131.0;
+			break;
+		case GYRO_FS_SEL_1:
+			Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW / 65.5;
+			Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW / 65.5;
+			Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW / 65.5;
+			break;
+		case GYRO_FS_SEL_2:
+			Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW / 32.8;
+			Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW / 32.8;
+			Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW / 32.8;
+			break;
+		case GYRO_FS_SEL_3:
+			Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW / 16.4;
+			Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW / 16.4;
+			Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW / 16.4;
+			break;
+	}
+}
+
+/*
+ *	-------------------Bench_Path------------------
+ *	Local function that times one conversion path over every range
+ *	and reports its worst error
+ *	Input: Path Name & Path Number (0 old, 1 multiply, 2 Q16)
+ *	Output: None
+ */
+static void Bench_Path(const char* name, uint8_t path){
+
+	MPU6050_GYRO_t gyro;
+	MPU6050_GYRO_MDPS_t gyro_mdps;
+	double max_err = 0;
+	double err;
+	double seconds = 0;
+	clock_t start;
+	int32_t raw;
+	uint32_t pass;
+	uint8_t i;
+
+	for(i = 0; i < 4; i++){
+		I2C_Transmit(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, GYRO_CONFIG, Bench_Gyro_Sel[i]);
+		MPU6050_Refresh_Config();
+		Bench_Config = Bench_Gyro_Sel[i];
+
+		start = clock();
+		for(pass = 0; pass < BENCH_PASSES; pass++){
+			for(raw = -32768; raw <= 32767; raw++){
+				gyro.Gx_RAW = gyro.Gy_RAW = gyro.Gz_RAW = (int16_t)raw;
+				if(path == 0)
+					Bench_Legacy_Gyro(&gyro);
+				else if(path == 1)
+					MPU6050_Process_Gyro(&gyro);
+				else
+					MPU6050_Process_Gyro_mdps(&gyro, &gyro_mdps);
+				if(path == 2)
+					Bench_Sink_Int = gyro_mdps.Gz;
+				else
+					Bench_Sink = gyro.Gz;
+			}
+		}
+		seconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+		//Accuracy, one more sweep
+		for(raw = -32768; raw <= 32767; raw++){
+			gyro.Gx_RAW = gyro.Gy_RAW = gyro.Gz_RAW = (int16_t)raw;
+			if(path == 0)
+				Bench_Legacy_Gyro(&gyro);
+			else if(path == 1)
+				MPU6050_Process_Gyro(&gyro);
+			else
+				MPU6050_Process_Gyro_mdps(&gyro, &gyro_mdps);
+			err = (path == 2) ? fabs(gyro_mdps.Gz - 1000.0 * raw / Bench_Gyro_LSB[i]) : 1000.0 * fabs(gyro.Gz - raw / Bench_Gyro_LSB[i]);
+			if(err > max_err)
+				max_err = err;
+		}
+	}
+
+	printf("%s,%.2f,%.6f\n", name, seconds * 1e9 / (4.0 * BENCH_PASSES * 65536 * 3), max_err);
+}
+
+int main(void){
+
+	Sim_Init();
+	Sim_I2C_Attach(BENCH_BUS_MODULE, Sim_MPU6050_Init(&Sim_MPU, MPU6050_ADDR_AD0_LOW));
+	UART0_Init();
+	WTIMER0_Init();
+	WTIMER1_Init();
+	I2C_Init_Speed(&I2C0_Bus, I2C_SPEED_FAST, SYS_CLOCK_HZ);
+	MPU6050_Init(&I2C0_Bus);
+
+	printf("path,ns_per_axis,max_err_mdps\n");
+	Bench_Path("divide (old)", 0);
+	Bench_Path("multiply", 1);
+	Bench_Path("q16 integer", 2);
+
+	return 0;
+}
@@ -0,0 +1,1955 @@
+/*
+ * HostTest.c
+ *
+ *	Runs the unmodified drivers against the host simulator and the
+ *	device models. Each test prints its checks, the program exits
+ *	with the number of failed checks so make can tell
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stddef.h>
+#include "Sim.h"
+#include "SimDevices.h"
+#include "I2C.h"
+#include "I2CSched.h"
+#include "RegCache.h"
+#include "RegBatch.h"
+#include "Ring.h"
+#include "Snapshot.h"
+#include "FastMath.h"
+#include "Tilt.h"
+#include "AHRS.h"
+#include "SimMotion.h"
+#include "EEPROM.h"
+#include "Calib.h"
+#include "MPU6050.h"
+#include "TCS34727.h"
+#include "LCD.h"
+#include "UART0.h"
+#include "util.h"
+
+/* List of Test Macros */
+#define TEST_BUS_MODULE			(0)						//I2C0, the bus every device sits on
+#define TEST_FLOAT_EPS			(0.001f)
+#define TEST_PI							(3.14159265358979)
+
+#define CHECK(cond)					Test_Check((cond), #cond, __LINE__)
+#define CHECK_NEAR(a, b)		Test_Check(fabsf((float)(a) - (float)(b)) < TEST_FLOAT_EPS, #a " == " #b, __LINE__)
+
+/* Simulated Devices */
+static SIM_MPU6050_t Sim_MPU;
+static SIM_TCS34727_t Sim_TCS;
+static SIM_LCD_t Sim_LCD;
+static SIM_REGS_t Sim_Mag;																	//On the MPU6050 aux bus
+static SIM_REGS_t Sim_Baro;
+
+static uint32_t Test_Passed;
+static uint32_t Test_Failed;
+
+/* Data Ready Callback Record */
+static uint32_t Test_DR_Calls;
+static SAMPLE_t Test_DR_Last;
+
+/* Scheduler Completion Record */
+static I2C_SCHED_JOB_t* Test_Sched_Order[8];
+static uint32_t Test_Sched_Count;
+static uint32_t Test_Sched_Masked;														//Callbacks that ran with interrupts masked
+static uint32_t Test_Sched_Depth;
+static uint32_t Test_Sched_Max_Depth;
+static I2C_SCHED_t* Test_Sched_Again;													//Resubmit finished jobs here...
+static uint32_t Test_Sched_Again_Left;												//...this many more times
+
+/* Aborted Transaction Record */
+static uint8_t Test_Abort_Status;
+static uint32_t Test_Abort_Masked;														//Callbacks that ran with interrupts masked
+
+/* PE1 handler the MPU6050 INT line is wired to */
+void GPIOPortE_Handler(void);
+
+/* Interrupt mask START_CRITICAL/END_CRITICAL keep on the host */
+extern volatile uint32_t HOST_PRIMASK;
+
+/*
+ *	-------------------Test_Check------------------
+ *	Local function that records one check
+ *	Input: Result, Expression Text & Line
+ *	Output: None
+ */
+static void Test_Check(int ok, const char* what, int line){
+	if(ok){
+		Test_Passed++;
+	}
+	else{
+		Test_Failed++;
+		printf("    FAIL line %d: %s\n", line, what);
+	}
+}
+
+/*
+ *	-------------------Test_Setup------------------
+ *	Local function that powers up a fresh board: simulator, devices
+ *	on I2C0, UART0, both wide timers and the bus at 400kHz
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Setup(void){
+	Sim_Init();
+
+	Sim_I2C_Attach(TEST_BUS_MODULE, Sim_MPU6050_Init(&Sim_MPU, MPU6050_ADDR_AD0_LOW));
+	Sim_I2C_Attach(TEST_BUS_MODULE, Sim_TCS34727_Init(&Sim_TCS, TCS34727_ADDR));
+	Sim_I2C_Attach(TEST_BUS_MODULE, Sim_LCD_Init(&Sim_LCD, LCD_WRITE_ADDR));
+
+	UART0_Init();
+	WTIMER0_Init();
+	WTIMER1_Init();
+	I2C_Init_Speed(&I2C0_Bus, I2C_SPEED_FAST, SYS_CLOCK_HZ);
+	LCD_Attach_Scheduler(0, 0);
+}
+
+/*
+ *	-------------------Test_Timers------------------
+ *	DELAY_1MS and TIMESTAMP_US follow virtual time
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Timers(void){
+	uint32_t start;
+	uint32_t elapsed;
+
+	Test_Setup();
+
+	start = TIMESTAMP_US();
+	DELAY_1MS(10);
+	elapsed = TIMESTAMP_US() - start;
+	CHECK(elapsed >= 10000 && elapsed < 10100);
+
+	start = TIMESTAMP_US();
+	Sim_Run_NS(250000);
+	elapsed = TIMESTAMP_US() - start;
+	CHECK(elapsed >= 249 && elapsed <= 251);
+}
+
+/*
+ *	-------------------Test_Delay_Short------------------
+ *	The shortest delays wait their full count: WTIMER0 counts TAILR
+ *	down to 0, so TAILR holds the delay itself, not delay-1
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Delay_Short(void){
+	uint32_t start;
+	uint32_t elapsed;
+	uint32_t ms;
+
+	Test_Setup();
+
+	for(ms = 1; ms <= 3; ms++){
+		start = TIMESTAMP_US();
+		DELAY_1MS(ms);
+		elapsed = TIMESTAMP_US() - start;
+		CHECK(elapsed >= ms*1000 && elapsed < ms*1000 + 100);
+	}
+}
+
+/*
+ *	-------------------Test_UART------------------
+ *	UART0 output is captured, input reaches UART0_InChar
+ *	Input: None
+ *	Output: None
+ */
+static void Test_UART(void){
+	Test_Setup();
+
+	UART0_OutString("hello");
+	UART0_OutCRLF();
+	CHECK(strcmp(Sim_UART_Output(0), "hello\r\n") == 0);
+
+	Sim_UART_Input("ab");
+	CHECK(UART0_InChar() == 'a');
+	CHECK(UART0_InChar() == 'b');
+	CHECK(strcmp(Sim_UART_Output(0), "hello\r\n") == 0);
+}
+
+/*
+ *	-------------------Test_I2C_Speed------------------
+ *	I2C_Init_Speed programs MTPR for the rate asked, rounding TPR
+ *	up so SCL never runs faster, refuses rates it can't reach
+ *	without touching the bus, and sets High-Speed mode with its
+ *	master code above 1MHz
+ *	Input: None
+ *	Output: None
+ */
+static void Test_I2C_Speed(void){
+	SIM_I2C_COUNTERS_t counters;
+	uint8_t data;
+
+	Test_Setup();
+
+	//16MHz / (2*(6+4)*100kHz) = 8, TPR = 7
+	CHECK(I2C_Init_Speed(&I2C0_Bus, I2C_SPEED_STANDARD, SYS_CLOCK_HZ) == I2C_STATUS_OK);
+	CHECK(I2C0_MTPR_R == (I2C_MTPR_STD_SPEED|7));
+	CHECK(I2C0_Bus.speed == I2C_SPEED_STANDARD && I2C0_Bus.hs_mode == 0);
+
+	CHECK(I2C_Init_Speed(&I2C0_Bus, I2C_SPEED_FAST, SYS_CLOCK_HZ) == I2C_STATUS_OK);
+	CHECK(I2C0_MTPR_R == (I2C_MTPR_STD_SPEED|1));
+	CHECK(I2C0_Bus.speed == I2C_SPEED_FAST);
+
+	//16MHz / (20*300kHz) = 2.67 rounds up to 3: 267kHz rather than 400kHz
+	CHECK(I2C_Init_Speed(&I2C0_Bus, 300000, SYS_CLOCK_HZ) == I2C_STATUS_OK);
+	CHECK(I2C0_MTPR_R == (I2C_MTPR_STD_SPEED|2));
+	CHECK(I2C0_Bus.speed == 266666);
+
+	//Out of reach: no rate, TPR 0 (1MHz, 3.33MHz) or past 127 (5kHz) at 16MHz, above High-Speed
+	CHECK(I2C_Init_Speed(&I2C3_Bus, 0, SYS_CLOCK_HZ) == I2C_STATUS_INVALID);
+	CHECK(I2C_Init_Speed(&I2C3_Bus, I2C_SPEED_FAST_PLUS, SYS_CLOCK_HZ) == I2C_STATUS_INVALID);
+	CHECK(I2C_Init_Speed(&I2C3_Bus, I2C_SPEED_HIGH, SYS_CLOCK_HZ) == I2C_STATUS_INVALID);
+	CHECK(I2C_Init_Speed(&I2C3_Bus, 5000, SYS_CLOCK_HZ) == I2C_STATUS_INVALID);
+	CHECK(I2C_Init_Speed(&I2C3_Bus, I2C_SPEED_HIGH + 1, 80000000) == I2C_STATUS_INVALID);
+	CHECK(I2C3_Bus.speed == 0 && I2C3_Bus.regs[0x00C>>2] == 0);
+	CHECK((SYSCTL_RCGCI2C_R & I2C3_Bus.i2c_clock) == 0);
+
+	//A refused rate leaves a configured bus as it was
+	CHECK(I2C_Init_Speed(&I2C0_Bus, I2C_SPEED_FAST_PLUS, SYS_CLOCK_HZ) == I2C_STATUS_INVALID);
+	CHECK(I2C0_MTPR_R == (I2C_MTPR_STD_SPEED|2));
+	CHECK(I2C0_Bus.speed == 266666);
+
+	//3.33MHz takes an 80MHz clock: 80MHz / (2*(2+1)*3.33MHz) = 4.004 rounds up to 5, TPR = 4
+	CHECK(I2C_Init_Speed(&I2C0_Bus, I2C_SPEED_HIGH, 80000000) == I2C_STATUS_OK);
+	CHECK(I2C0_MTPR_R == (I2C_MTPR_HS_SPEED|4));
+	CHECK(I2C0_Bus.hs_mode == 1);
+
+	//1.5MHz is High-Speed within reach of 16MHz: 16MHz / (6*1.5MHz) = 1.78, TPR = 1
+	CHECK(I2C_Init_Speed(&I2C0_Bus, 1500000, SYS_CLOCK_HZ) == I2C_STATUS_OK);
+	CHECK(I2C0_MTPR_R == (I2C_MTPR_HS_SPEED|1));
+	CHECK(I2C0_Bus.hs_mode == 1 && I2C0_Bus.speed == 1333333);
+
+	//Master code, then the write and read addresses
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, &data, 1) == I2C_STATUS_OK);
+	CHECK(data == MPU6050_WHO_AM_I_ID);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 0);
+	CHECK(counters.addresses == 3 && counters.stops == 1);
+}
+
+/*
+ *	-------------------Test_MPU6050------------------
+ *	Driver init, raw reads and scaling against the IMU model
+ *	Input: None
+ *	Output: None
+ */
+static void Test_MPU6050(void){
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	MPU6050_TEMP_t temp;
+	uint32_t samples;
+
+	Test_Setup();
+	Sim_MPU6050_Set_Motion(&Sim_MPU, 16384, -8192, 4096, 0, 131, -262, 655);
+
+	MPU6050_Init(&I2C0_Bus);
+	CHECK(strstr(Sim_UART_Output(0), "MPU6050 Initialized") != 0);
+	CHECK(strstr(Sim_UART_Output(0), "Error") == 0);
+	CHECK(Sim_MPU.regs[PWR_MGMT_1] == PWR_CLK_SEL_INTERNAL);
+	CHECK(Sim_MPU.regs[SMPLRT_DIV] == SMPLRT_DIV_8);
+
+	//Awake at 1kHz: 2.5ms holds two or three sample clocks
+	samples = Sim_MPU.samples;
+	Sim_Run_NS(2500000);
+	CHECK(Sim_MPU.samples - samples == 2 || Sim_MPU.samples - samples == 3);
+
+	MPU6050_Get_Accel(&accel);
+	MPU6050_Get_Gyro(&gyro);
+	MPU6050_Process_Accel(&accel);
+	MPU6050_Process_Gyro(&gyro);
+
+	CHECK(accel.Ax_RAW == 16384 && accel.Ay_RAW == -8192 && accel.Az_RAW == 4096);
+	CHECK(gyro.Gx_RAW == 131 && gyro.Gy_RAW == -262 && gyro.Gz_RAW == 655);
+	CHECK_NEAR(accel.Ax, 1.0f);
+	CHECK_NEAR(accel.Ay, -0.5f);
+	CHECK_NEAR(accel.Az, 0.25f);
+	CHECK_NEAR(gyro.Gx, 1.0f);
+	CHECK_NEAR(gyro.Gy, -2.0f);
+	CHECK_NEAR(gyro.Gz, 5.0f);
+
+	//Everything in one burst, temperature included
+	Sim_MPU6050_Set_Motion(&Sim_MPU, -100, 200, -300, -521, 400, -500, 600);
+	Sim_Run_NS(1000000);
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(MPU6050_Get_Motion(&accel, &gyro, &temp) == I2C_STATUS_OK);
+	CHECK(Sim_I2C_Counters(TEST_BUS_MODULE, 0).stops == 1);
+	MPU6050_Process_Temp(&temp);
+	CHECK(accel.Ax_RAW == -100 && accel.Ay_RAW == 200 && accel.Az_RAW == -300);
+	CHECK(gyro.Gx_RAW == 400 && gyro.Gy_RAW == -500 && gyro.Gz_RAW == 600);
+	CHECK(temp.Temp_RAW == -521);
+	CHECK(fabsf(temp.Temp - 35.0f) < 0.01f);
+}
+
+/*
+ *	-------------------Test_MPU6050_Fifo------------------
+ *	FIFO streaming: whole frames come out in one burst, an
+ *	overflowed FIFO is reset and the stream picks up on a frame
+ *	Input: None
+ *	Output: None
+ */
+static void Test_MPU6050_Fifo(void){
+	uint8_t buf[32*12];
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	SIM_I2C_COUNTERS_t counters;
+	uint16_t frames;
+	uint8_t ret;
+
+	Test_Setup();
+	Sim_MPU6050_Set_Motion(&Sim_MPU, 1, 2, 3, 99, 4, 5, 6);
+	MPU6050_Init(&I2C0_Bus);
+	CHECK(MPU6050_Fifo_Start(FIFO_EN_ACCEL|FIFO_EN_GYRO) == I2C_STATUS_OK);
+	CHECK(MPU6050_Fifo_Frame_Size() == 12);
+
+	//About 20 samples at 1kHz, count read + one burst
+	Sim_Run_NS(20500000);
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	ret = MPU6050_Fifo_Read(buf, 32, &frames);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(ret == I2C_STATUS_OK);
+	CHECK(frames >= 19 && frames <= 21);
+	CHECK(counters.stops == 2);
+	memset(&accel, 0, sizeof(accel));
+	memset(&gyro, 0, sizeof(gyro));
+	MPU6050_Fifo_Unpack(buf + 12*(frames - 1), &accel, &gyro, 0);
+	CHECK(accel.Ax_RAW == 1 && accel.Ay_RAW == 2 && accel.Az_RAW == 3);
+	CHECK(gyro.Gx_RAW == 4 && gyro.Gy_RAW == 5 && gyro.Gz_RAW == 6);
+
+	//1024 bytes is 85.3 frames: an overflow cuts frames apart
+	Sim_Run_NS(200000000);
+	ret = MPU6050_Fifo_Read(buf, 32, &frames);
+	CHECK(ret == MPU6050_FIFO_OVERFLOW && frames == 0);
+	Sim_Run_NS(5500000);
+	ret = MPU6050_Fifo_Read(buf, 32, &frames);
+	CHECK(ret == I2C_STATUS_OK && frames >= 4 && frames <= 6);
+	MPU6050_Fifo_Unpack(buf, &accel, &gyro, 0);
+	CHECK(accel.Ax_RAW == 1 && gyro.Gz_RAW == 6);
+
+	CHECK(MPU6050_Fifo_Stop() == I2C_STATUS_OK);
+	CHECK(MPU6050_Fifo_Read(buf, 32, &frames) == I2C_STATUS_INVALID);
+}
+
+/*
+ *	-------------------Test_DR_Callback------------------
+ *	Local function that records what the data ready read hands on
+ *	Input: Sample
+ *	Output: None
+ */
+static void Test_DR_Callback(const SAMPLE_t* sample){
+	Test_DR_Calls++;
+	Test_DR_Last = *sample;
+}
+
+/*
+ *	----------------Test_MPU6050_Data_Ready----------------
+ *	INT pin acquisition: every sample is read exactly once, straight
+ *	from the edge interrupt, into the ring and the callback
+ *	Input: None
+ *	Output: None
+ */
+static void Test_MPU6050_Data_Ready(void){
+	static SIM_GPIO_LINE_t line = {&GPIO_PORTE_RIS_R, &GPIO_PORTE_IM_R, &GPIO_PORTE_MIS_R, &GPIO_PORTE_ICR_R,
+																 &GPIO_PORTE_IEV_R, MPU6050_INT_PIN, GPIOPortE_Handler, 0};
+	static SAMPLE_t storage[16];
+	RING_t ring;
+	SAMPLE_t sample;
+	SIM_I2C_COUNTERS_t counters;
+	uint32_t samples;
+	uint32_t n;
+
+	Test_Setup();
+	line.level = 0;
+	Sim_MPU.int_line = &line;
+	Sim_MPU6050_Set_Motion(&Sim_MPU, 1, 2, 3, 99, 4, 5, 6);
+	MPU6050_Init(&I2C0_Bus);
+	CHECK(Ring_Init(&ring, storage, sizeof(SAMPLE_t), 16) == RING_OK);
+	Test_DR_Calls = 0;
+	CHECK(MPU6050_Data_Ready_Start(&ring, Test_DR_Callback) == I2C_STATUS_OK);
+
+	//About 10 samples at 1kHz: one read per sample and nothing else on the bus
+	samples = Sim_MPU.samples;
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	Sim_Run_NS(10500000);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	n = Sim_MPU.samples - samples;
+	CHECK(n >= 10 && n <= 11);
+	CHECK(Test_DR_Calls == n);
+	CHECK(Ring_Count(&ring) == n);
+	CHECK(counters.stops == n);
+	CHECK(MPU6050_Data_Ready_Missed() == 0);
+
+	CHECK(Ring_Pop(&ring, &sample, 1) == 1);
+	CHECK(sample.flags == SAMPLE_MOTION);
+	CHECK(sample.accel[0] == 1 && sample.accel[1] == 2 && sample.accel[2] == 3);
+	CHECK(sample.temp == 99);
+	CHECK(sample.gyro[0] == 4 && sample.gyro[1] == 5 && sample.gyro[2] == 6);
+	CHECK(Test_DR_Last.timestamp_us - sample.timestamp_us >= 8000);
+
+	//Disarmed: the samples keep coming, the reads don't
+	CHECK(MPU6050_Data_Ready_Stop() == I2C_STATUS_OK);
+	n = Test_DR_Calls;
+	Sim_Run_NS(5000000);
+	CHECK(Test_DR_Calls == n);
+	Sim_MPU.int_line = 0;
+}
+
+/*
+ *	-------------------Test_MPU6050_Scaling------------------
+ *	Multiply and Q16 conversions against dividing by the LSB value,
+ *	every raw reading at every full scale range
+ *	Input: None
+ *	Output: None
+ */
+static void Test_MPU6050_Scaling(void){
+	static const uint8_t accel_sel[4] = {ACCEL_AFS_SEL_0, ACCEL_AFS_SEL_1, ACCEL_AFS_SEL_2, ACCEL_AFS_SEL_3};
+	static const uint8_t gyro_sel[4] = {GYRO_FS_SEL_0, GYRO_FS_SEL_1, GYRO_FS_SEL_2, GYRO_FS_SEL_3};
+	static const double accel_lsb[4] = {16384.0, 8192.0, 4096.0, 2048.0};
+	static const double gyro_lsb[4] = {131.0, 65.5, 32.8, 16.4};
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	MPU6050_ACCEL_MG_t accel_mg;
+	MPU6050_GYRO_MDPS_t gyro_mdps;
+	uint32_t float_bad;
+	uint32_t int_bad;
+	int32_t raw;
+	double exact;
+	uint8_t i;
+
+	Test_Setup();
+	MPU6050_Init(&I2C0_Bus);
+
+	for(i = 0; i < 4; i++){
+		//Changed behind the driver's back, picked up by the refresh
+		I2C_Transmit(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, ACCEL_CONFIG, accel_sel[i]);
+		I2C_Transmit(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, GYRO_CONFIG, gyro_sel[i]);
+		CHECK(MPU6050_Refresh_Config() == I2C_STATUS_OK);
+
+		float_bad = int_bad = 0;
+		for(raw = -32768; raw <= 32767; raw++){
+			accel.Ax_RAW = accel.Ay_RAW = accel.Az_RAW = (int16_t)raw;
+			gyro.Gx_RAW = gyro.Gy_RAW = gyro.Gz_RAW = (int16_t)raw;
+			MPU6050_Process_Accel(&accel);
+			MPU6050_Process_Gyro(&gyro);
+			MPU6050_Process_Accel_mg(&accel, &accel_mg);
+			MPU6050_Process_Gyro_mdps(&gyro, &gyro_mdps);
+
+			//Power of two LSBs: exactly the division
+			if(accel.Ax != (float)raw / (float)accel_lsb[i])
+				float_bad++;
+			exact = raw / gyro_lsb[i];
+			if(fabs(gyro.Gz - exact) > 2.4e-7 * fabs(exact))
+				float_bad++;
+			if(fabs(accel_mg.Ay - 1000.0 * raw / accel_lsb[i]) > 0.5 || fabs(gyro_mdps.Gy - 1000.0 * exact) >= 1.0)
+				int_bad++;
+		}
+		CHECK(float_bad == 0);
+		CHECK(int_bad == 0);
+	}
+
+	//Spot values at the last range (+-16g, +-2000dps)
+	accel.Ax_RAW = 2048;
+	gyro.Gx_RAW = -164;
+	MPU6050_Process_Accel_mg(&accel, &accel_mg);
+	MPU6050_Process_Gyro_mdps(&gyro, &gyro_mdps);
+	CHECK(accel_mg.Ax == 1000);
+	CHECK(gyro_mdps.Gx == -10000);
+}
+
+/*
+ *	-------------------Test_MPU6050_Config------------------
+ *	Runtime configuration: registers, sample rate and scales follow
+ *	it, rejected combinations change nothing, and re-applying the
+ *	running one costs no bus traffic
+ *	Input: None
+ *	Output: None
+ */
+static void Test_MPU6050_Config(void){
+	static const MPU6050_CONFIG_t rejected[] = {
+		{8000,	CONFIG_DFPL_1,	ACCEL_AFS_SEL_0,	GYRO_FS_SEL_0,	PWR_CLK_SEL_INTERNAL},		//8kHz needs the DLPF off
+		{300,		CONFIG_DFPL_3,	ACCEL_AFS_SEL_0,	GYRO_FS_SEL_0,	PWR_CLK_SEL_INTERNAL},		//1kHz/300 isn't whole
+		{2,			CONFIG_DFPL_6,	ACCEL_AFS_SEL_0,	GYRO_FS_SEL_0,	PWR_CLK_SEL_INTERNAL},		//Divider over 256
+		{0,			CONFIG_DFPL_6,	ACCEL_AFS_SEL_0,	GYRO_FS_SEL_0,	PWR_CLK_SEL_INTERNAL},
+		{100,		CONFIG_DFPL_0,	ACCEL_AFS_SEL_0,	GYRO_FS_SEL_0,	PWR_CLK_SEL_INTERNAL},		//Aliases 256Hz bandwidth
+		{50,		CONFIG_DFPL_3,	ACCEL_AFS_SEL_0,	GYRO_FS_SEL_0,	PWR_CLK_SEL_INTERNAL},		//Aliases 42Hz bandwidth
+		{1000,	7,							ACCEL_AFS_SEL_0,	GYRO_FS_SEL_0,	PWR_CLK_SEL_INTERNAL},
+		{1000,	CONFIG_DFPL_0,	0x04,							GYRO_FS_SEL_0,	PWR_CLK_SEL_INTERNAL},
+		{1000,	CONFIG_DFPL_0,	ACCEL_AFS_SEL_0,	0x20,						PWR_CLK_SEL_INTERNAL},
+		{1000,	CONFIG_DFPL_0,	ACCEL_AFS_SEL_0,	GYRO_FS_SEL_0,	PWR_CLK_SEL_STOP},
+	};
+	MPU6050_CONFIG_t defaults = MPU6050_CONFIG_DEFAULT;
+	MPU6050_CONFIG_t config;
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	uint32_t samples;
+	uint8_t i;
+
+	Test_Setup();
+	MPU6050_Init(&I2C0_Bus);
+	CHECK(MPU6050_Get_Config(&config) == I2C_STATUS_OK);
+	CHECK(memcmp(&config, &defaults, sizeof(config)) == 0);
+
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(MPU6050_Configure(&defaults) == I2C_STATUS_OK);
+	CHECK(MPU6050_Get_Config(&config) == I2C_STATUS_OK);
+	for(i = 0; i < sizeof(rejected)/sizeof(rejected[0]); i++)
+		CHECK(MPU6050_Configure(&rejected[i]) == I2C_STATUS_INVALID);
+	CHECK(Sim_I2C_Counters(TEST_BUS_MODULE, 0).commands == 0);
+
+	//200Hz behind a 42Hz DLPF, +-8g, +-500dps on the X gyro PLL
+	config.rate_hz = 200;
+	config.dlpf = CONFIG_DFPL_3;
+	config.accel_range = ACCEL_AFS_SEL_2;
+	config.gyro_range = GYRO_FS_SEL_1;
+	config.clock = PWR_CLK_SEL_PLL_X;
+	CHECK(MPU6050_Configure(&config) == I2C_STATUS_OK);
+	CHECK(Sim_MPU.regs[SMPLRT_DIV] == SMPLRT_DIV_5);
+	CHECK(Sim_MPU.regs[CONFIG] == CONFIG_DFPL_3);
+	CHECK(Sim_MPU.regs[ACCEL_CONFIG] == ACCEL_AFS_SEL_2);
+	CHECK(Sim_MPU.regs[GYRO_CONFIG] == GYRO_FS_SEL_1);
+	CHECK(Sim_MPU.regs[PWR_MGMT_1] == PWR_CLK_SEL_PLL_X);
+	CHECK(MPU6050_Get_Config(&defaults) == I2C_STATUS_OK);
+	CHECK(memcmp(&config, &defaults, sizeof(config)) == 0);
+
+	samples = Sim_MPU.samples;
+	Sim_Run_NS(50000000);
+	CHECK(Sim_MPU.samples - samples == 10);
+
+	//Scales switched with the ranges
+	Sim_MPU6050_Set_Motion(&Sim_MPU, 4096, -2048, 0, 0, 131, 0, -655);
+	Sim_Run_NS(5000000);
+	CHECK(MPU6050_Get_Motion(&accel, &gyro, 0) == I2C_STATUS_OK);
+	MPU6050_Process_Accel(&accel);
+	MPU6050_Process_Gyro(&gyro);
+	CHECK_NEAR(accel.Ax, 1.0f);
+	CHECK_NEAR(accel.Ay, -0.5f);
+	CHECK_NEAR(gyro.Gx, 2.0f);
+	CHECK_NEAR(gyro.Gz, -10.0f);
+
+	//Gyro output rate straight through
+	config.rate_hz = 8000;
+	config.dlpf = CONFIG_DFPL_0;
+	CHECK(MPU6050_Configure(&config) == I2C_STATUS_OK);
+	CHECK(Sim_MPU.regs[SMPLRT_DIV] == SMPLRT_DIV_1);
+	Sim_Run_NS(5000000);																							//Sample already due at 200Hz
+	samples = Sim_MPU.samples;
+	Sim_Run_NS(1000000);
+	CHECK(Sim_MPU.samples - samples == 8);
+}
+
+/*
+ *	-------------------Test_MPU6050_Aux------------------
+ *	Aux I2C master: single transfers to set up secondary sensors,
+ *	their data in the same burst as the IMU sample and through the
+ *	FIFO, and parameter checks
+ *	Input: None
+ *	Output: None
+ */
+static void Test_MPU6050_Aux(void){
+	static const uint8_t mag_data[6] = {0x01, 0x02, 0xFE, 0xDC, 0x7F, 0x80};		//X, Z, Y big endian
+	static const uint8_t baro_data[3] = {0x65, 0x43, 0x21};
+	MPU6050_AUX_SLAVE_t slaves[MPU6050_AUX_SLAVES] = {
+		{0x1E, 0x03, 6, 0},
+		{0x77, 0xF7, 3, 0},
+		{0x77, 0x10, 4, I2C_SLV_BYTE_SW},
+	};
+	MPU6050_AUX_SLAVE_t bad;
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	uint8_t aux[MPU6050_AUX_DATA_SIZE];
+	uint8_t frames[4*12];
+	uint16_t n;
+	uint32_t transfers;
+	uint8_t value;
+	uint8_t i;
+
+	Test_Setup();
+	Sim_MPU6050_Aux_Attach(&Sim_MPU, Sim_Regs_Init(&Sim_Mag, 0x1E));
+	Sim_MPU6050_Aux_Attach(&Sim_MPU, Sim_Regs_Init(&Sim_Baro, 0x77));
+	Sim_Mag.regs[0x0A] = 'H';
+	memcpy(&Sim_Mag.regs[0x03], mag_data, sizeof(mag_data));
+	memcpy(&Sim_Baro.regs[0xF7], baro_data, sizeof(baro_data));
+	Sim_Baro.regs[0x10] = 0x34;
+	Sim_Baro.regs[0x11] = 0x12;
+	Sim_Baro.regs[0x12] = 0x78;
+	Sim_Baro.regs[0x13] = 0x56;
+	MPU6050_Init(&I2C0_Bus);
+	Sim_MPU6050_Set_Motion(&Sim_MPU, 100, -200, 300, 0, 0, 0, 0);
+
+	//Only the MPU6050 is on the main bus
+	CHECK(I2C_Burst_Receive(&I2C0_Bus, 0x1E, 0x0A, &value, 1) != I2C_STATUS_OK);
+
+	//Single transfers through SLV4, the master is off again after each
+	CHECK(MPU6050_Aux_Write(0x1E, 0x02, 0x01) == I2C_STATUS_OK);
+	CHECK(Sim_Mag.regs[0x02] == 0x01);
+	CHECK(MPU6050_Aux_Read(0x1E, 0x0A, &value) == I2C_STATUS_OK);
+	CHECK(value == 'H');
+	CHECK(MPU6050_Aux_Read(0x50, 0x00, &value) == MPU6050_AUX_NACK);
+	CHECK(MPU6050_Aux_Write(0x80, 0x00, 0) == I2C_STATUS_INVALID);
+	CHECK(!(Sim_MPU.regs[USER_CTRL] & USER_I2C_MST_EN));
+	CHECK(MPU6050_Aux_Size() == 0);
+
+	//Rejected slave sets
+	bad = slaves[0];
+	CHECK(MPU6050_Aux_Start(slaves, 0) == I2C_STATUS_INVALID);
+	CHECK(MPU6050_Aux_Start(slaves, MPU6050_AUX_SLAVES + 1) == I2C_STATUS_INVALID);
+	bad.len = 16;
+	CHECK(MPU6050_Aux_Start(&bad, 1) == I2C_STATUS_INVALID);
+	bad.len = 6;
+	bad.addr = 0x9E;
+	CHECK(MPU6050_Aux_Start(&bad, 1) == I2C_STATUS_INVALID);
+	slaves[3] = slaves[0];
+	slaves[3].len = 15;
+	CHECK(MPU6050_Aux_Start(slaves, 4) == I2C_STATUS_INVALID);				//28 bytes
+	CHECK(MPU6050_Fifo_Start(FIFO_EN_ACCEL|FIFO_EN_SLV0) == I2C_STATUS_INVALID);
+
+	//Magnetometer, barometer and a little endian word, read with every sample
+	CHECK(MPU6050_Aux_Start(slaves, 3) == I2C_STATUS_OK);
+	CHECK(MPU6050_Aux_Size() == 13);
+	Sim_Run_NS(2000000);
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(MPU6050_Get_Motion_Aux(&accel, &gyro, 0, aux) == I2C_STATUS_OK);
+	CHECK(Sim_I2C_Counters(TEST_BUS_MODULE, 0).stops == 1);
+	CHECK(accel.Ax_RAW == 100 && accel.Ay_RAW == -200 && accel.Az_RAW == 300);
+	CHECK(memcmp(aux, mag_data, 6) == 0);
+	CHECK(memcmp(aux + 6, baro_data, 3) == 0);
+	CHECK(aux[9] == 0x12 && aux[10] == 0x34 && aux[11] == 0x56 && aux[12] == 0x78);
+
+	//Both from the same sample
+	Sim_MPU6050_Set_Motion(&Sim_MPU, 111, 0, 0, 0, 0, 0, 0);
+	Sim_Mag.regs[0x03] = 0x55;
+	Sim_Run_NS(1000000);
+	CHECK(MPU6050_Get_Motion_Aux(&accel, &gyro, 0, aux) == I2C_STATUS_OK);
+	CHECK(accel.Ax_RAW == 111 && aux[0] == 0x55);
+
+	//Through the FIFO behind the accelerometer, the master keeps running
+	CHECK(MPU6050_Fifo_Start(FIFO_EN_ACCEL|FIFO_EN_SLV0|FIFO_EN_SLV2) == I2C_STATUS_OK);
+	CHECK(MPU6050_Fifo_Frame_Size() == 6 + 6 + 4);
+	CHECK(MPU6050_Aux_Start(slaves, 1) == I2C_STATUS_INVALID);
+	CHECK(MPU6050_Aux_Stop() == I2C_STATUS_INVALID);
+	Sim_Run_NS(3500000);
+	CHECK(MPU6050_Fifo_Read(frames, 3, &n) == I2C_STATUS_OK);
+	CHECK(n == 3);
+	for(i = 0; i < n; i++){
+		MPU6050_Fifo_Unpack(frames + 16*i, &accel, 0, 0);
+		CHECK(accel.Ax_RAW == 111);
+		CHECK(frames[16*i + 6] == 0x55 && memcmp(frames + 16*i + 7, mag_data + 1, 5) == 0);
+		CHECK(frames[16*i + 12] == 0x12 && frames[16*i + 15] == 0x78);
+	}
+	CHECK(MPU6050_Fifo_Stop() == I2C_STATUS_OK);
+	CHECK(Sim_MPU.regs[USER_CTRL] == USER_I2C_MST_EN);
+
+	//Stopped: no more aux traffic
+	CHECK(MPU6050_Aux_Stop() == I2C_STATUS_OK);
+	CHECK(MPU6050_Aux_Size() == 0);
+	transfers = Sim_MPU.aux_transfers;
+	Sim_Run_NS(3000000);
+	CHECK(Sim_MPU.aux_transfers == transfers);
+}
+
+/*
+ *	-------------------Test_FastMath------------------
+ *	Accuracy sweep of the approximations against libm, at their
+ *	stated bounds, and the fast tilt angles against the libm ones
+ *	Input: None
+ *	Output: None
+ */
+static void Test_FastMath(void){
+	MPU6050_ACCEL_t accel;
+	MPU6050_ANGLE_t angle;
+	MPU6050_ANGLE_t fast;
+	double atan_err = 0;
+	double inv_err = 0;
+	double hypot_err = 0;
+	double atan_q_err = 0;
+	double hypot_q_err = 0;
+	double angle_err = 0;
+	double t;
+	double x;
+	double y;
+	int32_t i;
+	int32_t j;
+
+	//Every direction, at small and large magnitudes
+	for(i = 0; i < 36000; i++){
+		t = -TEST_PI + i * (2*TEST_PI / 36000);
+		for(j = 0; j < 3; j++){
+			x = cos(t) * ((j == 0) ? 1e-3 : (j == 1) ? 1.0 : 3e4);
+			y = sin(t) * ((j == 0) ? 1e-3 : (j == 1) ? 1.0 : 3e4);
+			atan_err = fmax(atan_err, fabs(FastMath_Atan2((float)y, (float)x) - atan2((float)y, (float)x)));
+			hypot_err = fmax(hypot_err, fabs(FastMath_Hypot((float)x, (float)y) / hypot((float)x, (float)y) - 1));
+		}
+		x = cos(t) * FAST_MATH_Q_MAX;
+		y = sin(t) * FAST_MATH_Q_MAX;
+		atan_q_err = fmax(atan_q_err, fabs(FastMath_Atan2_Q((int32_t)y, (int32_t)x) - 1000 * atan2((int32_t)y, (int32_t)x) * 180 / TEST_PI));
+	}
+	CHECK(atan_err <= 1.2e-5);
+	CHECK(hypot_err <= 5e-6);
+	CHECK(atan_q_err <= 100);
+
+	for(x = 1e-6; x < 1e6; x *= 1.001)
+		inv_err = fmax(inv_err, fabs(FastMath_InvSqrt((float)x) * sqrt((float)x) - 1));
+	CHECK(inv_err <= 5e-6);
+
+	for(i = -FAST_MATH_Q_MAX; i <= FAST_MATH_Q_MAX; i += 7)
+		for(j = -FAST_MATH_Q_MAX; j <= FAST_MATH_Q_MAX; j += 1021)
+			hypot_q_err = fmax(hypot_q_err, fabs(FastMath_Hypot_Q(i, j) - hypot(i, j)));
+	CHECK(hypot_q_err <= 0.5);
+	CHECK(FastMath_Hypot_Q(-FAST_MATH_Q_MAX, -FAST_MATH_Q_MAX) == 46341);
+	CHECK(FastMath_Atan2_Q(0, 0) == 0 && FastMath_Atan2_Q(0, -5) == 180000 && FastMath_Atan2_Q(-7, 0) == -90000);
+
+	//Tilt angles over a grid of accelerometer readings, 1g and beyond
+	for(i = -20; i <= 20; i++){
+		for(j = -20; j <= 20; j++){
+			accel.Ax = i * 0.1f;
+			accel.Ay = j * 0.1f;
+			accel.Az = ((i + j) % 5) * 0.4f + 0.05f;
+			MPU6050_Get_Angle(&accel, 0, &angle);
+			MPU6050_Get_Angle_Fast(&accel, 0, &fast);
+			angle_err = fmax(angle_err, fabs(angle.ArX - fast.ArX));
+			angle_err = fmax(angle_err, fabs(angle.ArY - fast.ArY));
+			angle_err = fmax(angle_err, fabs(angle.ArZ - fast.ArZ));
+		}
+	}
+	CHECK(angle_err <= 0.001);
+
+	//Nothing to divide by: no NaN
+	accel.Ax = accel.Ay = accel.Az = 0;
+	MPU6050_Get_Angle_Fast(&accel, 0, &fast);
+	CHECK(fast.ArX == 0 && fast.ArY == 0 && fast.ArZ == 0);
+	accel.Az = 1.0f;
+	MPU6050_Get_Angle_Fast(&accel, 0, &fast);
+	CHECK(fast.ArX == 0 && fast.ArY == 0 && fast.ArZ == 0);
+}
+
+/*
+ *	-------------------Test_Tilt_Step------------------
+ *	Local function that feeds the filter a sample of a sensor at
+ *	some roll and pitch, turning at some rate, with an extra sideways
+ *	acceleration and accelerometer noise added
+ *	Input: Filter, Roll & Pitch in degrees, Gyro Rates, Extra Ay in g,
+ *				 Noise Amplitude in g & Sample Time in us
+ *	Output: Roll the accelerometer alone sees, degrees
+ */
+static float Test_Tilt_Step(TILT_FILTER_t* filter, float roll, float pitch, float gx, float gy, float extra_ay, float noise, uint32_t timestamp_us){
+	static uint32_t seed = 12345;
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	float n[3];
+	uint8_t i;
+
+	for(i = 0; i < 3; i++){
+		seed = seed*1664525 + 1013904223;
+		n[i] = noise * ((float)(seed >> 8) / (1 << 23) - 1.0f);
+	}
+
+	roll /= (float)(180 / TEST_PI);
+	pitch /= (float)(180 / TEST_PI);
+	accel.Ax = -sinf(pitch) + n[0];
+	accel.Ay = cosf(pitch)*sinf(roll) + extra_ay + n[1];
+	accel.Az = cosf(pitch)*cosf(roll) + n[2];
+	gyro.Gx = gx;
+	gyro.Gy = gy;
+	gyro.Gz = 0;
+	Tilt_Update(filter, &accel, &gyro, timestamp_us);
+
+	return atan2f(accel.Ay, accel.Az) * (float)(180 / TEST_PI);
+}
+
+/*
+ *	-------------------Test_Tilt------------------
+ *	Both filters: follow a turn at any sample rate, ride out a
+ *	sideways push and accelerometer noise, the Kalman one learns the
+ *	gyro bias
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Tilt(void){
+	TILT_FILTER_t filter;
+	float accel_roll;
+	float worst;
+	double sum;
+	double sum_sq;
+	double accel_sum;
+	double accel_sum_sq;
+	uint32_t t;
+	uint32_t i;
+	uint8_t mode;
+
+	for(mode = TILT_COMPLEMENTARY; mode <= TILT_KALMAN; mode++){
+
+		//90 degrees/s for 0.5s, at 1kHz and at 100Hz
+		Tilt_Init(&filter, mode);
+		for(t = 0; t <= 500000; t += 1000)
+			Test_Tilt_Step(&filter, 90.0f*t/1e6f, 0, 90.0f, 0, 0, 0, t);
+		CHECK(fabsf(filter.roll - 45.0f) < 0.5f && fabsf(filter.pitch) < 0.5f);
+		Tilt_Init(&filter, mode);
+		for(t = 0; t <= 500000; t += 10000)
+			Test_Tilt_Step(&filter, 0, -90.0f*t/1e6f, 0, -90.0f, 0, 0, t);
+		CHECK(fabsf(filter.pitch + 45.0f) < 0.5f && fabsf(filter.roll) < 0.5f);
+
+		//0.5g sideways for 50ms reads as 26.6 degrees to the accelerometer alone
+		Tilt_Init(&filter, mode);
+		worst = 0;
+		for(t = 0; t <= 1000000; t += 1000){
+			accel_roll = Test_Tilt_Step(&filter, 0, 0, 0, 0, (t >= 500000 && t < 550000) ? 0.5f : 0, 0, t);
+			worst = fmaxf(worst, fabsf(filter.roll));
+		}
+		CHECK(accel_roll == 0.0f);
+		CHECK(worst < 3.5f);
+
+		//+-0.05g of noise: the filter output moves far less than the accelerometer tilt
+		Tilt_Init(&filter, mode);
+		sum = sum_sq = accel_sum = accel_sum_sq = 0;
+		for(i = 0; i < 3000; i++){
+			accel_roll = Test_Tilt_Step(&filter, 10.0f, 0, 0, 0, 0, 0.05f, i*1000);
+			if(i >= 1000){
+				sum += filter.roll;
+				sum_sq += filter.roll * filter.roll;
+				accel_sum += accel_roll;
+				accel_sum_sq += accel_roll * accel_roll;
+			}
+		}
+		CHECK(fabs(sum / 2000 - 10.0) < 0.3);
+		CHECK((sum_sq - sum*sum/2000) * 25 < (accel_sum_sq - accel_sum*accel_sum/2000));
+
+		//Stamps wrap at 2^32 us, a long gap starts over from the accelerometer
+		Tilt_Init(&filter, mode);
+		for(t = 0xFFFF0000UL, i = 0; i <= 200; t += 1000, i++)
+			Test_Tilt_Step(&filter, 90.0f*i/1000.0f, 0, 90.0f, 0, 0, 0, t);
+		CHECK(fabsf(filter.roll - 18.0f) < 0.5f);
+		Test_Tilt_Step(&filter, -30.0f, 0, 0, 0, 0, 0, t + 1000000);
+		CHECK(fabsf(filter.roll + 30.0f) < 0.01f);
+	}
+
+	//Gyro reading 2 degrees/s at rest: the Kalman filter learns it and stays level
+	Tilt_Init(&filter, TILT_KALMAN);
+	for(t = 0; t <= 20000000; t += 1000)
+		Test_Tilt_Step(&filter, 0, 0, 2.0f, 0, 0, 0, t);
+	CHECK(fabsf(filter.axis[0].bias - 2.0f) < 0.1f);
+	CHECK(fabsf(filter.roll) < 0.1f);
+	Tilt_Reset(&filter);
+	CHECK(filter.axis[0].bias == 0.0f);
+}
+
+/*
+ *	-------------------Test_AHRS------------------
+ *	Orientation estimator (whichever variant is compiled in) on
+ *	synthetic traces: starts from the accelerometer, follows a
+ *	tumbling sensor, goes straight through 90 degrees of pitch and
+ *	pulls a wrong tilt back in
+ *	Input: None
+ *	Output: None
+ */
+static void Test_AHRS(void){
+	static const float still[3] = {0, 0, 0};
+	SIM_MOTION_t motion;
+	AHRS_t ahrs;
+	AHRS_EULER_t euler;
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	float rate[3];
+	float R[3][3];
+	double tilt;
+	double worst_tilt;
+	double error;
+	double norm;
+	uint32_t i;
+
+	//First sample sets roll and pitch straight from the accelerometer
+	AHRS_Init(&ahrs);
+	Sim_Motion_Init(&motion, 30.0f, -20.0f, 0, 0);
+	Sim_Motion_Step(&motion, still, 0.001f, &accel, &gyro);
+	AHRS_Update(&ahrs, &accel, &gyro, 0);
+	AHRS_Get_Euler(&ahrs, &euler);
+	CHECK(fabsf(euler.roll - 30.0f) < 0.01f && fabsf(euler.pitch + 20.0f) < 0.01f);
+	AHRS_Get_Matrix(&ahrs, R);
+	CHECK(fabsf(R[2][0] - accel.Ax) < 1e-4f && fabsf(R[2][1] - accel.Ay) < 1e-4f && fabsf(R[2][2] - accel.Az) < 1e-4f);
+
+	//Tumbling on all three axes at 1kHz with gyro noise
+	AHRS_Init(&ahrs);
+	Sim_Motion_Init(&motion, 10.0f, 5.0f, 0, 1.0f);
+	worst_tilt = 0;
+	for(i = 0; i <= 10000; i++){
+		rate[0] = 100.0f*sinf(i*0.00314f);
+		rate[1] = 70.0f*sinf(i*0.00188f + 1.0f);
+		rate[2] = 45.0f;
+		Sim_Motion_Step(&motion, rate, 0.001f, &accel, &gyro);
+		AHRS_Update(&ahrs, &accel, &gyro, i*1000);
+		error = Sim_Motion_Error(&motion, ahrs.q, &tilt);
+		worst_tilt = fmax(worst_tilt, tilt);
+	}
+	CHECK(worst_tilt < 1.0);
+	CHECK(error < 2.0);
+	norm = ahrs.q[0]*ahrs.q[0] + ahrs.q[1]*ahrs.q[1] + ahrs.q[2]*ahrs.q[2] + ahrs.q[3]*ahrs.q[3];
+	CHECK(fabs(norm - 1) < 1e-5);
+
+	//Pitch through 90 and on to upside down: no gimbal lock, no NaN
+	AHRS_Init(&ahrs);
+	Sim_Motion_Init(&motion, 0, 0, 0, 0);
+	rate[0] = rate[2] = 0;
+	rate[1] = 90.0f;
+	worst_tilt = 0;
+	for(i = 0; i <= 2000; i++){
+		Sim_Motion_Step(&motion, rate, 0.001f, &accel, &gyro);
+		AHRS_Update(&ahrs, &accel, &gyro, i*1000);
+		Sim_Motion_Error(&motion, ahrs.q, &tilt);
+		worst_tilt = fmax(worst_tilt, tilt);
+		if(i == 1000){
+			AHRS_Get_Euler(&ahrs, &euler);
+			CHECK(fabsf(euler.pitch - 90.0f) < 0.5f);
+		}
+	}
+	CHECK(worst_tilt < 0.5);
+	AHRS_Get_Euler(&ahrs, &euler);
+	CHECK(euler.roll == euler.roll && euler.pitch == euler.pitch && euler.yaw == euler.yaw);
+	CHECK(fabsf(euler.pitch) < 0.5f && fabsf(fabsf(euler.roll) - 180.0f) < 0.5f);
+
+	//Started level, then the sensor reads 60 degrees of roll at rest: the accelerometer pulls it in
+	AHRS_Init(&ahrs);
+	Sim_Motion_Init(&motion, 0, 0, 0, 0);
+	Sim_Motion_Step(&motion, still, 0.001f, &accel, &gyro);
+	AHRS_Update(&ahrs, &accel, &gyro, 0);
+	Sim_Motion_Init(&motion, 60.0f, 0, 0, 0);
+	for(i = 1; i <= 20000; i++){
+		Sim_Motion_Step(&motion, still, 0.001f, &accel, &gyro);
+		AHRS_Update(&ahrs, &accel, &gyro, i*1000);
+	}
+	Sim_Motion_Error(&motion, ahrs.q, &tilt);
+	CHECK(tilt < 1.0);
+}
+
+/*
+ *	-------------------Test_EEPROM------------------
+ *	Word access across blocks, contents survive a power cycle,
+ *	rewriting the same data programs nothing
+ *	Input: None
+ *	Output: None
+ */
+static void Test_EEPROM(void){
+	uint32_t data[40];
+	uint32_t back[40];
+	uint32_t i;
+
+	Sim_EEPROM_Erase();
+	Test_Setup();
+	CHECK(EEPROM_Read(0, back, 1) == EEPROM_INVALID);
+
+	//Recovery from a program cut short by power loss failed
+	EEPROM_EESUPP_R = EEPROM_EESUPP_RETRY;
+	CHECK(EEPROM_Init() == EEPROM_ERROR);
+	CHECK(EEPROM_Size() == 0);
+
+	Test_Setup();
+	CHECK(EEPROM_Init() == EEPROM_OK);
+	CHECK(EEPROM_Size() == SIM_EEPROM_WORDS);
+	CHECK(EEPROM_Read(0, back, 1) == EEPROM_OK && back[0] == 0xFFFFFFFF);
+
+	//Words 10..49 span three blocks
+	for(i = 0; i < 40; i++)
+		data[i] = 0x5A000000 + i*0x01010101;
+	CHECK(EEPROM_Write(10, data, 40) == EEPROM_OK);
+	CHECK(Sim_EEPROM_Writes(1) == 40);
+	memset(back, 0, sizeof(back));
+	CHECK(EEPROM_Read(10, back, 40) == EEPROM_OK);
+	CHECK(memcmp(back, data, sizeof(data)) == 0);
+	CHECK(memcmp(Sim_EEPROM_Data() + 10, data, sizeof(data)) == 0);
+	CHECK(Sim_EEPROM_Data()[9] == 0xFFFFFFFF && Sim_EEPROM_Data()[50] == 0xFFFFFFFF);
+
+	data[20] ^= 1;
+	CHECK(EEPROM_Write(10, data, 40) == EEPROM_OK);
+	CHECK(Sim_EEPROM_Writes(1) == 1);
+
+	CHECK(EEPROM_Write(SIM_EEPROM_WORDS - 12, data, 13) == EEPROM_INVALID);
+	CHECK(EEPROM_Read(0, back, SIM_EEPROM_WORDS + 1) == EEPROM_INVALID);
+	CHECK(EEPROM_Write(SIM_EEPROM_WORDS - 40, data, 40) == EEPROM_OK);
+
+	//Power cycle
+	Test_Setup();
+	CHECK(EEPROM_Init() == EEPROM_OK);
+	memset(back, 0, sizeof(back));
+	CHECK(EEPROM_Read(10, back, 40) == EEPROM_OK);
+	CHECK(memcmp(back, data, sizeof(data)) == 0);
+	CHECK(EEPROM_Read(SIM_EEPROM_WORDS - 40, back, 40) == EEPROM_OK);
+	CHECK(memcmp(back, data, sizeof(data)) == 0);
+}
+
+/*
+ *	-------------------Test_Calib_Boot------------------
+ *	Local function, power up with the MPU6050 reading a level board
+ *	with offsets, then Calib_Init
+ *	Input: Force Flag & Calibration
+ *	Output: Calib_Init status
+ */
+static uint8_t Test_Calib_Boot(uint8_t force, CALIB_t* calib){
+	Test_Setup();
+	Sim_MPU6050_Set_Motion(&Sim_MPU, 164, -328, 16384 + 492, 0, 131, -262, 65);
+	MPU6050_Init(&I2C0_Bus);
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	Sim_Delay_NS(1);
+	Sim_EEPROM_Writes(1);
+	return Calib_Init(calib, force);
+}
+
+/*
+ *	-------------------Test_Calib------------------
+ *	A cold boot calibrates and stores, a warm boot only reads the
+ *	EEPROM and corrects reads with it, a damaged or old record or
+ *	a request recalibrates. The six faces find the accelerometer
+ *	scale
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Calib(void){
+	static const int16_t g[3] = {16712, 15892, 16384};				//Up minus offset, 1.02g 0.97g 1g
+	static const int16_t offset[3] = {164, -328, 492};
+	CALIB_FACES_t faces;
+	CALIB_t calib;
+	CALIB_t loaded;
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	I2C_TRANSACTION_t motion;
+	uint8_t data[MPU6050_MOTION_DATA_SIZE];
+	int16_t raw[3];
+	uint8_t face;
+	uint8_t i;
+
+	//Cold boot: a blank EEPROM measures for CALIB_SAMPLES ms
+	Sim_EEPROM_Erase();
+	CHECK(Test_Calib_Boot(0, &calib) == CALIB_NEW);
+	CHECK(Sim_Delay_NS(0) >= (uint64_t)CALIB_SAMPLES * CALIB_SAMPLE_MS * 1000000);
+	CHECK(Sim_I2C_Counters(TEST_BUS_MODULE, 0).stops == CALIB_SAMPLES);
+	CHECK(Sim_EEPROM_Writes(0) > 0);
+	CHECK_NEAR(calib.gyro_bias[0], 1.0f);
+	CHECK_NEAR(calib.gyro_bias[1], -2.0f);
+	CHECK_NEAR(calib.gyro_bias[2], 65/131.0f);
+	CHECK_NEAR(calib.accel_offset[0], 0.01f);
+	CHECK_NEAR(calib.accel_offset[1], -0.02f);
+	CHECK_NEAR(calib.accel_offset[2], 0.03f);
+
+	CHECK(MPU6050_Get_Motion(&accel, &gyro, 0) == I2C_STATUS_OK);
+	MPU6050_Process_Accel(&accel);
+	MPU6050_Process_Gyro(&gyro);
+	Calib_Apply(&calib, &accel, &gyro);
+	CHECK_NEAR(accel.Ax, 0);
+	CHECK_NEAR(accel.Ay, 0);
+	CHECK_NEAR(accel.Az, 1.0f);
+	CHECK_NEAR(gyro.Gx, 0);
+	CHECK_NEAR(gyro.Gy, 0);
+	CHECK_NEAR(gyro.Gz, 0);
+
+	//Warm boot: no bus traffic, no delay, nothing programmed
+	memset(&loaded, 0, sizeof(loaded));
+	CHECK(Test_Calib_Boot(0, &loaded) == CALIB_OK);
+	CHECK(memcmp(&loaded, &calib, sizeof(calib)) == 0);
+	CHECK(Sim_I2C_Counters(TEST_BUS_MODULE, 0).commands == 0);
+	CHECK(Sim_Delay_NS(0) == 0);
+	CHECK(Sim_EEPROM_Writes(0) == 0);
+
+	//What it loaded corrects the motion reads the way Sensor_Update does
+	MPU6050_Motion_Transaction(&motion, data);
+	CHECK(I2C_Submit(&I2C0_Bus, &motion) == I2C_STATUS_OK);
+	CHECK(I2C_Wait(&I2C0_Bus, &motion) == I2C_STATUS_OK);
+	MPU6050_Unpack_Motion(data, &accel, &gyro, 0);
+	MPU6050_Process_Accel(&accel);
+	MPU6050_Process_Gyro(&gyro);
+	CHECK(accel.Ax > 0.005f && gyro.Gx > 0.5f);
+	Calib_Apply(&loaded, &accel, &gyro);
+	CHECK_NEAR(accel.Ax, 0);
+	CHECK_NEAR(accel.Ay, 0);
+	CHECK_NEAR(accel.Az, 1.0f);
+	CHECK_NEAR(gyro.Gx, 0);
+	CHECK_NEAR(gyro.Gy, 0);
+	CHECK_NEAR(gyro.Gz, 0);
+
+	//Asked for: measures again, the same result programs nothing
+	CHECK(Test_Calib_Boot(1, &loaded) == CALIB_NEW);
+	CHECK(Sim_EEPROM_Writes(0) == 0);
+
+	//One flipped bit, or a record from another version
+	Sim_EEPROM_Data()[CALIB_EEPROM_ADDR + 4] ^= 0x100;
+	CHECK(Calib_Load(&loaded) == CALIB_INVALID);
+	CHECK(Test_Calib_Boot(0, &loaded) == CALIB_NEW);
+	CHECK(Calib_Load(&loaded) == CALIB_OK);
+	Sim_EEPROM_Data()[CALIB_EEPROM_ADDR + 1] = CALIB_VERSION + 1;
+	CHECK(Test_Calib_Boot(0, &loaded) == CALIB_NEW);
+	CHECK(Sim_EEPROM_Data()[CALIB_EEPROM_ADDR + 1] == CALIB_VERSION);
+
+	//Six faces: scale and offset of every axis
+	memset(&faces, 0, sizeof(faces));
+	for(face = 0; face < CALIB_FACES; face++){
+		for(i = 0; i < 3; i++)
+			raw[i] = offset[i];
+		raw[face/2] += (face & 1) ? -g[face/2] : g[face/2];
+		Sim_MPU6050_Set_Motion(&Sim_MPU, raw[0], raw[1], raw[2], 0, 0, 0, 0);
+		if(face == CALIB_FACE_Z_DOWN)
+			CHECK(Calib_Faces_Solve(&faces, &calib) == CALIB_INVALID);
+		CHECK(Calib_Face(&faces, face) == CALIB_OK);
+	}
+	CHECK(Calib_Face(&faces, CALIB_FACES) == CALIB_INVALID);
+	CHECK(Calib_Faces_Solve(&faces, &calib) == CALIB_NEW);
+	for(i = 0; i < 3; i++){
+		CHECK_NEAR(calib.accel_offset[i], offset[i] / 16384.0f);
+		CHECK_NEAR(calib.accel_scale[i], 16384.0f / g[i]);
+	}
+
+	Sim_MPU6050_Set_Motion(&Sim_MPU, offset[0] + g[0], offset[1] - g[1]/2, offset[2], 0, 0, 0, 0);
+	Sim_Run_NS(1000000);
+	CHECK(MPU6050_Get_Motion(&accel, &gyro, 0) == I2C_STATUS_OK);
+	MPU6050_Process_Accel(&accel);
+	Calib_Apply(&calib, &accel, 0);
+	CHECK_NEAR(accel.Ax, 1.0f);
+	CHECK_NEAR(accel.Ay, -0.5f);
+	CHECK_NEAR(accel.Az, 0);
+}
+
+/*
+ *	-------------------Test_TCS34727------------------
+ *	Driver init and raw channel reads against the color model
+ *	Input: None
+ *	Output: None
+ */
+static void Test_TCS34727(void){
+	Test_Setup();
+	Sim_TCS34727_Set_Color(&Sim_TCS, 1000, 513, 300, 258);
+
+	TCS34727_Init(&I2C0_Bus);
+	CHECK(strstr(Sim_UART_Output(0), "TCS34727 Color Sensor Initialized") != 0);
+	CHECK(Sim_TCS.regs[TCS34727_ENABLE_R_ADDR] == (TCS34727_ENABLE_PON|TCS34727_ENABLE_AEN));
+	CHECK(TCS34727_Get_ATIME() == TCS34727_ATIME_2_4_MS);
+
+	CHECK(TCS34727_GET_RAW_CLEAR() == 1000);
+	CHECK(TCS34727_GET_RAW_RED() == 513);
+	CHECK(TCS34727_GET_RAW_GREEN() == 300);
+	CHECK(TCS34727_GET_RAW_BLUE() == 258);
+}
+
+/*
+ *	-------------------Test_LCD------------------
+ *	Blocking LCD writes end up on the HD44780 model
+ *	Input: None
+ *	Output: None
+ */
+static void Test_LCD(void){
+	char row[17];
+
+	Test_Setup();
+
+	LCD_Init(&I2C0_Bus);
+	LCD_Clear();
+	LCD_Set_Cursor(ROW1, 0);
+	LCD_Print_Str((uint8_t*)"HELLO");
+	LCD_Set_Cursor(ROW2, 3);
+	LCD_Print_Str((uint8_t*)"WORLD");
+
+	Sim_LCD_Row(&Sim_LCD, 0, row);
+	CHECK(strcmp(row, "HELLO           ") == 0);
+	Sim_LCD_Row(&Sim_LCD, 1, row);
+	CHECK(strcmp(row, "   WORLD        ") == 0);
+	CHECK(Sim_LCD.four_bit == 1);
+	CHECK(Sim_LCD.busy_violations == 0);
+}
+
+/*
+ *	-------------------Test_LCD_Wake------------------
+ *	The 8-bit wake-up commands are one EN pulse each, so the 4-bit
+ *	interface starts in step and every setting after them takes
+ *	Input: None
+ *	Output: None
+ */
+static void Test_LCD_Wake(void){
+	Test_Setup();
+
+	LCD_Init(&I2C0_Bus);
+	CHECK(Sim_LCD.instructions == 4 + 5);													//Wake-ups, then function set to display on
+	CHECK(Sim_LCD.four_bit == 1 && Sim_LCD.pending == 0);
+	CHECK(Sim_LCD.lines == 2);
+	CHECK(Sim_LCD.increment == 1);
+	CHECK(Sim_LCD.display == (DISP_ON|DISP_CURSOR_ON|DISP_BLINK_ON));
+	CHECK(Sim_LCD.busy_violations == 0);
+}
+
+/*
+ *	-------------------Test_LCD_Rows------------------
+ *	LCD_Set_Cursor sends Set DDRAM Address: row 1 starts at 0x00,
+ *	row 2 at 0x40, and the next character lands there
+ *	Input: None
+ *	Output: None
+ */
+static void Test_LCD_Rows(void){
+	Test_Setup();
+	LCD_Init(&I2C0_Bus);
+	LCD_Clear();
+
+	LCD_Set_Cursor(ROW2, 5);
+	CHECK(Sim_LCD.addr == 0x45);
+	LCD_Print_Char('X');
+	CHECK(Sim_LCD.ddram[0x45] == 'X');
+
+	LCD_Set_Cursor(ROW1, 2);
+	CHECK(Sim_LCD.addr == 0x02);
+	LCD_Print_Char('Y');
+	CHECK(Sim_LCD.ddram[0x02] == 'Y');
+
+	LCD_Set_Cursor(ROW2 + 1, 0);																//Unknown row falls back to row 1
+	CHECK(Sim_LCD.addr == 0x00);
+	CHECK(Sim_LCD.busy_violations == 0);
+}
+
+/*
+ *	-------------------Test_LCD_Clear_Home------------------
+ *	Clear and return home run for 1.52ms on the HD44780: the driver
+ *	waits them out before the next write
+ *	Input: None
+ *	Output: None
+ */
+static void Test_LCD_Clear_Home(void){
+	uint32_t start;
+
+	Test_Setup();
+	LCD_Init(&I2C0_Bus);
+	LCD_Print_Str((uint8_t*)"AB");
+
+	start = TIMESTAMP_US();
+	LCD_Clear();
+	CHECK(TIMESTAMP_US() - start >= SIM_LCD_CLEAR_NS/1000);
+	LCD_Print_Char('C');
+	CHECK(Sim_LCD.ddram[0] == 'C' && Sim_LCD.ddram[1] == ' ');
+
+	start = TIMESTAMP_US();
+	LCD_Reset_Cursor();
+	CHECK(TIMESTAMP_US() - start >= SIM_LCD_CLEAR_NS/1000);
+	LCD_Print_Char('D');
+	CHECK(Sim_LCD.ddram[0] == 'D');
+	CHECK(Sim_LCD.busy_violations == 0);
+}
+
+/*
+ *	-------------------Test_LCD_Scheduled------------------
+ *	LCD writes paced by the scheduler reach the model in order
+ *	Input: None
+ *	Output: None
+ */
+static void Test_LCD_Scheduled(void){
+	I2C_SCHED_t sched;
+	I2C_SCHED_CLIENT_t client;
+	char row[17];
+
+	Test_Setup();
+	LCD_Init(&I2C0_Bus);
+
+	I2C_Sched_Init(&sched, &I2C0_Bus);
+	I2C_Sched_Register(&sched, &client, I2C_SCHED_PRIO_DISPLAY, 50000);
+	LCD_Attach_Scheduler(&sched, &client);
+
+	LCD_Clear();
+	LCD_Set_Cursor(ROW1, 0);
+	LCD_Print_Str((uint8_t*)"SCHEDULED");
+	while(client.head || sched.active)
+		I2C_Sched_Poll(&sched);
+
+	Sim_LCD_Row(&Sim_LCD, 0, row);
+	CHECK(strcmp(row, "SCHEDULED       ") == 0);
+	CHECK(client.completed == 11);
+	CHECK(client.missed == 0);
+	CHECK(Sim_LCD.busy_violations == 0);
+}
+
+/*
+ *	-------------------Test_Sched_Done------------------
+ *	Local function that records the order scheduled jobs finish in
+ *	Input: Finished Transaction (first member of its job)
+ *	Output: None
+ */
+static void Test_Sched_Done(I2C_TRANSACTION_t* transaction){
+	if(Test_Sched_Count < 8)
+		Test_Sched_Order[Test_Sched_Count] = (I2C_SCHED_JOB_t*)transaction;
+	Test_Sched_Count++;
+}
+
+/*
+ *	-------------------Test_Sched_Job------------------
+ *	Local function that sets up a job as a 14-byte motion read
+ *	Input: Job & Data Buffer
+ *	Output: None
+ */
+static void Test_Sched_Job(I2C_SCHED_JOB_t* job, uint8_t* data){
+	MPU6050_Motion_Transaction(&job->transaction, data);
+	job->callback = Test_Sched_Done;
+}
+
+/*
+ *	-------------------Test_Sched_Checked------------------
+ *	Local function that records a finished job like Test_Sched_Done,
+ *	notes whether interrupts were masked and how deep callbacks
+ *	nest, and resubmits the job while Test_Sched_Again_Left says so
+ *	Input: Finished Transaction (first member of its job)
+ *	Output: None
+ */
+static void Test_Sched_Checked(I2C_TRANSACTION_t* transaction){
+	I2C_SCHED_JOB_t* job = (I2C_SCHED_JOB_t*)transaction;
+
+	if(++Test_Sched_Depth > Test_Sched_Max_Depth)
+		Test_Sched_Max_Depth = Test_Sched_Depth;
+	if(HOST_PRIMASK)
+		Test_Sched_Masked++;
+	Test_Sched_Done(transaction);
+
+	if(Test_Sched_Again_Left){
+		Test_Sched_Again_Left--;
+		I2C_Sched_Submit(Test_Sched_Again, job->client, job, 0);
+	}
+	Test_Sched_Depth--;
+}
+
+/*
+ *	-------------------Test_Sched_Clients------------------
+ *	Several clients on one bus: the most urgent priority goes
+ *	first, the earliest deadline among equal priorities, deadlines
+ *	that can't be met are counted, and the IMU never waits behind
+ *	more than one display transaction
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Sched_Clients(void){
+	I2C_SCHED_t sched;
+	I2C_SCHED_CLIENT_t imu, color_a, color_b, display;
+	I2C_SCHED_JOB_t jobs[8];
+	I2C_SCHED_JOB_t imu_job;
+	uint8_t data[MPU6050_MOTION_DATA_SIZE];
+	uint32_t job_us;
+	uint32_t start;
+	uint8_t i;
+
+	Test_Setup();
+	I2C_Sched_Init(&sched, &I2C0_Bus);
+	CHECK(I2C_Sched_Register(&sched, &imu, I2C_SCHED_PRIO_IMU, 5000) == I2C_STATUS_OK);
+	CHECK(I2C_Sched_Register(&sched, &color_a, I2C_SCHED_PRIO_COLOR, 20000) == I2C_STATUS_OK);
+	CHECK(I2C_Sched_Register(&sched, &color_b, I2C_SCHED_PRIO_COLOR, 10000) == I2C_STATUS_OK);
+	CHECK(I2C_Sched_Register(&sched, &display, I2C_SCHED_PRIO_DISPLAY, 50000) == I2C_STATUS_OK);
+	CHECK(I2C_Sched_Register(&sched, &imu, I2C_SCHED_PRIO_IMU, 5000) == I2C_STATUS_INVALID);
+
+	//Queue everything behind a display job that is already on the bus, least urgent first
+	for(i = 0; i < 5; i++)
+		Test_Sched_Job(&jobs[i], data);
+	Test_Sched_Count = 0;
+	I2C_Sched_Submit(&sched, &display, &jobs[0], 0);
+	CHECK(sched.active == &jobs[0]);
+	I2C_Sched_Submit(&sched, &display, &jobs[1], 0);
+	I2C_Sched_Submit(&sched, &color_a, &jobs[2], 0);
+	I2C_Sched_Submit(&sched, &color_b, &jobs[3], 0);				//Same priority, due sooner
+	I2C_Sched_Submit(&sched, &imu, &jobs[4], 0);
+	CHECK(I2C_Sched_Wait(&sched, &jobs[1]) == I2C_STATUS_OK);
+
+	CHECK(Test_Sched_Count == 5);
+	CHECK(Test_Sched_Order[0] == &jobs[0]);
+	CHECK(Test_Sched_Order[1] == &jobs[4]);
+	CHECK(Test_Sched_Order[2] == &jobs[3]);
+	CHECK(Test_Sched_Order[3] == &jobs[2]);
+	CHECK(Test_Sched_Order[4] == &jobs[1]);
+	CHECK(imu.completed == 1 && color_a.completed == 1 && color_b.completed == 1 && display.completed == 2);
+	CHECK(imu.missed == 0 && color_a.missed == 0 && color_b.missed == 0 && display.missed == 0);
+
+	//A job held back by its release time lets later ones through
+	Test_Sched_Count = 0;
+	I2C_Sched_Submit(&sched, &imu, &jobs[0], 2000);
+	I2C_Sched_Submit(&sched, &display, &jobs[1], 0);
+	CHECK(I2C_Sched_Wait(&sched, &jobs[0]) == I2C_STATUS_OK);
+	CHECK(Test_Sched_Count == 2 && Test_Sched_Order[0] == &jobs[1] && Test_Sched_Order[1] == &jobs[0]);
+
+	//How long one motion read keeps the bus
+	start = TIMESTAMP_US();
+	I2C_Sched_Submit(&sched, &display, &jobs[0], 0);
+	I2C_Sched_Wait(&sched, &jobs[0]);
+	job_us = TIMESTAMP_US() - start;
+
+	//A backlog of display jobs: the IMU waits for the one on the bus only, the display misses its deadlines
+	I2C_Sched_Init(&sched, &I2C0_Bus);
+	I2C_Sched_Register(&sched, &imu, I2C_SCHED_PRIO_IMU, 3*job_us);
+	I2C_Sched_Register(&sched, &display, I2C_SCHED_PRIO_DISPLAY, 2*job_us);
+	for(i = 0; i < 8; i++){
+		Test_Sched_Job(&jobs[i], data);
+		I2C_Sched_Submit(&sched, &display, &jobs[i], 0);
+	}
+	Sim_Run_NS(job_us*1000/2);
+	Test_Sched_Job(&imu_job, data);
+	I2C_Sched_Submit(&sched, &imu, &imu_job, 0);
+	I2C_Sched_Wait(&sched, &imu_job);
+	CHECK(display.completed == 1);
+	CHECK(imu.worst_latency_us <= 2*job_us);
+	CHECK(imu.missed == 0);
+	while(sched.active || display.head)
+		I2C_Sched_Poll(&sched);
+	CHECK(display.completed == 8);
+	CHECK(display.missed == 7);																//Behind the IMU read, jobs 2..8 finish past 2 job times
+}
+
+/*
+ *	-------------------Test_Sched_Reject------------------
+ *	A job the bus refuses for good completes with the refusal
+ *	instead of being retried forever, and the jobs behind it run.
+ *	Callbacks run with interrupts on, and one that resubmits a job
+ *	the bus keeps refusing doesn't nest
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Sched_Reject(void){
+	I2C_SCHED_t sched;
+	I2C_SCHED_CLIENT_t imu, color;
+	I2C_SCHED_JOB_t jobs[3];
+	I2C_SEGMENT_t empty = {0, 0, 0};
+	uint8_t data[MPU6050_MOTION_DATA_SIZE];
+	uint8_t i;
+
+	Test_Setup();
+	I2C_Sched_Init(&sched, &I2C0_Bus);
+	I2C_Sched_Register(&sched, &imu, I2C_SCHED_PRIO_IMU, 5000);
+	I2C_Sched_Register(&sched, &color, I2C_SCHED_PRIO_COLOR, 20000);
+	for(i = 0; i < 3; i++){
+		Test_Sched_Job(&jobs[i], data);
+		jobs[i].callback = Test_Sched_Checked;
+	}
+
+	//Nothing to put on the wire: I2C_Submit says I2C_STATUS_INVALID
+	jobs[1].transaction.segments = &empty;
+	jobs[1].transaction.seg_count = 1;
+
+	Test_Sched_Count = Test_Sched_Masked = Test_Sched_Max_Depth = 0;
+	Test_Sched_Again_Left = 0;
+	I2C_Sched_Submit(&sched, &imu, &jobs[0], 0);
+	I2C_Sched_Submit(&sched, &imu, &jobs[1], 0);
+	I2C_Sched_Submit(&sched, &color, &jobs[2], 0);
+	CHECK(I2C_Sched_Wait(&sched, &jobs[2]) == I2C_STATUS_OK);
+
+	CHECK(Test_Sched_Count == 3);
+	CHECK(Test_Sched_Order[2] == &jobs[2]);														//Got the bus right after jobs[0]
+	CHECK(jobs[0].transaction.status == I2C_STATUS_OK);
+	CHECK(jobs[1].transaction.done == 1 && jobs[1].transaction.status == I2C_STATUS_INVALID);
+	CHECK(imu.completed == 2 && color.completed == 1);
+	CHECK(imu.head == 0 && sched.active == 0);
+	CHECK(Test_Sched_Masked == 0);
+
+	//A refused job whose callback submits it again, straight from Submit
+	Test_Sched_Count = 0;
+	Test_Sched_Again = &sched;
+	Test_Sched_Again_Left = 100;
+	I2C_Sched_Submit(&sched, &imu, &jobs[1], 0);
+	CHECK(Test_Sched_Count == 101 && Test_Sched_Again_Left == 0);
+
+	//Same, refused by the dispatch that follows a completion in the bus ISR
+	Test_Sched_Count = 0;
+	jobs[2].callback = Test_Sched_Done;
+	I2C_Sched_Submit(&sched, &color, &jobs[2], 0);
+	Test_Sched_Again_Left = 100;
+	I2C_Sched_Submit(&sched, &imu, &jobs[1], 0);												//Waits for the bus
+	CHECK(Test_Sched_Count == 0);
+	CHECK(I2C_Sched_Wait(&sched, &jobs[2]) == I2C_STATUS_OK);
+	CHECK(Test_Sched_Count == 102 && Test_Sched_Again_Left == 0);
+	CHECK(jobs[1].transaction.status == I2C_STATUS_INVALID);
+	CHECK(imu.head == 0 && sched.refused == 0 && sched.active == 0);
+
+	CHECK(Test_Sched_Max_Depth == 1);
+	CHECK(Test_Sched_Masked == 0);
+}
+
+/*
+ *	-------------------Test_Faults------------------
+ *	A missing slave NACKs, a slave holding SCL gets the bus
+ *	recovered, and the bus works again afterwards
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Faults(void){
+	uint8_t data[2];
+	uint8_t ret;
+
+	Test_Setup();
+
+	Sim_MPU.dev.fault = SIM_FAULT_ABSENT;
+	ret = I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, data, 1);
+	CHECK(ret == I2C_STATUS_ADRACK);
+	CHECK(I2C_Is_Idle(&I2C0_Bus));
+
+	Sim_MPU.dev.fault = SIM_FAULT_STRETCH;
+	ret = I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, data, 1);
+	CHECK(ret == I2C_STATUS_CLKTO || ret == I2C_STATUS_TIMEOUT);
+	CHECK(Sim_MPU.dev.fault == SIM_FAULT_NONE);
+
+	ret = I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, data, 1);
+	CHECK(ret == I2C_STATUS_OK);
+	CHECK(data[0] == MPU6050_ADDR_AD0_LOW);
+}
+
+/*
+ *	-------------------Test_Abort_Done------------------
+ *	Local function that records how an aborted transaction was
+ *	reported to its owner
+ *	Input: Finished Transaction
+ *	Output: None
+ */
+static void Test_Abort_Done(I2C_TRANSACTION_t* transaction){
+	Test_Abort_Status = transaction->status;
+	if(HOST_PRIMASK)
+		Test_Abort_Masked++;
+}
+
+/*
+ *	-------------------Test_Bus_Recovery------------------
+ *	A bus that was never set up takes nothing. A slave holding SCL
+ *	is only flagged by the ISR: the recovery runs from the waiting
+ *	loop with interrupts on, and so does the owner's callback, then
+ *	the queue moves on
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Bus_Recovery(void){
+	I2C_TRANSACTION_t early;
+	I2C_TRANSACTION_t stuck;
+	I2C_TRANSACTION_t next;
+	uint8_t data[2];
+
+	Test_Setup();
+
+	memset(&early, 0, sizeof(early));
+	early.slave_addr = MPU6050_ADDR_AD0_LOW;
+	early.slave_reg_addr = WHO_AM_I;
+	early.rx_data = data;
+	early.rx_size = 1;
+	CHECK(I2C_Submit(&I2C3_Bus, &early) == I2C_STATUS_INVALID);
+	CHECK(early.done == 1 && early.status == I2C_STATUS_INVALID);
+
+	//Nobody polls the bus: the clock low timeout only marks it
+	Sim_MPU.dev.fault = SIM_FAULT_STRETCH;
+	stuck = next = early;
+	next.rx_data = data + 1;
+	stuck.callback = Test_Abort_Done;
+	Test_Abort_Status = I2C_STATUS_PENDING;
+	Test_Abort_Masked = 0;
+	Sim_Masked_NS(1);
+	CHECK(I2C_Submit(&I2C0_Bus, &stuck) == I2C_STATUS_OK);
+	CHECK(I2C_Submit(&I2C0_Bus, &next) == I2C_STATUS_OK);
+	Sim_Run_NS(12000000);
+	CHECK(stuck.done == 0 && next.done == 0);
+	CHECK(I2C0_Bus.fault == I2C_STATUS_CLKTO);
+
+	CHECK(I2C_Wait(&I2C0_Bus, &stuck) == I2C_STATUS_CLKTO);
+	CHECK(Test_Abort_Status == I2C_STATUS_CLKTO && Test_Abort_Masked == 0);
+	CHECK(Sim_MPU.dev.fault == SIM_FAULT_NONE);
+	CHECK(I2C_Wait(&I2C0_Bus, &next) == I2C_STATUS_OK);
+	CHECK(data[1] == MPU6050_WHO_AM_I_ID);
+	CHECK(Sim_Masked_NS(0) < 20000);														//The ~100us of bit banging ran unmasked
+}
+
+/*
+ *	-------------------Test_Init_Table------------------
+ *	Init sequences: consecutive registers share a burst, read-back
+ *	catches a register that didn't take the value
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Init_Table(void){
+	static const uint8_t regs[] = {SMPLRT_DIV, CONFIG};
+	static const REG_INIT_t burst[] = {
+		{SMPLRT_DIV,	3,		0,	0},
+		{CONFIG,			2,		0,	0},
+		{GYRO_CONFIG,	0x08,	0,	0},
+		{PWR_MGMT_1,	0,		1,	0},
+	};
+	static const REG_INIT_t verified[] = {
+		{SMPLRT_DIV,	5,		0,	0xFF},
+		{WHO_AM_I,		0x12,	0,	0xFF},
+	};
+	uint8_t values[sizeof(regs)];
+	REG_CACHE_t cache;
+	SIM_I2C_COUNTERS_t counters;
+	uint8_t value;
+	uint8_t reg = 0;
+	uint8_t ret;
+
+	Test_Setup();
+	RegCache_Init(&cache, &I2C0_Bus, MPU6050_ADDR_AD0_LOW, 0, 0, regs, values, sizeof(regs));
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+
+	//Three registers in a row, then one elsewhere: two writes
+	ret = RegCache_Run_Init(&cache, burst, 4, &reg);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(ret == I2C_STATUS_OK);
+	CHECK(counters.stops == 2);
+	CHECK(Sim_MPU.regs[SMPLRT_DIV] == 3 && Sim_MPU.regs[CONFIG] == 2 && Sim_MPU.regs[GYRO_CONFIG] == 0x08);
+	CHECK(Sim_MPU.regs[PWR_MGMT_1] == 0);
+
+	//Shadow copies follow the table
+	CHECK(RegCache_Read(&cache, CONFIG, &value) == I2C_STATUS_OK && value == 2);
+	CHECK(Sim_I2C_Counters(TEST_BUS_MODULE, 0).commands == 0);
+
+	//WHO_AM_I is read only: the read-back points at it
+	ret = RegCache_Run_Init(&cache, verified, 2, &reg);
+	CHECK(ret == REG_INIT_VERIFY_FAIL);
+	CHECK(reg == WHO_AM_I);
+	CHECK(Sim_MPU.regs[SMPLRT_DIV] == 5);
+}
+
+/*
+ *	-------------------Test_Transfer------------------
+ *	Segment lists: a header and its payload from separate buffers
+ *	share one write, a direction change gets a repeated START, a
+ *	read can land in two buffers, and an empty list is refused
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Transfer(void){
+	uint8_t reg = SMPLRT_DIV;
+	uint8_t values[2] = {7, 3};
+	uint8_t first[1], rest[2];
+	I2C_SEGMENT_t write[] = {
+		{I2C_SEG_WRITE, &reg, 1},
+		{I2C_SEG_WRITE, 0, 0},
+		{I2C_SEG_WRITE, values, 2},
+	};
+	I2C_SEGMENT_t read[] = {
+		{I2C_SEG_WRITE, &reg, 1},
+		{I2C_SEG_READ, first, 1},
+		{I2C_SEG_READ, rest, 2},
+	};
+	SIM_I2C_COUNTERS_t counters;
+	uint8_t ret;
+
+	Test_Setup();
+	Sim_MPU.regs[GYRO_CONFIG] = 0x18;
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+
+	//One START, three data bytes, the empty segment is skipped
+	ret = I2C_Transfer(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, write, 3);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(ret == I2C_STATUS_OK);
+	CHECK(counters.starts == 1 && counters.stops == 1 && counters.data_bytes == 3);
+	CHECK(Sim_MPU.regs[SMPLRT_DIV] == 7 && Sim_MPU.regs[CONFIG] == 3);
+
+	//Register write, repeated START, one read split over two buffers
+	ret = I2C_Transfer(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, read, 3);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(ret == I2C_STATUS_OK);
+	CHECK(counters.starts == 2 && counters.stops == 1 && counters.data_bytes == 4);
+	CHECK(first[0] == 7 && rest[0] == 3 && rest[1] == 0x18);
+
+	//Nothing to put on the wire
+	ret = I2C_Transfer(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, write + 1, 1);
+	CHECK(ret == I2C_STATUS_INVALID);
+	CHECK(Sim_I2C_Counters(TEST_BUS_MODULE, 0).commands == 0);
+	CHECK(I2C_Is_Idle(&I2C0_Bus));
+}
+
+/*
+ *	-------------------Test_Reg_Batch------------------
+ *	Registers asked for out of order come back in one transfer:
+ *	close ones share a burst, a far one gets a repeated START. A
+ *	device without auto-increment reads them one by one
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Reg_Batch(void){
+	static const uint8_t regs[] = {INT_PIN_CFG, SMPLRT_DIV, ACCEL_CONFIG, CONFIG, MOT_THR};
+	uint8_t values[sizeof(regs)];
+	REG_BATCH_t batch;
+	SIM_I2C_COUNTERS_t counters;
+	uint8_t ret;
+	uint8_t i;
+
+	Test_Setup();
+	for(i = 0; i < sizeof(regs); i++)
+		Sim_MPU.regs[regs[i]] = 0x10 + i;
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+
+	//SMPLRT_DIV..MOT_THR reads through the gaps, INT_PIN_CFG is a second burst
+	RegBatch_Init(&batch, &I2C0_Bus, MPU6050_ADDR_AD0_LOW, 0, 0, REG_BATCH_DEFAULT_GAP);
+	for(i = 0; i < sizeof(regs); i++)
+		RegBatch_Add(&batch, regs[i], &values[i]);
+	ret = RegBatch_Run(&batch);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(ret == I2C_STATUS_OK);
+	CHECK(counters.stops == 1 && counters.starts == 4);
+	CHECK(counters.data_bytes == 2 + (MOT_THR - SMPLRT_DIV + 1) + 1);
+	for(i = 0; i < sizeof(regs); i++)
+		CHECK(values[i] == 0x10 + i);
+
+	//One burst per register, more than fit one transfer
+	memset(values, 0, sizeof(values));
+	batch.max_gap = REG_BATCH_NO_AUTO_INC;
+	ret = RegBatch_Run(&batch);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+	CHECK(ret == I2C_STATUS_OK);
+	CHECK(counters.stops == 2 && counters.starts == 2*sizeof(regs));
+	for(i = 0; i < sizeof(regs); i++)
+		CHECK(values[i] == 0x10 + i);
+}
+
+/*
+ *	-------------------Test_Ring------------------
+ *	Sample ring: batches wrap around the end in order, a full ring
+ *	drops the new records and the high-water mark remembers the peak
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Ring(void){
+	SAMPLE_t storage[8];
+	SAMPLE_t in[6], out[8];
+	RING_t ring;
+	uint32_t i;
+
+	CHECK(Ring_Init(&ring, storage, sizeof(SAMPLE_t), 6) == RING_INVALID);
+	CHECK(Ring_Init(&ring, storage, sizeof(SAMPLE_t), 8) == RING_OK);
+
+	for(i = 0; i < 6; i++){
+		memset(&in[i], 0, sizeof(SAMPLE_t));
+		in[i].timestamp_us = 1000*i;
+		in[i].flags = SAMPLE_MOTION;
+		in[i].accel[0] = -(int16_t)i;
+	}
+
+	//Head lands at 6, so the second batch of 6 wraps
+	CHECK(Ring_Push(&ring, in, 6) == 6);
+	CHECK(Ring_Pop(&ring, out, 4) == 4);
+	CHECK(out[3].timestamp_us == 3000 && out[3].accel[0] == -3);
+	CHECK(Ring_Push(&ring, in, 6) == 6);
+	CHECK(Ring_Count(&ring) == 8);
+	CHECK(Ring_Pop(&ring, out, 8) == 8);
+	CHECK(out[0].timestamp_us == 4000 && out[1].timestamp_us == 5000);
+	CHECK(out[2].timestamp_us == 0 && out[7].timestamp_us == 5000);
+	CHECK(Ring_Pop(&ring, out, 1) == 0);
+
+	//Full: the oldest records stay, the overflow is counted
+	CHECK(Ring_Push(&ring, in, 6) == 6);
+	CHECK(Ring_Push(&ring, in, 6) == 2);
+	CHECK(ring.dropped == 4);
+	CHECK(ring.high_water == 8);
+	CHECK(Ring_Pop(&ring, out, 1) == 1 && out[0].timestamp_us == 0);
+}
+
+/*
+ *	-------------------Test_Snapshot------------------
+ *	Latest-value snapshot: whole and partial writes, generations
+ *	let a reader skip a copy when nothing changed
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Snapshot(void){
+	SENSOR_STATE_t storage, state, copy;
+	RGB_COLOR_HANDLE_t color;
+	SNAPSHOT_t snap;
+	uint32_t seen = 0;
+
+	memset(&storage, 0, sizeof(storage));
+	memset(&state, 0, sizeof(state));
+	Snapshot_Init(&snap, &storage, sizeof(storage));
+	CHECK(Snapshot_Generation(&snap) == 0);
+	CHECK(Snapshot_Read_Changed(&snap, &copy, &seen) == 0);
+
+	state.timestamp_us = 1000;
+	state.angle.ArX = 12.5f;
+	Snapshot_Write(&snap, 0, &state, sizeof(state));
+	CHECK(Snapshot_Read_Changed(&snap, &copy, &seen) == 1);
+	CHECK(seen == 1 && copy.timestamp_us == 1000 && copy.angle.ArX == 12.5f);
+	CHECK(Snapshot_Read_Changed(&snap, &copy, &seen) == 0);
+
+	//Color producer only touches its own member
+	memset(&color, 0, sizeof(color));
+	color.R_RAW = 513;
+	Snapshot_Write(&snap, offsetof(SENSOR_STATE_t, color), &color, sizeof(color));
+	CHECK(Snapshot_Read(&snap, &copy) == 2);
+	CHECK(copy.color.R_RAW == 513 && copy.angle.ArX == 12.5f);
+
+	//Out of range writes are refused
+	Snapshot_Write(&snap, sizeof(state), &color, 1);
+	CHECK(Snapshot_Generation(&snap) == 2);
+}
+
+/*
+ *	-------------------Test_Wire_Time------------------
+ *	A register read costs its bits at the bus rate
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Wire_Time(void){
+	SIM_I2C_COUNTERS_t counters;
+	uint8_t data;
+
+	Test_Setup();
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+
+	I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, &data, 1);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 0);
+
+	//START+addr+reg, repeated START+addr+data+STOP
+	CHECK(counters.commands == 2);
+	CHECK(counters.bits == (1+9+9) + (1+9+9+1));
+	CHECK(counters.busy_ns == (uint64_t)counters.bits * 2500);
+}
+
+#ifdef I2C_STATS
+/*
+ *	-------------------Test_Stats------------------
+ *	Bus statistics over a known mix of transactions: clean reads,
+ *	a NACK, a blocking submit turned away by a full queue and a
+ *	stuck slave, then the UART dump of the same numbers
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Stats(void){
+	I2C_TRANSACTION_t filler[I2C_QUEUE_SIZE + 1];
+	I2C_STATS_t stats;
+	SIM_I2C_COUNTERS_t counters;
+	char line[160];
+	const char* dump;
+	unsigned util, tenths;
+	uint8_t data[I2C_QUEUE_SIZE + 2];
+	uint8_t i;
+
+	Test_Setup();
+	I2C_Stats_Reset(&I2C0_Bus);
+	Sim_I2C_Counters(TEST_BUS_MODULE, 1);
+
+	//Two register reads: address+register, address+data each
+	CHECK(I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, data, 1) == I2C_STATUS_OK);
+	CHECK(I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, data, 1) == I2C_STATUS_OK);
+	I2C_Stats_Get(&I2C0_Bus, &stats);
+	counters = Sim_I2C_Counters(TEST_BUS_MODULE, 0);
+	CHECK(stats.transactions == 2 && stats.bytes == 8);
+	CHECK(stats.nacks == 0 && stats.errors == 0 && stats.retries == 0 && stats.recoveries == 0);
+	CHECK(stats.busy_us + 2 >= counters.busy_ns / 1000 && stats.busy_us <= counters.busy_ns / 1000 + 2);
+	CHECK(stats.slave_count == 1 && stats.slaves[0].addr == MPU6050_ADDR_AD0_LOW && stats.slaves[0].count == 2);
+	CHECK(stats.slaves[0].min_us <= stats.slaves[0].max_us && stats.slaves[0].total_us >= stats.busy_us);
+
+	//Nobody answers at 0x50
+	CHECK(I2C_Burst_Receive(&I2C0_Bus, 0x50, 0x00, data, 1) == I2C_STATUS_ADRACK);
+	I2C_Stats_Get(&I2C0_Bus, &stats);
+	CHECK(stats.transactions == 3 && stats.bytes == 10);
+	CHECK(stats.nacks == 1 && stats.errors == 0);
+
+	//Bus and queue taken: the blocking read is turned away once, then waits its turn
+	for(i = 0; i <= I2C_QUEUE_SIZE; i++){
+		memset(&filler[i], 0, sizeof(filler[i]));
+		filler[i].slave_addr = MPU6050_ADDR_AD0_LOW;
+		filler[i].slave_reg_addr = WHO_AM_I;
+		filler[i].rx_data = &data[i];
+		filler[i].rx_size = 1;
+		CHECK(I2C_Submit(&I2C0_Bus, &filler[i]) == I2C_STATUS_OK);
+	}
+	CHECK(I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, &data[I2C_QUEUE_SIZE + 1], 1) == I2C_STATUS_OK);
+	I2C_Stats_Get(&I2C0_Bus, &stats);
+	CHECK(stats.transactions == 13 && stats.bytes == 50);
+	CHECK(stats.retries == 1 && stats.errors == 0);
+	CHECK(stats.slaves[0].max_us > stats.slaves[0].min_us * I2C_QUEUE_SIZE);		//The last one waited behind the queue
+
+	//A slave holding SCL: runs over its budget, the bus is recovered
+	Sim_MPU.dev.fault = SIM_FAULT_STRETCH;
+	CHECK(I2C_Burst_Receive(&I2C0_Bus, MPU6050_ADDR_AD0_LOW, WHO_AM_I, data, 1) == I2C_STATUS_TIMEOUT);
+	I2C_Stats_Get(&I2C0_Bus, &stats);
+	CHECK(stats.transactions == 14 && stats.nacks == 1 && stats.errors == 1);
+	CHECK(stats.retries == 1 && stats.recoveries == 1);
+	CHECK(stats.slave_count == 2 && stats.slaves[0].count == 13);
+	CHECK(stats.slaves[1].addr == 0x50 && stats.slaves[1].count == 1);
+
+	//The dump prints the same numbers, utilization stays within the window
+	Sim_UART_Clear();
+	I2C_Stats_Dump(&I2C0_Bus);
+	dump = Sim_UART_Output(0);
+	sprintf(line, "I2C tx=14 B=%lu nack=1 err=1 retry=1 rec=1 busy=%lu util=",
+		(unsigned long)stats.bytes, (unsigned long)stats.busy_us);
+	CHECK(strncmp(dump, line, strlen(line)) == 0);
+	CHECK(sscanf(dump + strlen(line), "%u.%u", &util, &tenths) == 2 && util*10 + tenths <= 1000 && util*10 + tenths > 0);
+	sprintf(line, "%%\r\n %02X n=13 min/avg/max=%lu/%lu/%lu\r\n 50 n=1 min/avg/max=%lu/%lu/%lu\r\n", MPU6050_ADDR_AD0_LOW,
+		(unsigned long)stats.slaves[0].min_us, (unsigned long)(stats.slaves[0].total_us / 13), (unsigned long)stats.slaves[0].max_us,
+		(unsigned long)stats.slaves[1].min_us, (unsigned long)stats.slaves[1].min_us, (unsigned long)stats.slaves[1].min_us);
+	CHECK(strstr(dump, line) != 0);
+}
+
+/*
+ *	-------------------Test_Stats_Wide------------------
+ *	Every counter at its widest still prints as whole lines
+ *	Input: None
+ *	Output: None
+ */
+static void Test_Stats_Wide(void){
+	static const char head[] = "I2C tx=4294967295 B=4294967295 nack=4294967295 err=4294967295"
+		" retry=4294967295 rec=4294967295 busy=4294967295 util=";
+	static const char slave[] = " 68 n=4294967295 min/avg/max=4294967295/1/4294967295\r\n";
+	I2C_STATS_t* stats = &I2C0_Bus.stats;
+	const char* dump;
+	const char* end;
+
+	Test_Setup();
+	stats->transactions = stats->bytes = stats->nacks = stats->errors = 0xFFFFFFFF;
+	stats->retries = stats->recoveries = stats->busy_us = 0xFFFFFFFF;
+	stats->slave_count = 1;
+	stats->slaves[0].addr = MPU6050_ADDR_AD0_LOW;
+	stats->slaves[0].count = stats->slaves[0].min_us = stats->slaves[0].max_us = stats->slaves[0].total_us = 0xFFFFFFFF;
+
+	Sim_UART_Clear();
+	I2C_Stats_Dump(&I2C0_Bus);
+	dump = Sim_UART_Output(0);
+	CHECK(strncmp(dump, head, strlen(head)) == 0);
+	end = strstr(dump, "%\r\n");
+	CHECK(end != 0 && strcmp(end + 3, slave) == 0);
+}
+#endif
+
+int main(void){
+
+	static const struct{
+		const char* name;
+		void (*run)(void);
+	} tests[] = {
+		{"Timers", Test_Timers},
+		{"Delay Short", Test_Delay_Short},
+		{"UART", Test_UART},
+		{"I2C Speed", Test_I2C_Speed},
+		{"MPU6050", Test_MPU6050},
+		{"MPU6050 FIFO", Test_MPU6050_Fifo},
+		{"MPU6050 DR", Test_MPU6050_Data_Ready},
+		{"MPU6050 Scaling", Test_MPU6050_Scaling},
+		{"MPU6050 Config", Test_MPU6050_Config},
+		{"MPU6050 Aux", Test_MPU6050_Aux},
+		{"FastMath", Test_FastMath},
+		{"Tilt", Test_Tilt},
+		{"AHRS", Test_AHRS},
+		{"EEPROM", Test_EEPROM},
+		{"Calib", Test_Calib},
+		{"TCS34727", Test_TCS34727},
+		{"LCD", Test_LCD},
+		{"LCD Wake", Test_LCD_Wake},
+		{"LCD Rows", Test_LCD_Rows},
+		{"LCD Clear Home", Test_LCD_Clear_Home},
+		{"LCD Scheduled", Test_LCD_Scheduled},
+		{"Sched Clients", Test_Sched_Clients},
+		{"Sched Reject", Test_Sched_Reject},
+		{"Faults", Test_Faults},
+		{"Bus Recovery", Test_Bus_Recovery},
+		{"Init Table", Test_Init_Table},
+		{"Transfer", Test_Transfer},
+		{"Reg Batch", Test_Reg_Batch},
+		{"Ring", Test_Ring},
+		{"Snapshot", Test_Snapshot},
+		{"Wire Time", Test_Wire_Time},
+#ifdef I2C_STATS
+		{"Stats", Test_Stats},
+		{"Stats Wide", Test_Stats_Wide},
+#endif
+	};
+	uint32_t failed;
+	uint32_t i;
+
+	for(i = 0; i < sizeof(tests)/sizeof(tests[0]); i++){
+		failed = Test_Failed;
+		tests[i].run();
+		printf("%-16s %s\n", tests[i].name, (Test_Failed == failed) ? "PASS" : "FAIL");
+	}
+
+	printf("%u checks passed, %u failed\n", Test_Passed, Test_Failed);
+	return Test_Failed ? 1 : 0;
+}
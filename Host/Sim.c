@@ -0,0 +1,803 @@
+/*
+ * Sim.c
+ *
+ *	Main implementation of the host simulator: register storage,
+ *	virtual time, wide timers, UART0, the TM4C123 I2C master state
+ *	machine and interrupt dispatch
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Sim.h"
+#include "util.h"
+
+/* MCS Command Bits (write) */
+#define SIM_MCS_RUN				(0x01)
+#define SIM_MCS_START			(0x02)
+#define SIM_MCS_STOP			(0x04)
+#define SIM_MCS_ACK				(0x08)
+#define SIM_MCS_HS				(0x10)
+#define SIM_MCS_CMD_MSK		(0x1F)
+
+/* MCS Status Bits (read) */
+#define SIM_MCS_BUSY			(0x01)
+#define SIM_MCS_ERROR			(0x02)
+#define SIM_MCS_ADRACK		(0x04)
+#define SIM_MCS_DATACK		(0x08)
+#define SIM_MCS_CLKTO			(0x80)
+#define SIM_MCS_IDLE			(0x20)
+#define SIM_MCS_BUSBSY		(0x40)
+
+/* Master Interrupt Bits */
+#define SIM_MRIS_RIS			(0x01)
+#define SIM_MRIS_CLKRIS		(0x02)
+
+#define SIM_TIMER_EN			(0x01)
+#define SIM_MTPR_HS				(0x80)
+#define SIM_MAX_LINES			(4)
+
+/* Register Storage */
+#define SIM_DEFINE_REG(r) volatile uint32_t r;
+SIM_PLAIN_REGS(SIM_DEFINE_REG)
+
+volatile uint32_t SIM_I2C_REGS[4][SIM_I2C_BLOCK_WORDS];
+volatile uint32_t SIM_NVIC_EN[5];
+volatile uint32_t SIM_NVIC_PRI[35];
+
+static volatile uint32_t SIM_WTIMER_TAR[2];
+static volatile uint32_t SIM_WTIMER_CTL[2];
+static volatile uint32_t SIM_UART0_DR;
+static volatile uint32_t SIM_UART0_FR;
+static volatile uint32_t SIM_SRI2C;
+static volatile uint32_t SIM_EEPROM_RDWR;
+static volatile uint32_t SIM_EEPROM_DONE;
+
+/* Firmware Side */
+extern volatile uint32_t HOST_PRIMASK;
+void I2C0_Handler(void);
+void I2C1_Handler(void);
+void I2C2_Handler(void);
+void I2C3_Handler(void);
+
+static void (*const Sim_I2C_Vector[SIM_I2C_MODULES])(void) = {I2C0_Handler, I2C1_Handler, I2C2_Handler, I2C3_Handler};
+
+/* SCL/SDA of each module: released lines are pulled high */
+static volatile uint32_t* const Sim_I2C_Port_DATA[SIM_I2C_MODULES] = {&GPIO_PORTB_DATA_R, &GPIO_PORTA_DATA_R, &GPIO_PORTE_DATA_R, &GPIO_PORTD_DATA_R};
+static volatile uint32_t* const Sim_I2C_Port_DIR[SIM_I2C_MODULES] = {&GPIO_PORTB_DIR_R, &GPIO_PORTA_DIR_R, &GPIO_PORTE_DIR_R, &GPIO_PORTD_DIR_R};
+static const uint32_t Sim_I2C_Port_Pins[SIM_I2C_MODULES] = {0x0C, 0xC0, 0x30, 0x03};
+
+/* Wide Timer Model */
+typedef struct{
+	uint8_t running;
+	uint64_t start_ns;
+	uint32_t load;
+} SIM_TIMER_t;
+
+/* I2C Master Model */
+typedef struct{
+	SIM_I2C_DEVICE_t* devices;
+	SIM_I2C_DEVICE_t* selected;				//Slave that acknowledged the last address
+	uint8_t held;											//START sent, no STOP yet
+	uint8_t reading;
+	uint8_t stuck;										//Slave holds SCL (SIM_FAULT_STRETCH)
+
+	uint32_t status;									//Last status written to MCS
+	uint8_t busy;											//Command on the wire
+	uint64_t done_ns;
+	uint32_t done_status;
+	uint32_t done_ris;
+
+	SIM_I2C_COUNTERS_t counters;
+} SIM_I2C_t;
+
+static uint64_t Sim_Now;
+static uint64_t Sim_Delay;													//Time with WTIMER0 (DELAY_1MS) running
+static uint64_t Sim_Masked_Run;											//Time since interrupts were last able to run
+static uint64_t Sim_Masked_Max;
+static uint8_t Sim_In_Step;
+static SIM_TIMER_t Sim_Timer[2];
+static SIM_I2C_t Sim_I2C[SIM_I2C_MODULES];
+static SIM_GPIO_LINE_t* Sim_Lines[SIM_MAX_LINES];
+static uint8_t Sim_Line_Count;
+
+static char Sim_UART_Buf[SIM_UART_CAPTURE];
+static uint32_t Sim_UART_Len;
+static uint8_t Sim_UART_Echo;
+static char Sim_UART_Rx[256];
+static uint32_t Sim_UART_Rx_Head, Sim_UART_Rx_Tail;
+static uint8_t Sim_UART_Rx_Taken;
+
+/* EEPROM Model: the array survives Sim_Init like the part survives a power cycle */
+static uint32_t Sim_EEPROM[SIM_EEPROM_WORDS];
+static uint8_t Sim_EEPROM_Blank = 1;								//Never erased yet
+static int32_t Sim_EEPROM_Word = -1;								//Word the data register was loaded from
+static uint32_t Sim_EEPROM_Loaded;
+static uint32_t Sim_EEPROM_Programs;
+
+#define SIM_UART_EMPTY		(0xFFFFFFFF)				//Data register holds nothing new
+#define SIM_UART_RX_MARK	(0x80000000)				//Data register holds a received character
+
+/*
+ *	-------------------Sim_UART_Flush------------------
+ *	Local function that takes a character the firmware wrote to the
+ *	data register, or drops a received one it already read
+ *	Input: None
+ *	Output: None
+ */
+static void Sim_UART_Flush(void){
+
+	uint32_t dr = SIM_UART0_DR;
+
+	if(dr & SIM_UART_RX_MARK){
+		if(dr != SIM_UART_EMPTY && Sim_UART_Rx_Taken)
+			SIM_UART0_DR = SIM_UART_EMPTY;
+		return;
+	}
+	SIM_UART0_DR = SIM_UART_EMPTY;
+
+	if(Sim_UART_Len == SIM_UART_CAPTURE - 1){
+		memmove(Sim_UART_Buf, Sim_UART_Buf + SIM_UART_CAPTURE/2, SIM_UART_CAPTURE/2);
+		Sim_UART_Len -= SIM_UART_CAPTURE/2;
+	}
+	Sim_UART_Buf[Sim_UART_Len++] = (char)dr;
+	Sim_UART_Buf[Sim_UART_Len] = 0;
+
+	if(Sim_UART_Echo){
+		putchar((char)dr);
+		fflush(stdout);
+	}
+}
+
+/*
+ *	-------------------Sim_SCL_Period_NS------------------
+ *	Local function for the SCL period a module runs at
+ *	Input: Module Number
+ *	Output: Nanoseconds per bit
+ */
+static uint64_t Sim_SCL_Period_NS(uint8_t module){
+
+	uint32_t mtpr = SIM_I2C_REGS[module][0x00C>>2];
+	uint32_t lp_hp = (mtpr & SIM_MTPR_HS) ? 3 : 10;
+
+	return (uint64_t)2 * (1 + (mtpr & 0x7F)) * lp_hp * 1000000000ULL / SYS_CLOCK_HZ;
+}
+
+/*
+ *	-------------------Sim_I2C_Find------------------
+ *	Local function that finds a present slave at an address
+ *	Input: Module & Address
+ *	Output: Device, or 0 if nobody acknowledges
+ */
+static SIM_I2C_DEVICE_t* Sim_I2C_Find(SIM_I2C_t* i2c, uint8_t addr){
+
+	SIM_I2C_DEVICE_t* dev;
+
+	for(dev = i2c->devices; dev; dev = dev->next){
+		if(dev->addr == addr && dev->fault != SIM_FAULT_ABSENT)
+			return dev;
+	}
+	return 0;
+}
+
+/*
+ *	-------------------Sim_I2C_Reset------------------
+ *	Local function for a module reset (SRI2C) or bus recovery: the
+ *	bus is released and stuck slaves let go
+ *	Input: Module Number
+ *	Output: None
+ */
+static void Sim_I2C_Reset(uint8_t module){
+
+	SIM_I2C_t* i2c = &Sim_I2C[module];
+	SIM_I2C_DEVICE_t* dev;
+
+	if(i2c->held && i2c->selected && i2c->selected->stop)
+		i2c->selected->stop(i2c->selected);
+
+	//9 clocks and a STOP free a slave that was holding the bus
+	for(dev = i2c->devices; dev; dev = dev->next){
+		if(dev->fault == SIM_FAULT_STRETCH)
+			dev->fault = SIM_FAULT_NONE;
+	}
+
+	i2c->held = i2c->reading = i2c->stuck = i2c->busy = 0;
+	i2c->selected = 0;
+	i2c->status = SIM_MCS_IDLE;
+	SIM_I2C_REGS[module][0x004>>2] = SIM_MCS_IDLE;
+	SIM_I2C_REGS[module][0x010>>2] = 0;
+	SIM_I2C_REGS[module][0x014>>2] = 0;
+	SIM_I2C_REGS[module][0x018>>2] = 0;
+	SIM_I2C_REGS[module][0x01C>>2] = 0;
+}
+
+/*
+ *	-------------------Sim_I2C_Command------------------
+ *	Local function that carries out an MCS command. Slaves see it
+ *	right away, status and interrupt follow after the wire time
+ *	Input: Module Number & Command
+ *	Output: None
+ */
+static void Sim_I2C_Command(uint8_t module, uint32_t cmd){
+
+	SIM_I2C_t* i2c = &Sim_I2C[module];
+	volatile uint32_t* regs = SIM_I2C_REGS[module];
+	uint32_t status = 0;
+	uint32_t bits = 0;
+	uint8_t addr;
+
+	/* High-Speed master code: nobody acknowledges it, the address follows at High-Speed */
+	if((cmd & SIM_MCS_HS) && (cmd & SIM_MCS_START)){
+		i2c->held = 1;
+		i2c->selected = 0;
+		i2c->counters.starts++;
+		i2c->counters.addresses++;
+		bits = 1 + 9;
+		goto done;
+	}
+
+	if(cmd & SIM_MCS_START){
+		i2c->counters.starts++;
+		i2c->counters.addresses++;
+		bits += 1 + 9;
+		addr = (regs[0x000>>2] >> 1) & 0x7F;
+
+		i2c->held = 1;
+		i2c->reading = regs[0x000>>2] & 0x01;
+		i2c->selected = Sim_I2C_Find(i2c, addr);
+
+		if(i2c->selected == 0){
+			status = SIM_MCS_ERROR|SIM_MCS_ADRACK;
+		}
+		else{
+			if(i2c->selected->fault == SIM_FAULT_STRETCH)
+				i2c->stuck = 1;
+			if(i2c->selected->start)
+				i2c->selected->start(i2c->selected, i2c->reading);
+		}
+	}
+
+	if((cmd & SIM_MCS_RUN) && status == 0){
+		if(!i2c->held || i2c->selected == 0){
+			status = SIM_MCS_ERROR;
+		}
+		else{
+			i2c->counters.data_bytes++;
+			bits += 9;
+			if(i2c->reading)
+				regs[0x008>>2] = i2c->selected->read ? i2c->selected->read(i2c->selected) : 0xFF;
+			else if(!(i2c->selected->write && i2c->selected->write(i2c->selected, regs[0x008>>2] & 0xFF)))
+				status = SIM_MCS_ERROR|SIM_MCS_DATACK;
+		}
+	}
+
+	if((cmd & SIM_MCS_STOP) && i2c->held){
+		i2c->counters.stops++;
+		bits += 1;
+		if(i2c->selected && i2c->selected->stop)
+			i2c->selected->stop(i2c->selected);
+		i2c->held = 0;
+		i2c->selected = 0;
+	}
+
+done:
+	i2c->counters.commands++;
+	i2c->counters.bits += bits;
+	i2c->counters.busy_ns += bits * Sim_SCL_Period_NS(module);
+
+	i2c->busy = 1;
+	i2c->done_ris = SIM_MRIS_RIS;
+	i2c->done_status = status | (i2c->held ? SIM_MCS_BUSBSY : SIM_MCS_IDLE);
+	i2c->done_ns = Sim_Now + bits * Sim_SCL_Period_NS(module);
+
+	/* A stretching slave never lets the byte finish, the clock low timeout ends it */
+	if(i2c->stuck){
+		i2c->done_ris = SIM_MRIS_CLKRIS;
+		i2c->done_status = SIM_MCS_ERROR|SIM_MCS_CLKTO|SIM_MCS_BUSBSY;
+		i2c->done_ns = Sim_Now + (uint64_t)((regs[0x024>>2] & 0xFF) << 4) * Sim_SCL_Period_NS(module);
+	}
+
+	i2c->status = SIM_MCS_BUSY|SIM_MCS_BUSBSY;
+	regs[0x004>>2] = i2c->status;
+}
+
+/*
+ *	-------------------Sim_Step------------------
+ *	Local function that moves every model up to the current virtual
+ *	time and runs interrupts that are due and not masked
+ *	Input: None
+ *	Output: None
+ */
+static void Sim_Step(void){
+
+	SIM_I2C_DEVICE_t* dev;
+	SIM_I2C_t* i2c;
+	volatile uint32_t* regs;
+	uint8_t m, i;
+
+	Sim_In_Step = 1;
+
+	Sim_UART_Flush();
+
+	for(m = 0; m < SIM_I2C_MODULES; m++){
+		i2c = &Sim_I2C[m];
+		regs = SIM_I2C_REGS[m];
+
+		for(dev = i2c->devices; dev; dev = dev->next){
+			if(dev->tick)
+				dev->tick(dev, Sim_Now);
+		}
+
+		*Sim_I2C_Port_DATA[m] |= Sim_I2C_Port_Pins[m] & ~*Sim_I2C_Port_DIR[m];
+
+		/* Write 1 to clear */
+		regs[0x014>>2] &= ~regs[0x01C>>2];
+		regs[0x01C>>2] = 0;
+
+		/* MCS holds something other than our last status: the firmware issued a command */
+		if(!i2c->busy && regs[0x004>>2] != i2c->status)
+			Sim_I2C_Command(m, regs[0x004>>2] & SIM_MCS_CMD_MSK);
+
+		if(i2c->busy && Sim_Now >= i2c->done_ns){
+			i2c->busy = 0;
+			i2c->status = i2c->done_status;
+			regs[0x004>>2] = i2c->status;
+			regs[0x014>>2] |= i2c->done_ris;
+		}
+
+		/* Master interrupt, one level deep like the real priority setup */
+		regs[0x018>>2] = regs[0x014>>2] & regs[0x010>>2];
+		if(regs[0x018>>2] && !HOST_PRIMASK){
+			Sim_I2C_Vector[m]();
+			regs[0x014>>2] &= ~regs[0x01C>>2];
+			regs[0x01C>>2] = 0;
+			regs[0x018>>2] = regs[0x014>>2] & regs[0x010>>2];
+			if(!i2c->busy && regs[0x004>>2] != i2c->status)
+				Sim_I2C_Command(m, regs[0x004>>2] & SIM_MCS_CMD_MSK);
+		}
+	}
+
+	/* GPIO interrupt lines */
+	for(i = 0; i < Sim_Line_Count; i++){
+		SIM_GPIO_LINE_t* line = Sim_Lines[i];
+		*line->RIS &= ~*line->ICR;
+		*line->ICR = 0;
+		*line->MIS = *line->RIS & *line->IM;
+		if((*line->MIS & line->pin) && !HOST_PRIMASK && line->handler){
+			line->handler();
+			*line->RIS &= ~*line->ICR;
+			*line->ICR = 0;
+			*line->MIS = *line->RIS & *line->IM;
+		}
+	}
+
+	Sim_In_Step = 0;
+}
+
+/*
+ *	-------------------Sim_Poll------------------
+ *	Local function run on every hooked register access: one polled
+ *	read worth of time passes. Re-entry from an ISR only moves time
+ *	Input: None
+ *	Output: None
+ */
+static void Sim_Poll(void){
+	Sim_Now += SIM_POLL_NS;
+	if(SIM_WTIMER_CTL[0] & SIM_TIMER_EN)
+		Sim_Delay += SIM_POLL_NS;
+
+	//Masked or inside an ISR: another interrupt would have to wait
+	if(HOST_PRIMASK || Sim_In_Step){
+		Sim_Masked_Run += SIM_POLL_NS;
+		if(Sim_Masked_Run > Sim_Masked_Max)
+			Sim_Masked_Max = Sim_Masked_Run;
+	}
+	else{
+		Sim_Masked_Run = 0;
+	}
+	if(!Sim_In_Step)
+		Sim_Step();
+}
+
+/*
+ *	-------------------HOST_IRQ_Unmasked------------------
+ *	Called by END_CRITICAL when PRIMASK clears: interrupts that
+ *	became pending while masked are taken right away, like the NVIC
+ *	does, and the masked run ends. No time passes
+ *	Input: None
+ *	Output: None
+ */
+void HOST_IRQ_Unmasked(void){
+	if(!Sim_In_Step){
+		Sim_Masked_Run = 0;
+		Sim_Step();
+	}
+}
+
+/*
+ *	-------------------Sim_EEPROM_Flush------------------
+ *	Local function that programs the word the firmware wrote to the
+ *	EEPROM data register since it was loaded
+ *	Input: None
+ *	Output: None
+ */
+static void Sim_EEPROM_Flush(void){
+
+	if(Sim_EEPROM_Blank){
+		memset(Sim_EEPROM, 0xFF, sizeof(Sim_EEPROM));
+		Sim_EEPROM_Blank = 0;
+	}
+	if(Sim_EEPROM_Word >= 0 && SIM_EEPROM_RDWR != Sim_EEPROM_Loaded){
+		Sim_EEPROM[Sim_EEPROM_Word] = SIM_EEPROM_RDWR;
+		Sim_EEPROM_Programs++;
+	}
+	Sim_EEPROM_Word = -1;
+}
+
+/*
+ *	-------------------Sim_Init------------------
+ *	Reset virtual time, every register and every I2C module, and
+ *	detach all devices
+ *	Input: None
+ *	Output: None
+ */
+void Sim_Init(void){
+
+	uint8_t m;
+
+	#define SIM_CLEAR_REG(r) r = 0;
+	SIM_PLAIN_REGS(SIM_CLEAR_REG)
+
+	memset((void*)SIM_I2C_REGS, 0, sizeof(SIM_I2C_REGS));
+	memset((void*)SIM_NVIC_EN, 0, sizeof(SIM_NVIC_EN));
+	memset((void*)SIM_NVIC_PRI, 0, sizeof(SIM_NVIC_PRI));
+	memset(Sim_Timer, 0, sizeof(Sim_Timer));
+	memset(Sim_I2C, 0, sizeof(Sim_I2C));
+
+	SIM_WTIMER_TAR[0] = SIM_WTIMER_TAR[1] = 0;
+	SIM_WTIMER_CTL[0] = SIM_WTIMER_CTL[1] = 0;
+	SIM_SRI2C = 0;
+
+	//EEPROM keeps its contents, only the interface resets
+	Sim_EEPROM_Flush();
+	SIM_EEPROM_RDWR = SIM_EEPROM_DONE = 0;
+	EEPROM_EESIZE_R = ((SIM_EEPROM_WORDS/SIM_EEPROM_BLOCK_WORDS) << 16) | SIM_EEPROM_WORDS;
+
+	//Peripherals come out of reset as soon as their clock is on
+	SYSCTL_PRGPIO_R = SYSCTL_PRI2C_R = SYSCTL_PRWTIMER_R = SYSCTL_PREEPROM_R = 0xFFFFFFFF;
+	SIM_UART0_DR = SIM_UART_EMPTY;
+	Sim_UART_Rx_Taken = 0;
+
+	for(m = 0; m < SIM_I2C_MODULES; m++){
+		Sim_I2C[m].status = SIM_MCS_IDLE;
+		SIM_I2C_REGS[m][0x004>>2] = SIM_MCS_IDLE;
+	}
+
+	Sim_Line_Count = 0;
+	Sim_Now = 0;
+	Sim_Delay = 0;
+	Sim_Masked_Run = Sim_Masked_Max = 0;
+	Sim_In_Step = 0;
+	HOST_PRIMASK = 0;
+	Sim_UART_Clear();
+	Sim_UART_Rx_Head = Sim_UART_Rx_Tail = 0;
+}
+
+/*
+ *	-------------------Sim_Time_NS------------------
+ *	Current virtual time
+ *	Input: None
+ *	Output: Nanoseconds since Sim_Init
+ */
+uint64_t Sim_Time_NS(void){
+	return Sim_Now;
+}
+
+/*
+ *	-------------------Sim_Run_NS------------------
+ *	Let virtual time pass as if the firmware was idle (interrupts
+ *	still run)
+ *	Input: Nanoseconds to run
+ *	Output: None
+ */
+void Sim_Run_NS(uint64_t ns){
+	uint64_t end = Sim_Now + ns;
+	while(Sim_Now < end)
+		Sim_Poll();
+}
+
+/*
+ *	-------------------Sim_I2C_Attach------------------
+ *	Put a slave on the bus of an I2C module
+ *	Input: Module Number & Device
+ *	Output: None
+ */
+void Sim_I2C_Attach(uint8_t module, SIM_I2C_DEVICE_t* dev){
+	dev->next = Sim_I2C[module].devices;
+	Sim_I2C[module].devices = dev;
+}
+
+/*
+ *	-------------------Sim_I2C_Counters------------------
+ *	Wire activity of a module since Sim_Init (or the last reset)
+ *	Input: Module Number & Reset Flag
+ *	Output: Counters
+ */
+SIM_I2C_COUNTERS_t Sim_I2C_Counters(uint8_t module, uint8_t reset){
+	SIM_I2C_COUNTERS_t counters = Sim_I2C[module].counters;
+	if(reset)
+		memset(&Sim_I2C[module].counters, 0, sizeof(SIM_I2C_COUNTERS_t));
+	return counters;
+}
+
+/*
+ *	-------------------Sim_Delay_NS------------------
+ *	Virtual time spent with WTIMER0 running, i.e. inside DELAY_1MS,
+ *	since Sim_Init (or the last reset)
+ *	Input: Reset Flag
+ *	Output: Nanoseconds
+ */
+uint64_t Sim_Delay_NS(uint8_t reset){
+	uint64_t delay = Sim_Delay;
+	if(reset)
+		Sim_Delay = 0;
+	return delay;
+}
+
+/*
+ *	-------------------Sim_Masked_NS------------------
+ *	Longest stretch of virtual time other interrupts could not run
+ *	(PRIMASK set or an ISR running) since Sim_Init (or the last reset)
+ *	Input: Reset Flag
+ *	Output: Nanoseconds
+ */
+uint64_t Sim_Masked_NS(uint8_t reset){
+	uint64_t masked = Sim_Masked_Max;
+	if(reset)
+		Sim_Masked_Max = 0;
+	return masked;
+}
+
+/*
+ *	-------------------Sim_GPIO_Set------------------
+ *	Drive a GPIO interrupt line, a rising edge on an armed pin runs
+ *	its handler like the NVIC would
+ *	Input: Line & New Level
+ *	Output: None
+ */
+void Sim_GPIO_Set(SIM_GPIO_LINE_t* line, uint8_t level){
+
+	uint8_t i;
+
+	for(i = 0; i < Sim_Line_Count && Sim_Lines[i] != line; i++);
+	if(i == Sim_Line_Count && Sim_Line_Count < SIM_MAX_LINES)
+		Sim_Lines[Sim_Line_Count++] = line;
+
+	//Rising edge detection (IEV set) or falling edge (IEV clear)
+	if(level != line->level && (level ? (*line->IEV & line->pin) : !(*line->IEV & line->pin)))
+		*line->RIS |= line->pin;
+	line->level = level;
+}
+
+/*
+ *	-------------------Sim_UART_Output------------------
+ *	Everything the firmware sent through UART0 so far
+ *	Input: Echo Flag (1 also prints it to stdout from now on)
+ *	Output: Null terminated capture (oldest text is dropped when full)
+ */
+const char* Sim_UART_Output(uint8_t echo){
+	Sim_UART_Flush();
+	Sim_UART_Echo = echo;
+	return Sim_UART_Buf;
+}
+
+/*
+ *	-------------------Sim_UART_Clear------------------
+ *	Drop the captured UART0 output
+ *	Input: None
+ *	Output: None
+ */
+void Sim_UART_Clear(void){
+	Sim_UART_Flush();
+	Sim_UART_Len = 0;
+	Sim_UART_Buf[0] = 0;
+}
+
+/*
+ *	-------------------Sim_UART_Input------------------
+ *	Queue characters for the firmware to receive on UART0
+ *	Input: Null terminated string
+ *	Output: None
+ */
+void Sim_UART_Input(const char* str){
+	while(*str){
+		Sim_UART_Rx[Sim_UART_Rx_Head] = *str++;
+		Sim_UART_Rx_Head = (Sim_UART_Rx_Head + 1) % sizeof(Sim_UART_Rx);
+	}
+}
+
+/*
+ *	-------------------Sim_WTIMER_TAR------------------
+ *	WTIMERx_TAR_R hook: periodic count down from TAILR at
+ *	SYS_CLOCK_HZ/(TAPR+1)
+ *	Input: Timer Number
+ *	Output: Register
+ */
+volatile uint32_t* Sim_WTIMER_TAR(uint8_t timer){
+
+	SIM_TIMER_t* t = &Sim_Timer[timer];
+	uint32_t ctl = SIM_WTIMER_CTL[timer];
+	uint32_t load = timer ? WTIMER1_TAILR_R : WTIMER0_TAILR_R;
+	uint32_t tapr = timer ? WTIMER1_TAPR_R : WTIMER0_TAPR_R;
+	uint64_t tick_ns;
+	uint64_t ticks;
+
+	Sim_Poll();
+
+	if(!(ctl & SIM_TIMER_EN)){
+		t->running = 0;
+		return &SIM_WTIMER_TAR[timer];
+	}
+
+	//Enabled since the last look, or reloaded: count from TAILR again
+	if(!t->running || t->load != load){
+		t->running = 1;
+		t->start_ns = Sim_Now;
+		t->load = load;
+	}
+
+	tick_ns = (uint64_t)(tapr + 1) * 1000000000ULL / SYS_CLOCK_HZ;
+	ticks = (Sim_Now - t->start_ns) / tick_ns;
+	SIM_WTIMER_TAR[timer] = load - (uint32_t)(ticks % ((uint64_t)load + 1));
+
+	return &SIM_WTIMER_TAR[timer];
+}
+
+/*
+ *	-------------------Sim_WTIMER_CTL------------------
+ *	WTIMERx_CTL_R hook: a disabled timer restarts from TAILR the
+ *	next time it is enabled
+ *	Input: Timer Number
+ *	Output: Register
+ */
+volatile uint32_t* Sim_WTIMER_CTL(uint8_t timer){
+	if(!(SIM_WTIMER_CTL[timer] & SIM_TIMER_EN))
+		Sim_Timer[timer].running = 0;
+	return &SIM_WTIMER_CTL[timer];
+}
+
+/*
+ *	-------------------Sim_UART0_DR------------------
+ *	UART0_DR_R hook: a received character counts as read once the
+ *	firmware touches the data register
+ *	Input: None
+ *	Output: Register
+ */
+volatile uint32_t* Sim_UART0_DR(void){
+
+	Sim_UART_Flush();
+	if(SIM_UART0_DR != SIM_UART_EMPTY && (SIM_UART0_DR & SIM_UART_RX_MARK))
+		Sim_UART_Rx_Taken = 1;
+
+	return &SIM_UART0_DR;
+}
+
+/*
+ *	-------------------Sim_UART0_FR------------------
+ *	UART0_FR_R hook: transmit never fills up, receive data comes
+ *	from Sim_UART_Input
+ *	Input: None
+ *	Output: Register
+ */
+volatile uint32_t* Sim_UART0_FR(void){
+
+	Sim_Poll();
+	Sim_UART_Flush();
+
+	if(SIM_UART0_DR == SIM_UART_EMPTY && Sim_UART_Rx_Tail != Sim_UART_Rx_Head){
+		SIM_UART0_DR = SIM_UART_RX_MARK | (uint8_t)Sim_UART_Rx[Sim_UART_Rx_Tail];
+		Sim_UART_Rx_Tail = (Sim_UART_Rx_Tail + 1) % sizeof(Sim_UART_Rx);
+		Sim_UART_Rx_Taken = 0;
+	}
+
+	SIM_UART0_FR = (SIM_UART0_DR != SIM_UART_EMPTY && !Sim_UART_Rx_Taken) ? 0 : UART_FR_RXFE;
+	return &SIM_UART0_FR;
+}
+
+/*
+ *	-------------------Sim_SRI2C------------------
+ *	SYSCTL_SRI2C_R hook: a module held in reset comes back idle
+ *	Input: None
+ *	Output: Register
+ */
+volatile uint32_t* Sim_SRI2C(void){
+
+	uint8_t m;
+
+	for(m = 0; m < SIM_I2C_MODULES; m++){
+		if(SIM_SRI2C & (1U << m))
+			Sim_I2C_Reset(m);
+	}
+	return &SIM_SRI2C;
+}
+
+/*
+ *	-------------------Sim_EEPROM_RDWR------------------
+ *	EEPROM_EERDWR_R/EEPROM_EERDWRINC_R hook: loads the word at
+ *	EEBLOCK/EEOFFSET, a value written over it is programmed on the
+ *	next EEPROM access. Programming is instant
+ *	Input: Increment Flag (1 for EERDWRINC)
+ *	Output: Register
+ */
+volatile uint32_t* Sim_EEPROM_RDWR(uint8_t inc){
+
+	uint32_t word;
+
+	Sim_EEPROM_Flush();
+
+	word = (EEPROM_EEBLOCK_R % (SIM_EEPROM_WORDS/SIM_EEPROM_BLOCK_WORDS)) * SIM_EEPROM_BLOCK_WORDS
+				+ EEPROM_EEOFFSET_R % SIM_EEPROM_BLOCK_WORDS;
+	SIM_EEPROM_RDWR = Sim_EEPROM_Loaded = Sim_EEPROM[word];
+	Sim_EEPROM_Word = (int32_t)word;
+
+	if(inc)
+		EEPROM_EEOFFSET_R = (EEPROM_EEOFFSET_R + 1) % SIM_EEPROM_BLOCK_WORDS;
+	return &SIM_EEPROM_RDWR;
+}
+
+/*
+ *	-------------------Sim_EEPROM_DONE------------------
+ *	EEPROM_EEDONE_R hook: a pending write is programmed, the EEPROM
+ *	is never left working
+ *	Input: None
+ *	Output: Register
+ */
+volatile uint32_t* Sim_EEPROM_DONE(void){
+
+	Sim_Poll();
+	Sim_EEPROM_Flush();
+	SIM_EEPROM_DONE = 0;
+	return &SIM_EEPROM_DONE;
+}
+
+/*
+ *	-------------------Sim_EEPROM_Erase------------------
+ *	Erase every word to 0xFFFFFFFF, like a part fresh from the
+ *	factory
+ *	Input: None
+ *	Output: None
+ */
+void Sim_EEPROM_Erase(void){
+	Sim_EEPROM_Flush();
+	memset(Sim_EEPROM, 0xFF, sizeof(Sim_EEPROM));
+	Sim_EEPROM_Programs = 0;
+}
+
+/*
+ *	-------------------Sim_EEPROM_Data------------------
+ *	EEPROM contents, for checking or corrupting them
+ *	Input: None
+ *	Output: SIM_EEPROM_WORDS words
+ */
+uint32_t* Sim_EEPROM_Data(void){
+	Sim_EEPROM_Flush();
+	return Sim_EEPROM;
+}
+
+/*
+ *	-------------------Sim_EEPROM_Writes------------------
+ *	Words programmed since the last erase (or reset), the wear
+ *	the firmware caused
+ *	Input: Reset Flag
+ *	Output: Word count
+ */
+uint32_t Sim_EEPROM_Writes(uint8_t reset){
+
+	uint32_t programs;
+
+	Sim_EEPROM_Flush();
+	programs = Sim_EEPROM_Programs;
+	if(reset)
+		Sim_EEPROM_Programs = 0;
+	return programs;
+}
@@ -0,0 +1,196 @@
+/*
+ * Sim.h
+ *
+ *	Provides the host simulator behind Host/tm4c123gh6pm.h: virtual
+ *	time, the wide timers, UART0 capture, the I2C master modules with
+ *	their interrupts, the EEPROM, and the interface behavioral I2C
+ *	slaves plug into.
+ *
+ *	The simulator runs whenever the firmware reads a timer or the
+ *	UART flags, which every wait loop in the drivers does. Each of
+ *	those reads costs SIM_POLL_NS of virtual time, an I2C command
+ *	costs its real wire time at the configured SCL rate
+ *
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include "tm4c123gh6pm.h"
+
+/* List of Simulator Macros */
+#define SIM_POLL_NS					(250)					//Virtual time of one polled register read
+#define SIM_I2C_MODULES			(4)
+#define SIM_UART_CAPTURE		(4096)				//UART0 output kept for inspection
+#define SIM_EEPROM_WORDS		(512)					//2KB
+#define SIM_EEPROM_BLOCK_WORDS	(16)
+
+//Faults a slave can be given
+#define SIM_FAULT_NONE			(0)
+#define SIM_FAULT_ABSENT		(1)						//Browned out: address is not acknowledged
+#define SIM_FAULT_STRETCH		(2)						//Holds SCL low until the bus is recovered
+
+typedef struct SIM_I2C_DEVICE SIM_I2C_DEVICE_t;
+
+/* Behavioral I2C Slave
+ *
+ *	Device models put this first in their own struct. Callbacks run
+ *	when the master puts the matching condition on the wire
+ */
+struct SIM_I2C_DEVICE{
+	uint8_t addr;
+	uint8_t fault;																						//SIM_FAULT_*
+
+	void (*start)(SIM_I2C_DEVICE_t* dev, uint8_t read);				//(Repeated) START addressed to us
+	uint8_t (*write)(SIM_I2C_DEVICE_t* dev, uint8_t data);		//Returns 1 to ACK
+	uint8_t (*read)(SIM_I2C_DEVICE_t* dev);
+	void (*stop)(SIM_I2C_DEVICE_t* dev);
+	void (*tick)(SIM_I2C_DEVICE_t* dev, uint64_t now_ns);		//Called as virtual time moves (can be 0)
+
+	SIM_I2C_DEVICE_t* next;
+};
+
+/* Interrupt Line of a Device (data ready, ...) wired to a GPIO pin */
+typedef struct{
+	volatile uint32_t* RIS;
+	volatile uint32_t* IM;
+	volatile uint32_t* MIS;
+	volatile uint32_t* ICR;
+	volatile uint32_t* IEV;
+	uint32_t pin;
+	void (*handler)(void);
+	uint8_t level;
+} SIM_GPIO_LINE_t;
+
+/* Bus Counters, for benchmarks */
+typedef struct{
+	uint32_t commands;
+	uint32_t starts;																					//START and repeated START
+	uint32_t addresses;																				//Address phases (incl. HS master code)
+	uint32_t data_bytes;
+	uint32_t stops;
+	uint32_t bits;
+	uint64_t busy_ns;
+} SIM_I2C_COUNTERS_t;
+
+/*
+ *	-------------------Sim_Init------------------
+ *	Reset virtual time, every register and every I2C module, and
+ *	detach all devices
+ *	Input: None
+ *	Output: None
+ */
+void Sim_Init(void);
+
+/*
+ *	-------------------Sim_Time_NS------------------
+ *	Current virtual time
+ *	Input: None
+ *	Output: Nanoseconds since Sim_Init
+ */
+uint64_t Sim_Time_NS(void);
+
+/*
+ *	-------------------Sim_Run_NS------------------
+ *	Let virtual time pass as if the firmware was idle (interrupts
+ *	still run)
+ *	Input: Nanoseconds to run
+ *	Output: None
+ */
+void Sim_Run_NS(uint64_t ns);
+
+/*
+ *	-------------------Sim_I2C_Attach------------------
+ *	Put a slave on the bus of an I2C module
+ *	Input: Module Number & Device
+ *	Output: None
+ */
+void Sim_I2C_Attach(uint8_t module, SIM_I2C_DEVICE_t* dev);
+
+/*
+ *	-------------------Sim_I2C_Counters------------------
+ *	Wire activity of a module since Sim_Init (or the last reset)
+ *	Input: Module Number & Reset Flag
+ *	Output: Counters
+ */
+SIM_I2C_COUNTERS_t Sim_I2C_Counters(uint8_t module, uint8_t reset);
+
+/*
+ *	-------------------Sim_Delay_NS------------------
+ *	Virtual time spent with WTIMER0 running, i.e. inside DELAY_1MS,
+ *	since Sim_Init (or the last reset)
+ *	Input: Reset Flag
+ *	Output: Nanoseconds
+ */
+uint64_t Sim_Delay_NS(uint8_t reset);
+
+/*
+ *	-------------------Sim_Masked_NS------------------
+ *	Longest stretch of virtual time other interrupts could not run
+ *	(PRIMASK set or an ISR running) since Sim_Init (or the last reset)
+ *	Input: Reset Flag
+ *	Output: Nanoseconds
+ */
+uint64_t Sim_Masked_NS(uint8_t reset);
+
+/*
+ *	-------------------Sim_GPIO_Set------------------
+ *	Drive a GPIO interrupt line, a rising edge on an armed pin runs
+ *	its handler like the NVIC would
+ *	Input: Line & New Level
+ *	Output: None
+ */
+void Sim_GPIO_Set(SIM_GPIO_LINE_t* line, uint8_t level);
+
+/*
+ *	-------------------Sim_UART_Output------------------
+ *	Everything the firmware sent through UART0 so far
+ *	Input: Echo Flag (1 also prints it to stdout from now on)
+ *	Output: Null terminated capture (oldest text is dropped when full)
+ */
+const char* Sim_UART_Output(uint8_t echo);
+
+/*
+ *	-------------------Sim_UART_Clear------------------
+ *	Drop the captured UART0 output
+ *	Input: None
+ *	Output: None
+ */
+void Sim_UART_Clear(void);
+
+/*
+ *	-------------------Sim_UART_Input------------------
+ *	Queue characters for the firmware to receive on UART0
+ *	Input: Null terminated string
+ *	Output: None
+ */
+void Sim_UART_Input(const char* str);
+
+/*
+ *	-------------------Sim_EEPROM_Erase------------------
+ *	Erase every word to 0xFFFFFFFF, like a part fresh from the
+ *	factory. Sim_Init leaves the EEPROM as it was
+ *	Input: None
+ *	Output: None
+ */
+void Sim_EEPROM_Erase(void);
+
+/*
+ *	-------------------Sim_EEPROM_Data------------------
+ *	EEPROM contents, for checking or corrupting them
+ *	Input: None
+ *	Output: SIM_EEPROM_WORDS words
+ */
+uint32_t* Sim_EEPROM_Data(void);
+
+/*
+ *	-------------------Sim_EEPROM_Writes------------------
+ *	Words programmed since the last erase (or reset), the wear
+ *	the firmware caused
+ *	Input: Reset Flag
+ *	Output: Word count
+ */
+uint32_t Sim_EEPROM_Writes(uint8_t reset);
+
+#endif //SIM_H_
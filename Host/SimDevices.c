@@ -0,0 +1,799 @@
+/*
+ * SimDevices.c
+ *
+ *	Main implementation of the simulated I2C slaves
+ *
+ */
+
+#include <string.h>
+#include "SimDevices.h"
+
+/* MPU6050 Registers used by the model */
+#define MPU_SMPLRT_DIV				(0x19)
+#define MPU_CONFIG						(0x1A)
+#define MPU_FIFO_EN						(0x23)
+	#define MPU_FIFO_EN_SLV0		(0x01)				//SLV1, SLV2 are the next bits up
+#define MPU_I2C_MST_CTRL			(0x24)
+	#define MPU_SLV_3_FIFO_EN		(0x20)
+#define MPU_I2C_SLV0_ADDR			(0x25)				//ADDR, REG, CTRL of SLV0..3 in a row
+	#define MPU_SLV_RNW					(0x80)
+	#define MPU_SLV_EN					(0x80)
+	#define MPU_SLV_BYTE_SW			(0x40)
+	#define MPU_SLV_REG_DIS			(0x20)
+	#define MPU_SLV_GRP					(0x10)
+	#define MPU_SLV_LEN					(0x0F)
+#define MPU_I2C_SLV4_ADDR			(0x31)
+#define MPU_I2C_SLV4_REG			(0x32)
+#define MPU_I2C_SLV4_DO				(0x33)
+#define MPU_I2C_SLV4_CTRL			(0x34)
+#define MPU_I2C_SLV4_DI				(0x35)
+#define MPU_I2C_MST_STATUS		(0x36)
+	#define MPU_PASS_THROUGH		(0x80)
+	#define MPU_SLV4_DONE				(0x40)
+	#define MPU_SLV4_NACK				(0x10)
+#define MPU_INT_PIN_CFG				(0x37)
+	#define MPU_INT_LEVEL				(0x80)
+	#define MPU_LATCH_INT_EN		(0x20)
+	#define MPU_INT_RD_CLEAR		(0x10)
+#define MPU_INT_ENABLE				(0x38)
+#define MPU_INT_STATUS				(0x3A)
+	#define MPU_DATA_RDY_INT		(0x01)
+	#define MPU_FIFO_OFLOW_INT	(0x10)
+#define MPU_DATA_START				(0x3B)
+#define MPU_DATA_END					(0x48)
+#define MPU_EXT_SENS_DATA			(0x49)				//EXT_SENS_DATA_00..23
+#define MPU_EXT_END						(0x60)
+#define MPU_I2C_SLV0_DO				(0x63)				//SLV1..3 DO follow
+#define MPU_USER_CTRL					(0x6A)
+	#define MPU_USER_FIFO_EN		(0x40)
+	#define MPU_USER_I2C_MST_EN	(0x20)
+	#define MPU_USER_FIFO_RESET	(0x04)
+#define MPU_PWR_MGMT_1				(0x6B)
+	#define MPU_PWR_RESET				(0x80)
+	#define MPU_PWR_SLEEP				(0x40)
+#define MPU_FIFO_COUNTH				(0x72)
+#define MPU_FIFO_COUNTL				(0x73)
+#define MPU_FIFO_R_W					(0x74)
+#define MPU_WHO_AM_I					(0x75)
+
+/* TCS34727 Registers used by the model */
+#define TCS_CMD								(0x80)
+#define TCS_TYPE_SHIFT				(5)
+#define TCS_TYPE_AUTO_INC			(0x01)
+#define TCS_TYPE_SPECIAL			(0x03)
+#define TCS_ADDR_MSK					(0x1F)
+#define TCS_ENABLE						(0x00)
+	#define TCS_PON							(0x01)
+	#define TCS_AEN							(0x02)
+#define TCS_ATIME							(0x01)
+#define TCS_ID								(0x12)
+#define TCS_STATUS						(0x13)
+	#define TCS_AVALID					(0x01)
+#define TCS_CDATAL						(0x14)
+#define TCS_BDATAH						(0x1B)
+#define TCS_WRITABLE					((1UL<<0x00)|(1UL<<0x01)|(0x1FUL<<0x03)|(1UL<<0x0C)|(1UL<<0x0D)|(1UL<<0x0F))
+
+/* PCF8574 Port Bits and HD44780 Instructions */
+#define LCD_RS								(0x01)
+#define LCD_RW								(0x02)
+#define LCD_EN								(0x04)
+#define LCD_CLEAR							(0x01)
+#define LCD_HOME							(0x02)
+#define LCD_ENTRY							(0x04)
+	#define LCD_ENTRY_ID				(0x02)
+#define LCD_DISPLAY						(0x08)
+#define LCD_SHIFT							(0x10)
+#define LCD_FUNCTION					(0x20)
+	#define LCD_FUNCTION_DL			(0x10)
+	#define LCD_FUNCTION_N			(0x08)
+#define LCD_CGRAM							(0x40)
+#define LCD_DDRAM_SET					(0x80)
+#define LCD_ROW2							(0x40)
+
+/*
+ *	-------------------MPU6050_Int------------------
+ *	Local function that drives the model's INT pin
+ *	Input: Model & Asserted Flag
+ *	Output: None
+ */
+static void MPU6050_Int(SIM_MPU6050_t* mpu, uint8_t asserted){
+	uint8_t active_low = (mpu->regs[MPU_INT_PIN_CFG] & MPU_INT_LEVEL) ? 1 : 0;
+
+	if(mpu->int_line)
+		Sim_GPIO_Set(mpu->int_line, asserted ^ active_low);
+}
+
+/*
+ *	-------------------MPU6050_Reset------------------
+ *	Local function for power-on and PWR_MGMT_1 device reset
+ *	Input: Model
+ *	Output: None
+ */
+static void MPU6050_Reset(SIM_MPU6050_t* mpu){
+	memset(mpu->regs, 0, sizeof(mpu->regs));
+	mpu->regs[MPU_PWR_MGMT_1] = MPU_PWR_SLEEP;
+	mpu->regs[MPU_WHO_AM_I] = mpu->dev.addr & 0x7E;				//AD0 isn't reflected in WHO_AM_I
+	mpu->fifo_head = mpu->fifo_count = 0;
+	mpu->next_sample_ns = 0;
+	MPU6050_Int(mpu, 0);
+}
+
+/*
+ *	-------------------MPU6050_Fifo_Push------------------
+ *	Local function that queues one byte, the oldest byte is lost
+ *	when the FIFO is full
+ *	Input: Model & Byte
+ *	Output: None
+ */
+static void MPU6050_Fifo_Push(SIM_MPU6050_t* mpu, uint8_t data){
+	if(mpu->fifo_count == SIM_MPU6050_FIFO_SIZE){
+		mpu->fifo_head = (mpu->fifo_head + 1) % SIM_MPU6050_FIFO_SIZE;
+		mpu->fifo_count--;
+		mpu->regs[MPU_INT_STATUS] |= MPU_FIFO_OFLOW_INT;
+	}
+	mpu->fifo[(mpu->fifo_head + mpu->fifo_count) % SIM_MPU6050_FIFO_SIZE] = data;
+	mpu->fifo_count++;
+}
+
+/*
+ *	-------------------MPU6050_Aux_Transfer------------------
+ *	Local function for one transaction of the aux master: register
+ *	address (unless disabled), then the data
+ *	Input: Model, Address (MPU_SLV_RNW to read), Register, Register
+ *				 Disable Flag, Data & Length
+ *	Output: 1 if the slave answered
+ */
+static uint8_t MPU6050_Aux_Transfer(SIM_MPU6050_t* mpu, uint8_t addr, uint8_t reg, uint8_t reg_dis, uint8_t* data, uint8_t len){
+
+	SIM_I2C_DEVICE_t* dev;
+	uint8_t read = (addr & MPU_SLV_RNW) ? 1 : 0;
+	uint8_t i;
+
+	for(dev = mpu->aux; dev; dev = dev->next){
+		if(dev->addr == (addr & ~MPU_SLV_RNW) && dev->fault == SIM_FAULT_NONE)
+			break;
+	}
+	mpu->aux_transfers++;
+	if(!dev)
+		return 0;
+
+	if(!reg_dis || !read){
+		if(dev->start)
+			dev->start(dev, 0);
+		if(!reg_dis)
+			dev->write(dev, reg);
+	}
+	if(read){
+		if(dev->start)
+			dev->start(dev, 1);
+		for(i = 0; i < len; i++)
+			data[i] = dev->read(dev);
+	}
+	else{
+		for(i = 0; i < len; i++)
+			dev->write(dev, data[i]);
+	}
+	if(dev->stop)
+		dev->stop(dev);
+	return 1;
+}
+
+/*
+ *	-------------------MPU6050_Aux_Run------------------
+ *	Local function, the aux master's work for one sample: SLV0..3
+ *	in order, reads land one after another in EXT_SENS_DATA, then a
+ *	pending SLV4 single transfer
+ *	Input: Model & Bytes each slave read (filled)
+ *	Output: None
+ */
+static void MPU6050_Aux_Run(SIM_MPU6050_t* mpu, uint8_t len[4]){
+
+	uint8_t* ext = &mpu->regs[MPU_EXT_SENS_DATA];
+	uint8_t* slv;
+	uint8_t ctrl;
+	uint8_t reg;
+	uint8_t tmp;
+	uint8_t i;
+	uint8_t n;
+
+	for(i = 0; i < 4; i++){
+		slv = &mpu->regs[MPU_I2C_SLV0_ADDR + 3*i];
+		ctrl = slv[2];
+		len[i] = 0;
+		if(!(ctrl & MPU_SLV_EN) || !(ctrl & MPU_SLV_LEN))
+			continue;
+
+		if(!(slv[0] & MPU_SLV_RNW)){
+			if(!MPU6050_Aux_Transfer(mpu, slv[0], slv[1], ctrl & MPU_SLV_REG_DIS, &mpu->regs[MPU_I2C_SLV0_DO + i], 1))
+				mpu->regs[MPU_I2C_MST_STATUS] |= 1 << i;
+			continue;
+		}
+
+		n = ctrl & MPU_SLV_LEN;
+		if(ext + n > &mpu->regs[MPU_EXT_END + 1])
+			n = (uint8_t)(&mpu->regs[MPU_EXT_END + 1] - ext);
+		if(!MPU6050_Aux_Transfer(mpu, slv[0], slv[1], ctrl & MPU_SLV_REG_DIS, ext, n))
+			mpu->regs[MPU_I2C_MST_STATUS] |= 1 << i;
+
+		//Words pair up on even register addresses, or odd ones with GRP
+		if(ctrl & MPU_SLV_BYTE_SW){
+			for(reg = 0; reg + 1 < n; reg++){
+				if(((slv[1] + reg) & 1) == ((ctrl & MPU_SLV_GRP) ? 1 : 0)){
+					tmp = ext[reg];
+					ext[reg] = ext[reg + 1];
+					ext[reg + 1] = tmp;
+					reg++;
+				}
+			}
+		}
+		ext += n;
+		len[i] = n;
+	}
+
+	if(mpu->regs[MPU_I2C_SLV4_CTRL] & MPU_SLV_EN){
+		if(MPU6050_Aux_Transfer(mpu, mpu->regs[MPU_I2C_SLV4_ADDR], mpu->regs[MPU_I2C_SLV4_REG],
+														mpu->regs[MPU_I2C_SLV4_CTRL] & MPU_SLV_REG_DIS,
+														(mpu->regs[MPU_I2C_SLV4_ADDR] & MPU_SLV_RNW) ? &mpu->regs[MPU_I2C_SLV4_DI] : &mpu->regs[MPU_I2C_SLV4_DO], 1))
+			mpu->regs[MPU_I2C_MST_STATUS] |= MPU_SLV4_DONE;
+		else
+			mpu->regs[MPU_I2C_MST_STATUS] |= MPU_SLV4_NACK;
+		mpu->regs[MPU_I2C_SLV4_CTRL] &= ~MPU_SLV_EN;								//Single transfer, clears itself
+	}
+}
+
+/*
+ *	-------------------MPU6050_Sample------------------
+ *	Local function for one sample: sensor registers update as a set,
+ *	the aux master reads its slaves, enabled channels go into the
+ *	FIFO, DATA_RDY is raised
+ *	Input: Model & Current Time
+ *	Output: None
+ */
+static void MPU6050_Sample(SIM_MPU6050_t* mpu, uint64_t now_ns){
+
+	//FIFO_EN bit of each 16-bit sensor word, in register order
+	static const uint8_t fifo_bit[7] = {0x08, 0x08, 0x08, 0x80, 0x40, 0x20, 0x10};
+	uint8_t aux_len[4] = {0};
+	uint8_t aux_fifo;
+	uint8_t* ext;
+	uint8_t i;
+	uint8_t j;
+
+	for(i = 0; i < 7; i++){
+		mpu->regs[MPU_DATA_START + 2*i] = (uint8_t)((uint16_t)mpu->motion[i] >> 8);
+		mpu->regs[MPU_DATA_START + 2*i + 1] = (uint8_t)mpu->motion[i];
+	}
+
+	if(mpu->regs[MPU_USER_CTRL] & MPU_USER_I2C_MST_EN)
+		MPU6050_Aux_Run(mpu, aux_len);
+
+	if(mpu->regs[MPU_USER_CTRL] & MPU_USER_FIFO_EN){
+		for(i = 0; i < 7; i++){
+			if(mpu->regs[MPU_FIFO_EN] & fifo_bit[i]){
+				MPU6050_Fifo_Push(mpu, mpu->regs[MPU_DATA_START + 2*i]);
+				MPU6050_Fifo_Push(mpu, mpu->regs[MPU_DATA_START + 2*i + 1]);
+			}
+		}
+
+		//Aux slave data after the sensors, slave 3 is enabled in I2C_MST_CTRL
+		aux_fifo = (mpu->regs[MPU_FIFO_EN] & 0x07) | ((mpu->regs[MPU_I2C_MST_CTRL] & MPU_SLV_3_FIFO_EN) ? 0x08 : 0);
+		ext = &mpu->regs[MPU_EXT_SENS_DATA];
+		for(i = 0; i < 4; i++){
+			if(aux_fifo & (MPU_FIFO_EN_SLV0 << i)){
+				for(j = 0; j < aux_len[i]; j++)
+					MPU6050_Fifo_Push(mpu, ext[j]);
+			}
+			ext += aux_len[i];
+		}
+	}
+
+	mpu->samples++;
+	mpu->regs[MPU_INT_STATUS] |= MPU_DATA_RDY_INT;
+	if(mpu->regs[MPU_INT_STATUS] & mpu->regs[MPU_INT_ENABLE]){
+		MPU6050_Int(mpu, 1);
+		mpu->int_off_ns = now_ns + SIM_MPU6050_PULSE_NS;
+	}
+}
+
+/*
+ *	-------------------MPU6050_Tick------------------
+ *	Local function that runs the sample clock
+ *	Input: Device & Current Time
+ *	Output: None
+ */
+static void MPU6050_Tick(SIM_I2C_DEVICE_t* dev, uint64_t now_ns){
+
+	SIM_MPU6050_t* mpu = (SIM_MPU6050_t*)dev;
+	uint8_t dlpf = mpu->regs[MPU_CONFIG] & 0x07;
+	uint64_t period = 1000000000ULL * (1 + mpu->regs[MPU_SMPLRT_DIV]) /
+										((dlpf == 0 || dlpf == 7) ? SIM_MPU6050_GYRO_HZ : SIM_MPU6050_DLPF_HZ);
+
+	/* Non latched INT is a short pulse */
+	if(mpu->int_off_ns && now_ns >= mpu->int_off_ns && !(mpu->regs[MPU_INT_PIN_CFG] & MPU_LATCH_INT_EN)){
+		mpu->int_off_ns = 0;
+		MPU6050_Int(mpu, 0);
+	}
+
+	if(mpu->regs[MPU_PWR_MGMT_1] & MPU_PWR_SLEEP){
+		mpu->next_sample_ns = 0;
+		return;
+	}
+
+	//Just woke up: first sample one period from now
+	if(mpu->next_sample_ns == 0)
+		mpu->next_sample_ns = now_ns + period;
+
+	while(now_ns >= mpu->next_sample_ns){
+		MPU6050_Sample(mpu, now_ns);
+		mpu->next_sample_ns += period;
+	}
+}
+
+/*
+ *	-------------------MPU6050_Start------------------
+ *	Local function: a write begins with the register address, a
+ *	read sees the sensor registers as they are right now
+ *	Input: Device & Read Flag
+ *	Output: None
+ */
+static void MPU6050_Start(SIM_I2C_DEVICE_t* dev, uint8_t read){
+	SIM_MPU6050_t* mpu = (SIM_MPU6050_t*)dev;
+
+	mpu->first = !read;
+	if(read)
+		memcpy(mpu->shadow, &mpu->regs[MPU_DATA_START], sizeof(mpu->shadow));
+}
+
+/*
+ *	-------------------MPU6050_Write------------------
+ *	Local function for a byte written to the model
+ *	Input: Device & Byte
+ *	Output: 1 (always acknowledged)
+ */
+static uint8_t MPU6050_Write(SIM_I2C_DEVICE_t* dev, uint8_t data){
+
+	SIM_MPU6050_t* mpu = (SIM_MPU6050_t*)dev;
+	uint8_t reg;
+
+	if(mpu->first){
+		mpu->first = 0;
+		mpu->ptr = data & (SIM_MPU6050_REGS - 1);
+		return 1;
+	}
+
+	reg = mpu->ptr;
+	switch(reg){
+		case MPU_PWR_MGMT_1:
+			if(data & MPU_PWR_RESET){
+				MPU6050_Reset(mpu);
+				return 1;
+			}
+			mpu->regs[reg] = data;
+			break;
+		case MPU_USER_CTRL:
+			if(data & MPU_USER_FIFO_RESET)
+				mpu->fifo_head = mpu->fifo_count = 0;
+			mpu->regs[reg] = data & ~MPU_USER_FIFO_RESET;				//Reset bits clear themselves
+			break;
+		case MPU_FIFO_R_W:
+			MPU6050_Fifo_Push(mpu, data);
+			return 1;
+		case MPU_INT_STATUS:
+		case MPU_I2C_MST_STATUS:
+		case MPU_I2C_SLV4_DI:
+		case MPU_WHO_AM_I:
+		case MPU_FIFO_COUNTH:
+		case MPU_FIFO_COUNTL:
+			break;																						//Read only
+		default:
+			if(reg >= MPU_DATA_START && reg <= MPU_EXT_END)
+				break;
+			mpu->regs[reg] = data;
+			break;
+	}
+
+	mpu->ptr = (mpu->ptr + 1) & (SIM_MPU6050_REGS - 1);
+	return 1;
+}
+
+/*
+ *	-------------------MPU6050_Read------------------
+ *	Local function for a byte read from the model
+ *	Input: Device
+ *	Output: Byte
+ */
+static uint8_t MPU6050_Read(SIM_I2C_DEVICE_t* dev){
+
+	SIM_MPU6050_t* mpu = (SIM_MPU6050_t*)dev;
+	uint8_t reg = mpu->ptr;
+	uint8_t data;
+
+	if(reg == MPU_FIFO_R_W){
+		//Pointer stays on FIFO_R_W so a burst drains the FIFO
+		if(mpu->fifo_count == 0)
+			return 0xFF;
+		data = mpu->fifo[mpu->fifo_head];
+		mpu->fifo_head = (mpu->fifo_head + 1) % SIM_MPU6050_FIFO_SIZE;
+		mpu->fifo_count--;
+		return data;
+	}
+
+	if(reg >= MPU_DATA_START && reg <= MPU_EXT_END)
+		data = mpu->shadow[reg - MPU_DATA_START];
+	else if(reg == MPU_FIFO_COUNTH)
+		data = (uint8_t)(mpu->fifo_count >> 8);
+	else if(reg == MPU_FIFO_COUNTL)
+		data = (uint8_t)mpu->fifo_count;
+	else
+		data = mpu->regs[reg];
+
+	if(reg == MPU_I2C_MST_STATUS)
+		mpu->regs[reg] &= MPU_PASS_THROUGH;
+	if(reg == MPU_INT_STATUS || (mpu->regs[MPU_INT_PIN_CFG] & MPU_INT_RD_CLEAR)){
+		if(reg == MPU_INT_STATUS)
+			mpu->regs[MPU_INT_STATUS] = 0;
+		if(mpu->regs[MPU_INT_PIN_CFG] & MPU_LATCH_INT_EN)
+			MPU6050_Int(mpu, 0);
+	}
+
+	mpu->ptr = (mpu->ptr + 1) & (SIM_MPU6050_REGS - 1);
+	return data;
+}
+
+/*
+ *	-------------------Sim_MPU6050_Init------------------
+ *	Power-on state of an MPU6050 model (asleep, WHO_AM_I set)
+ *	Input: Model & 7-bit Address
+ *	Output: Device to attach
+ */
+SIM_I2C_DEVICE_t* Sim_MPU6050_Init(SIM_MPU6050_t* mpu, uint8_t addr){
+	memset(mpu, 0, sizeof(SIM_MPU6050_t));
+	mpu->dev.addr = addr;
+	mpu->dev.start = MPU6050_Start;
+	mpu->dev.write = MPU6050_Write;
+	mpu->dev.read = MPU6050_Read;
+	mpu->dev.tick = MPU6050_Tick;
+	MPU6050_Reset(mpu);
+	return &mpu->dev;
+}
+
+/*
+ *	-------------------Sim_MPU6050_Set_Motion------------------
+ *	Raw counts the next samples will report
+ *	Input: Model, Accel XYZ, Temperature, Gyro XYZ (raw counts)
+ *	Output: None
+ */
+void Sim_MPU6050_Set_Motion(SIM_MPU6050_t* mpu, int16_t ax, int16_t ay, int16_t az,
+														int16_t temp, int16_t gx, int16_t gy, int16_t gz){
+	mpu->motion[0] = ax;
+	mpu->motion[1] = ay;
+	mpu->motion[2] = az;
+	mpu->motion[3] = temp;
+	mpu->motion[4] = gx;
+	mpu->motion[5] = gy;
+	mpu->motion[6] = gz;
+}
+
+/*
+ *	-------------------Sim_MPU6050_Aux_Attach------------------
+ *	Put a slave on the MPU6050's aux bus, only its master reaches it
+ *	Input: Model & Device
+ *	Output: None
+ */
+void Sim_MPU6050_Aux_Attach(SIM_MPU6050_t* mpu, SIM_I2C_DEVICE_t* dev){
+	dev->next = mpu->aux;
+	mpu->aux = dev;
+}
+
+/*
+ *	-------------------Regs_Start------------------
+ *	Local function: a write begins with the register address
+ *	Input: Device & Read Flag
+ *	Output: None
+ */
+static void Regs_Start(SIM_I2C_DEVICE_t* dev, uint8_t read){
+	((SIM_REGS_t*)dev)->first = !read;
+}
+
+/*
+ *	-------------------Regs_Write------------------
+ *	Local function for a byte written to the register file
+ *	Input: Device & Byte
+ *	Output: 1 (always acknowledged)
+ */
+static uint8_t Regs_Write(SIM_I2C_DEVICE_t* dev, uint8_t data){
+
+	SIM_REGS_t* regs = (SIM_REGS_t*)dev;
+
+	if(regs->first){
+		regs->first = 0;
+		regs->ptr = data;
+		return 1;
+	}
+	regs->regs[regs->ptr++] = data;
+	return 1;
+}
+
+/*
+ *	-------------------Regs_Read------------------
+ *	Local function for a byte read from the register file
+ *	Input: Device
+ *	Output: Byte
+ */
+static uint8_t Regs_Read(SIM_I2C_DEVICE_t* dev){
+
+	SIM_REGS_t* regs = (SIM_REGS_t*)dev;
+
+	regs->reads++;
+	return regs->regs[regs->ptr++];
+}
+
+/*
+ *	-------------------Sim_Regs_Init------------------
+ *	Register file slave, every register 0
+ *	Input: Model & 7-bit Address
+ *	Output: Device to attach
+ */
+SIM_I2C_DEVICE_t* Sim_Regs_Init(SIM_REGS_t* regs, uint8_t addr){
+	memset(regs, 0, sizeof(SIM_REGS_t));
+	regs->dev.addr = addr;
+	regs->dev.start = Regs_Start;
+	regs->dev.write = Regs_Write;
+	regs->dev.read = Regs_Read;
+	return &regs->dev;
+}
+
+/*
+ *	-------------------TCS34727_Tick------------------
+ *	Local function that runs the RGBC integration cycles
+ *	Input: Device & Current Time
+ *	Output: None
+ */
+static void TCS34727_Tick(SIM_I2C_DEVICE_t* dev, uint64_t now_ns){
+
+	SIM_TCS34727_t* tcs = (SIM_TCS34727_t*)dev;
+	uint64_t cycle = (uint64_t)(256 - tcs->regs[TCS_ATIME]) * SIM_TCS34727_CYCLE_NS;
+	uint8_t i;
+
+	if((tcs->regs[TCS_ENABLE] & (TCS_PON|TCS_AEN)) != (TCS_PON|TCS_AEN)){
+		tcs->running = 0;
+		if(!(tcs->regs[TCS_ENABLE] & TCS_PON))
+			tcs->regs[TCS_STATUS] &= ~TCS_AVALID;
+		return;
+	}
+
+	//ADC just enabled: first result after one full integration
+	if(!tcs->running){
+		tcs->running = 1;
+		tcs->next_cycle_ns = now_ns + cycle;
+	}
+
+	while(now_ns >= tcs->next_cycle_ns){
+		for(i = 0; i < 4; i++){
+			tcs->regs[TCS_CDATAL + 2*i] = (uint8_t)tcs->raw[i];
+			tcs->regs[TCS_CDATAL + 2*i + 1] = (uint8_t)(tcs->raw[i] >> 8);
+		}
+		tcs->regs[TCS_STATUS] |= TCS_AVALID;
+		tcs->next_cycle_ns += cycle;
+	}
+}
+
+/*
+ *	-------------------TCS34727_Start------------------
+ *	Local function: every write begins with a command byte
+ *	Input: Device & Read Flag
+ *	Output: None
+ */
+static void TCS34727_Start(SIM_I2C_DEVICE_t* dev, uint8_t read){
+	((SIM_TCS34727_t*)dev)->first = !read;
+}
+
+/*
+ *	-------------------TCS34727_Write------------------
+ *	Local function for a byte written to the model
+ *	Input: Device & Byte
+ *	Output: 1 (always acknowledged)
+ */
+static uint8_t TCS34727_Write(SIM_I2C_DEVICE_t* dev, uint8_t data){
+
+	SIM_TCS34727_t* tcs = (SIM_TCS34727_t*)dev;
+	uint8_t type;
+
+	if(tcs->first){
+		tcs->first = 0;
+		if(!(data & TCS_CMD))
+			return 1;																			//Not a command, ignored
+		type = (data >> TCS_TYPE_SHIFT) & 0x03;
+		if(type != TCS_TYPE_SPECIAL){
+			tcs->ptr = data & TCS_ADDR_MSK;
+			tcs->auto_inc = (type == TCS_TYPE_AUTO_INC);
+		}
+		return 1;
+	}
+
+	if(TCS_WRITABLE & (1UL << tcs->ptr))
+		tcs->regs[tcs->ptr] = data;
+	if(tcs->auto_inc)
+		tcs->ptr = (tcs->ptr + 1) & TCS_ADDR_MSK;
+	return 1;
+}
+
+/*
+ *	-------------------TCS34727_Read------------------
+ *	Local function for a byte read from the model. Reading a
+ *	channel's low byte latches its high byte
+ *	Input: Device
+ *	Output: Byte
+ */
+static uint8_t TCS34727_Read(SIM_I2C_DEVICE_t* dev){
+
+	SIM_TCS34727_t* tcs = (SIM_TCS34727_t*)dev;
+	uint8_t reg = tcs->ptr;
+	uint8_t data = tcs->regs[reg];
+
+	if(reg >= TCS_CDATAL && reg <= TCS_BDATAH){
+		if((reg - TCS_CDATAL) & 0x01)
+			data = tcs->latch[(reg - TCS_CDATAL) >> 1];
+		else
+			tcs->latch[(reg - TCS_CDATAL) >> 1] = tcs->regs[reg + 1];
+	}
+
+	if(tcs->auto_inc)
+		tcs->ptr = (tcs->ptr + 1) & TCS_ADDR_MSK;
+	return data;
+}
+
+/*
+ *	-------------------Sim_TCS34727_Init------------------
+ *	Power-on state of a TCS34727 model (PON clear)
+ *	Input: Model & 7-bit Address
+ *	Output: Device to attach
+ */
+SIM_I2C_DEVICE_t* Sim_TCS34727_Init(SIM_TCS34727_t* tcs, uint8_t addr){
+	memset(tcs, 0, sizeof(SIM_TCS34727_t));
+	tcs->dev.addr = addr;
+	tcs->dev.start = TCS34727_Start;
+	tcs->dev.write = TCS34727_Write;
+	tcs->dev.read = TCS34727_Read;
+	tcs->dev.tick = TCS34727_Tick;
+	tcs->regs[TCS_ATIME] = 0xFF;
+	tcs->regs[TCS_ID] = 0x4D;
+	return &tcs->dev;
+}
+
+/*
+ *	-------------------Sim_TCS34727_Set_Color------------------
+ *	Counts the next integration cycles will report
+ *	Input: Model, Clear, Red, Green & Blue
+ *	Output: None
+ */
+void Sim_TCS34727_Set_Color(SIM_TCS34727_t* tcs, uint16_t clear, uint16_t red, uint16_t green, uint16_t blue){
+	tcs->raw[0] = clear;
+	tcs->raw[1] = red;
+	tcs->raw[2] = green;
+	tcs->raw[3] = blue;
+}
+
+/*
+ *	-------------------LCD_Instruction------------------
+ *	Local function that executes a complete HD44780 instruction or
+ *	character write
+ *	Input: Model, RS & Byte
+ *	Output: None
+ */
+static void LCD_Instruction(SIM_LCD_t* lcd, uint8_t rs, uint8_t data){
+
+	uint64_t now = Sim_Time_NS();
+	uint64_t exec = SIM_LCD_EXEC_NS;
+
+	if(now < lcd->busy_until_ns)
+		lcd->busy_violations++;
+
+	if(rs){
+		lcd->ddram[lcd->addr] = data;
+		lcd->addr = (lcd->addr + (lcd->increment ? 1 : -1)) & (SIM_LCD_DDRAM - 1);
+		lcd->characters++;
+	}
+	else{
+		lcd->instructions++;
+		if(data & LCD_DDRAM_SET)
+			lcd->addr = data & (SIM_LCD_DDRAM - 1);
+		else if(data & LCD_CGRAM)
+			;																								//Custom characters aren't modeled
+		else if(data & LCD_FUNCTION){
+			lcd->four_bit = !(data & LCD_FUNCTION_DL);
+			lcd->lines = (data & LCD_FUNCTION_N) ? 2 : 1;
+		}
+		else if(data & LCD_SHIFT)
+			;
+		else if(data & LCD_DISPLAY)
+			lcd->display = data & 0x07;
+		else if(data & LCD_ENTRY)
+			lcd->increment = (data & LCD_ENTRY_ID) ? 1 : 0;
+		else if(data & LCD_HOME){
+			lcd->addr = 0;
+			exec = SIM_LCD_CLEAR_NS;
+		}
+		else if(data & LCD_CLEAR){
+			memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+			lcd->addr = 0;
+			lcd->increment = 1;
+			exec = SIM_LCD_CLEAR_NS;
+		}
+	}
+
+	lcd->busy_until_ns = now + exec;
+}
+
+/*
+ *	-------------------LCD_Write------------------
+ *	Local function for a byte written to the PCF8574: it lands on
+ *	the port, a falling EN edge clocks D7-D4 into the HD44780
+ *	Input: Device & Byte
+ *	Output: 1 (always acknowledged)
+ */
+static uint8_t LCD_Write(SIM_I2C_DEVICE_t* dev, uint8_t data){
+
+	SIM_LCD_t* lcd = (SIM_LCD_t*)dev;
+	uint8_t prev = lcd->port;
+	uint8_t nibble;
+
+	lcd->port = data;
+	if(!(prev & LCD_EN) || (data & LCD_EN) || (prev & LCD_RW))
+		return 1;
+
+	nibble = prev & 0xF0;
+	if(!lcd->four_bit){
+		//8-bit interface: D3-D0 are not wired, they read as 0
+		LCD_Instruction(lcd, prev & LCD_RS, nibble);
+	}
+	else if(!lcd->pending){
+		lcd->half = nibble;
+		lcd->pending = 1;
+	}
+	else{
+		lcd->pending = 0;
+		LCD_Instruction(lcd, prev & LCD_RS, lcd->half | (nibble >> 4));
+	}
+	return 1;
+}
+
+/*
+ *	-------------------LCD_Read------------------
+ *	Local function for a byte read from the PCF8574
+ *	Input: Device
+ *	Output: Port Value
+ */
+static uint8_t LCD_Read(SIM_I2C_DEVICE_t* dev){
+	return ((SIM_LCD_t*)dev)->port;
+}
+
+/*
+ *	-------------------Sim_LCD_Init------------------
+ *	Power-on state of a PCF8574 + HD44780 model (8-bit interface,
+ *	blank display)
+ *	Input: Model & 7-bit Address
+ *	Output: Device to attach
+ */
+SIM_I2C_DEVICE_t* Sim_LCD_Init(SIM_LCD_t* lcd, uint8_t addr){
+	memset(lcd, 0, sizeof(SIM_LCD_t));
+	memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+	lcd->dev.addr = addr;
+	lcd->dev.write = LCD_Write;
+	lcd->dev.read = LCD_Read;
+	lcd->port = 0xFF;																			//PCF8574 powers up high
+	lcd->increment = 1;
+	lcd->lines = 1;
+	return &lcd->dev;
+}
+
+/*
+ *	-------------------Sim_LCD_Row------------------
+ *	Visible text of one display row
+ *	Input: Model, Row (0 or 1) & Buffer of at least 17 characters
+ *	Output: None
+ */
+void Sim_LCD_Row(SIM_LCD_t* lcd, uint8_t row, char* buf){
+	memcpy(buf, &lcd->ddram[row ? LCD_ROW2 : 0], 16);
+	buf[16] = 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * SimDevices.h
+ *
+ *	Provides behavioral models of the project's I2C slaves for the
+ *	host simulator: the MPU6050 IMU (with its aux I2C master), the
+ *	TCS34727 color sensor, the PCF8574 backpack driving an HD44780
+ *	LCD, and a plain register file slave standing in for secondary
+ *	sensors (magnetometer, barometer) on the MPU6050 aux bus. Each
+ *	model follows
+ *	the parts' datasheets as far as the drivers can tell the
+ *	difference (register pointer, auto-increment, data timing)
+ *
+ */
+
+#ifndef SIMDEVICES_H_
+#define SIMDEVICES_H_
+
+#include <stdint.h>
+#include "Sim.h"
+
+/* List of MPU6050 Model Macros */
+#define SIM_MPU6050_REGS				(128)
+#define SIM_MPU6050_FIFO_SIZE		(1024)
+#define SIM_MPU6050_GYRO_HZ			(8000)				//Gyro output rate with the DLPF off
+#define SIM_MPU6050_DLPF_HZ			(1000)				//Gyro output rate with the DLPF on
+#define SIM_MPU6050_PULSE_NS		(50000)				//Non latched INT pulse width
+#define SIM_MPU6050_SHADOW			(38)					//ACCEL_XOUT_H..EXT_SENS_DATA_23
+
+/* MPU6050 Model */
+typedef struct{
+	SIM_I2C_DEVICE_t dev;
+
+	uint8_t regs[SIM_MPU6050_REGS];
+	uint8_t shadow[SIM_MPU6050_SHADOW];		//Sensor registers as of the START of a read
+	uint8_t ptr;
+	uint8_t first;												//Next written byte is the register address
+
+	uint8_t fifo[SIM_MPU6050_FIFO_SIZE];
+	uint16_t fifo_head;
+	uint16_t fifo_count;
+
+	int16_t motion[7];										//Ax, Ay, Az, Temp, Gx, Gy, Gz (raw counts)
+	uint64_t next_sample_ns;
+	uint32_t samples;
+
+	SIM_GPIO_LINE_t* int_line;						//INT pin, 0 if not wired
+	uint64_t int_off_ns;
+
+	SIM_I2C_DEVICE_t* aux;								//Slaves on the aux bus
+	uint32_t aux_transfers;								//Transactions the aux master ran
+} SIM_MPU6050_t;
+
+/* Register File Slave: register pointer, auto-increment, no side effects */
+typedef struct{
+	SIM_I2C_DEVICE_t dev;
+
+	uint8_t regs[256];
+	uint8_t ptr;
+	uint8_t first;
+	uint32_t reads;												//Bytes read out
+} SIM_REGS_t;
+
+/* List of TCS34727 Model Macros */
+#define SIM_TCS34727_REGS				(32)
+#define SIM_TCS34727_CYCLE_NS		(2400000)			//One ATIME step
+
+/* TCS34727 Model */
+typedef struct{
+	SIM_I2C_DEVICE_t dev;
+
+	uint8_t regs[SIM_TCS34727_REGS];
+	uint8_t latch[4];											//High byte caught when the low byte is read
+	uint8_t ptr;
+	uint8_t auto_inc;
+	uint8_t first;
+
+	uint16_t raw[4];											//Clear, Red, Green, Blue counts
+	uint8_t running;
+	uint64_t next_cycle_ns;
+} SIM_TCS34727_t;
+
+/* List of LCD Model Macros */
+#define SIM_LCD_DDRAM						(0x80)
+#define SIM_LCD_EXEC_NS					(37000)				//Most HD44780 instructions
+#define SIM_LCD_CLEAR_NS				(1520000)			//Clear and return home
+
+/* PCF8574 Backpack with an HD44780 Model */
+typedef struct{
+	SIM_I2C_DEVICE_t dev;
+
+	uint8_t port;													//PCF8574 output latch
+	uint8_t four_bit;
+	uint8_t half;													//High nibble waiting for its low nibble
+	uint8_t pending;
+
+	uint8_t ddram[SIM_LCD_DDRAM];
+	uint8_t addr;
+	uint8_t increment;
+	uint8_t display;											//Display control bits (D, C, B)
+	uint8_t lines;
+
+	uint64_t busy_until_ns;
+	uint32_t instructions;
+	uint32_t characters;
+	uint32_t busy_violations;							//Writes that came in while the controller was busy
+} SIM_LCD_t;
+
+/*
+ *	-------------------Sim_MPU6050_Init------------------
+ *	Power-on state of an MPU6050 model (asleep, WHO_AM_I set)
+ *	Input: Model & 7-bit Address
+ *	Output: Device to attach
+ */
+SIM_I2C_DEVICE_t* Sim_MPU6050_Init(SIM_MPU6050_t* mpu, uint8_t addr);
+
+/*
+ *	-------------------Sim_MPU6050_Set_Motion------------------
+ *	Raw counts the next samples will report
+ *	Input: Model, Accel XYZ, Temperature, Gyro XYZ (raw counts)
+ *	Output: None
+ */
+void Sim_MPU6050_Set_Motion(SIM_MPU6050_t* mpu, int16_t ax, int16_t ay, int16_t az,
+														int16_t temp, int16_t gx, int16_t gy, int16_t gz);
+
+/*
+ *	-------------------Sim_MPU6050_Aux_Attach------------------
+ *	Put a slave on the MPU6050's aux bus, only its master reaches it
+ *	Input: Model & Device
+ *	Output: None
+ */
+void Sim_MPU6050_Aux_Attach(SIM_MPU6050_t* mpu, SIM_I2C_DEVICE_t* dev);
+
+/*
+ *	-------------------Sim_Regs_Init------------------
+ *	Register file slave, every register 0
+ *	Input: Model & 7-bit Address
+ *	Output: Device to attach
+ */
+SIM_I2C_DEVICE_t* Sim_Regs_Init(SIM_REGS_t* regs, uint8_t addr);
+
+/*
+ *	-------------------Sim_TCS34727_Init------------------
+ *	Power-on state of a TCS34727 model (PON clear)
+ *	Input: Model & 7-bit Address
+ *	Output: Device to attach
+ */
+SIM_I2C_DEVICE_t* Sim_TCS34727_Init(SIM_TCS34727_t* tcs, uint8_t addr);
+
+/*
+ *	-------------------Sim_TCS34727_Set_Color------------------
+ *	Counts the next integration cycles will report
+ *	Input: Model, Clear, Red, Green & Blue
+ *	Output: None
+ */
+void Sim_TCS34727_Set_Color(SIM_TCS34727_t* tcs, uint16_t clear, uint16_t red, uint16_t green, uint16_t blue);
+
+/*
+ *	-------------------Sim_LCD_Init------------------
+ *	Power-on state of a PCF8574 + HD44780 model (8-bit interface,
+ *	blank display)
+ *	Input: Model & 7-bit Address
+ *	Output: Device to attach
+ */
+SIM_I2C_DEVICE_t* Sim_LCD_Init(SIM_LCD_t* lcd, uint8_t addr);
+
+/*
+ *	-------------------Sim_LCD_Row------------------
+ *	Visible text of one display row
+ *	Input: Model, Row (0 or 1) & Buffer of at least 17 characters
+ *	Output: None
+ */
+void Sim_LCD_Row(SIM_LCD_t* lcd, uint8_t row, char* buf);
+
+#endif //SIMDEVICES_H_
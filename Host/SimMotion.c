@@ -0,0 +1,130 @@
+/*
+ * SimMotion.c
+ *
+ *	Main implementation of the synthetic motion traces
+ *
+ */
+
+#include "SimMotion.h"
+#include <math.h>
+
+#define SIM_DEGREE_TO_RAD		(3.14159265358979 / 180)
+
+/*
+ *	-------------------Sim_Motion_Up------------------
+ *	Local function, earth "up" in sensor axes (bottom row of the
+ *	rotation matrix)
+ *	Input: Quaternion & Up Vector (filled)
+ *	Output: None
+ */
+static void Sim_Motion_Up(const double* q, double* up){
+	up[0] = 2*(q[1]*q[3] - q[0]*q[2]);
+	up[1] = 2*(q[2]*q[3] + q[0]*q[1]);
+	up[2] = 1 - 2*(q[1]*q[1] + q[2]*q[2]);
+}
+
+/*
+ *	-------------------Sim_Motion_Init------------------
+ *	Start a trace at some roll and pitch (yaw 0)
+ *	Input: Trace, Roll & Pitch in degrees, Gyro Bias (same on each
+ *				 axis) & Gyro Noise Amplitude in degrees/s
+ *	Output: None
+ */
+void Sim_Motion_Init(SIM_MOTION_t* motion, float roll, float pitch, float bias, float noise){
+
+	double cr = cos(roll * SIM_DEGREE_TO_RAD / 2);
+	double sr = sin(roll * SIM_DEGREE_TO_RAD / 2);
+	double cp = cos(pitch * SIM_DEGREE_TO_RAD / 2);
+	double sp = sin(pitch * SIM_DEGREE_TO_RAD / 2);
+	uint8_t i;
+
+	motion->q[0] = cr*cp;
+	motion->q[1] = sr*cp;
+	motion->q[2] = cr*sp;
+	motion->q[3] = -sr*sp;
+	for(i = 0; i < 3; i++)
+		motion->bias[i] = bias;
+	motion->noise = noise;
+	motion->seed = 12345;
+}
+
+/*
+ *	-------------------Sim_Motion_Step------------------
+ *	Turn the true orientation at the body rates for dt, then read
+ *	the sensor
+ *	Input: Trace, Body Rates in degrees/s, dt in s & Sample (filled)
+ *	Output: None
+ */
+void Sim_Motion_Step(SIM_MOTION_t* motion, const float rate[3], float dt, MPU6050_ACCEL_t* accel, MPU6050_GYRO_t* gyro){
+
+	double* q = motion->q;
+	double w[3];
+	double d[4];
+	double up[3];
+	double h = (double)dt / SIM_MOTION_SUBSTEPS;
+	double norm;
+	float n[3];
+	uint8_t i;
+	uint8_t k;
+
+	for(i = 0; i < 3; i++)
+		w[i] = rate[i] * SIM_DEGREE_TO_RAD;
+
+	/* q' = 1/2 q (0, w), small steps in double */
+	for(k = 0; k < SIM_MOTION_SUBSTEPS; k++){
+		d[0] = 0.5*(-q[1]*w[0] - q[2]*w[1] - q[3]*w[2]);
+		d[1] = 0.5*(q[0]*w[0] + q[2]*w[2] - q[3]*w[1]);
+		d[2] = 0.5*(q[0]*w[1] - q[1]*w[2] + q[3]*w[0]);
+		d[3] = 0.5*(q[0]*w[2] + q[1]*w[1] - q[2]*w[0]);
+		norm = 0;
+		for(i = 0; i < 4; i++){
+			q[i] += d[i]*h;
+			norm += q[i]*q[i];
+		}
+		norm = sqrt(norm);
+		for(i = 0; i < 4; i++)
+			q[i] /= norm;
+	}
+
+	for(i = 0; i < 3; i++){
+		motion->seed = motion->seed*1664525 + 1013904223;
+		n[i] = motion->noise * ((float)(motion->seed >> 8) / (1 << 23) - 1.0f);
+	}
+
+	Sim_Motion_Up(q, up);
+	accel->Ax = (float)up[0];
+	accel->Ay = (float)up[1];
+	accel->Az = (float)up[2];
+	gyro->Gx = rate[0] + motion->bias[0] + n[0];
+	gyro->Gy = rate[1] + motion->bias[1] + n[1];
+	gyro->Gz = rate[2] + motion->bias[2] + n[2];
+}
+
+/*
+ *	-------------------Sim_Motion_Error------------------
+ *	How far an estimate is from the true orientation
+ *	Input: Trace, Estimated Quaternion (w, x, y, z) & Tilt Error
+ *				 (filled, degrees between the true and estimated "up", can be 0)
+ *	Output: Full rotation error in degrees
+ */
+double Sim_Motion_Error(const SIM_MOTION_t* motion, const float q[4], double* tilt_error){
+
+	double est[4];
+	double up[3];
+	double est_up[3];
+	double dot = 0;
+	uint8_t i;
+
+	for(i = 0; i < 4; i++){
+		est[i] = q[i];
+		dot += est[i]*motion->q[i];
+	}
+
+	if(tilt_error){
+		Sim_Motion_Up(motion->q, up);
+		Sim_Motion_Up(est, est_up);
+		*tilt_error = acos(fmin(1.0, up[0]*est_up[0] + up[1]*est_up[1] + up[2]*est_up[2])) / SIM_DEGREE_TO_RAD;
+	}
+
+	return 2*acos(fmin(1.0, fabs(dot))) / SIM_DEGREE_TO_RAD;
+}
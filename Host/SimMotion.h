@@ -0,0 +1,55 @@
+/*
+ * SimMotion.h
+ *
+ *	Provides synthetic motion traces for the orientation filters: a
+ *	true orientation is turned by body rates the caller picks, each
+ *	step gives the processed MPU6050 sample (g, degrees/s) that
+ *	orientation would read, with optional gyro bias and noise
+ *
+ */
+
+#ifndef SIMMOTION_H_
+#define SIMMOTION_H_
+
+#include <stdint.h>
+#include "MPU6050.h"
+
+/* List of Motion Macros */
+#define SIM_MOTION_SUBSTEPS			(16)					//Truth integration steps per sample
+
+/* Motion Trace */
+typedef struct{
+	double q[4];													//True orientation, sensor to earth (w, x, y, z)
+	float bias[3];												//Gyro offset, degrees/s
+	float noise;													//Gyro noise amplitude, degrees/s (uniform)
+	uint32_t seed;
+} SIM_MOTION_t;
+
+/*
+ *	-------------------Sim_Motion_Init------------------
+ *	Start a trace at some roll and pitch (yaw 0)
+ *	Input: Trace, Roll & Pitch in degrees, Gyro Bias (same on each
+ *				 axis) & Gyro Noise Amplitude in degrees/s
+ *	Output: None
+ */
+void Sim_Motion_Init(SIM_MOTION_t* motion, float roll, float pitch, float bias, float noise);
+
+/*
+ *	-------------------Sim_Motion_Step------------------
+ *	Turn the true orientation at the body rates for dt, then read
+ *	the sensor
+ *	Input: Trace, Body Rates in degrees/s, dt in s & Sample (filled)
+ *	Output: None
+ */
+void Sim_Motion_Step(SIM_MOTION_t* motion, const float rate[3], float dt, MPU6050_ACCEL_t* accel, MPU6050_GYRO_t* gyro);
+
+/*
+ *	-------------------Sim_Motion_Error------------------
+ *	How far an estimate is from the true orientation
+ *	Input: Trace, Estimated Quaternion (w, x, y, z) & Tilt Error
+ *				 (filled, degrees between the true and estimated "up", can be 0)
+ *	Output: Full rotation error in degrees
+ */
+double Sim_Motion_Error(const SIM_MOTION_t* motion, const float q[4], double* tilt_error);
+
+#endif //SIMMOTION_H_
@@ -0,0 +1,137 @@
+/*
+ * tm4c123gh6pm.h (Host Build)
+ *
+ *	Stands in for the TI device header when the drivers are built
+ *	for Linux. Every register the project touches is backed by the
+ *	simulator in Sim.c: plain registers are globals, the I2C module
+ *	blocks are laid out with their real offsets so &I2Cx_MSA_R works
+ *	as a base, and registers with side effects (timer counters,
+ *	UART flags, EEPROM data, peripheral resets) go through simulator
+ *	hooks
+ *
+ */
+
+#ifndef TM4C123GH6PM_H_
+#define TM4C123GH6PM_H_
+
+#include <stdint.h>
+
+/* Plain Registers: storage only, the simulator reads them when it needs to */
+#define SIM_PLAIN_REGS(X) \
+	X(GPIO_PORTA_DATA_R) X(GPIO_PORTA_DIR_R) X(GPIO_PORTA_IS_R) X(GPIO_PORTA_IBE_R) X(GPIO_PORTA_IEV_R) \
+	X(GPIO_PORTA_IM_R) X(GPIO_PORTA_RIS_R) X(GPIO_PORTA_MIS_R) X(GPIO_PORTA_ICR_R) X(GPIO_PORTA_AFSEL_R) \
+	X(GPIO_PORTA_DR8R_R) X(GPIO_PORTA_ODR_R) X(GPIO_PORTA_PUR_R) X(GPIO_PORTA_DEN_R) X(GPIO_PORTA_LOCK_R) \
+	X(GPIO_PORTA_CR_R) X(GPIO_PORTA_AMSEL_R) X(GPIO_PORTA_PCTL_R) \
+	X(GPIO_PORTB_DATA_R) X(GPIO_PORTB_DIR_R) X(GPIO_PORTB_IS_R) X(GPIO_PORTB_IBE_R) X(GPIO_PORTB_IEV_R) \
+	X(GPIO_PORTB_IM_R) X(GPIO_PORTB_RIS_R) X(GPIO_PORTB_MIS_R) X(GPIO_PORTB_ICR_R) X(GPIO_PORTB_AFSEL_R) \
+	X(GPIO_PORTB_DR8R_R) X(GPIO_PORTB_ODR_R) X(GPIO_PORTB_PUR_R) X(GPIO_PORTB_DEN_R) X(GPIO_PORTB_LOCK_R) \
+	X(GPIO_PORTB_CR_R) X(GPIO_PORTB_AMSEL_R) X(GPIO_PORTB_PCTL_R) \
+	X(GPIO_PORTD_DATA_R) X(GPIO_PORTD_DIR_R) X(GPIO_PORTD_IS_R) X(GPIO_PORTD_IBE_R) X(GPIO_PORTD_IEV_R) \
+	X(GPIO_PORTD_IM_R) X(GPIO_PORTD_RIS_R) X(GPIO_PORTD_MIS_R) X(GPIO_PORTD_ICR_R) X(GPIO_PORTD_AFSEL_R) \
+	X(GPIO_PORTD_DR8R_R) X(GPIO_PORTD_ODR_R) X(GPIO_PORTD_PUR_R) X(GPIO_PORTD_DEN_R) X(GPIO_PORTD_LOCK_R) \
+	X(GPIO_PORTD_CR_R) X(GPIO_PORTD_AMSEL_R) X(GPIO_PORTD_PCTL_R) \
+	X(GPIO_PORTE_DATA_R) X(GPIO_PORTE_DIR_R) X(GPIO_PORTE_IS_R) X(GPIO_PORTE_IBE_R) X(GPIO_PORTE_IEV_R) \
+	X(GPIO_PORTE_IM_R) X(GPIO_PORTE_RIS_R) X(GPIO_PORTE_MIS_R) X(GPIO_PORTE_ICR_R) X(GPIO_PORTE_AFSEL_R) \
+	X(GPIO_PORTE_DR8R_R) X(GPIO_PORTE_ODR_R) X(GPIO_PORTE_PUR_R) X(GPIO_PORTE_DEN_R) X(GPIO_PORTE_LOCK_R) \
+	X(GPIO_PORTE_CR_R) X(GPIO_PORTE_AMSEL_R) X(GPIO_PORTE_PCTL_R) \
+	X(GPIO_PORTF_DATA_R) X(GPIO_PORTF_DIR_R) X(GPIO_PORTF_IS_R) X(GPIO_PORTF_IBE_R) X(GPIO_PORTF_IEV_R) \
+	X(GPIO_PORTF_IM_R) X(GPIO_PORTF_RIS_R) X(GPIO_PORTF_MIS_R) X(GPIO_PORTF_ICR_R) X(GPIO_PORTF_AFSEL_R) \
+	X(GPIO_PORTF_DR8R_R) X(GPIO_PORTF_ODR_R) X(GPIO_PORTF_PUR_R) X(GPIO_PORTF_DEN_R) X(GPIO_PORTF_LOCK_R) \
+	X(GPIO_PORTF_CR_R) X(GPIO_PORTF_AMSEL_R) X(GPIO_PORTF_PCTL_R) \
+	X(SYSCTL_RCC_R) X(SYSCTL_RCGC1_R) X(SYSCTL_RCGC2_R) X(SYSCTL_RCGCGPIO_R) X(SYSCTL_RCGCI2C_R) \
+	X(SYSCTL_RCGCWTIMER_R) X(SYSCTL_RCGCPWM_R) X(SYSCTL_PRGPIO_R) X(SYSCTL_PRI2C_R) X(SYSCTL_PRWTIMER_R) \
+	X(UART0_IBRD_R) X(UART0_FBRD_R) X(UART0_LCRH_R) X(UART0_CTL_R) \
+	X(PWM0_ENABLE_R) X(PWM0_0_CTL_R) X(PWM0_0_LOAD_R) X(PWM0_0_CMPA_R) X(PWM0_0_GENA_R) \
+	X(WTIMER0_CFG_R) X(WTIMER0_TAMR_R) X(WTIMER0_TAILR_R) X(WTIMER0_TAPR_R) X(WTIMER0_IMR_R) X(WTIMER0_ICR_R) \
+	X(WTIMER1_CFG_R) X(WTIMER1_TAMR_R) X(WTIMER1_TAILR_R) X(WTIMER1_TAPR_R) X(WTIMER1_IMR_R) X(WTIMER1_ICR_R) \
+	X(SYSCTL_RCGCEEPROM_R) X(SYSCTL_PREEPROM_R) X(SYSCTL_SREEPROM_R) \
+	X(EEPROM_EESIZE_R) X(EEPROM_EEBLOCK_R) X(EEPROM_EEOFFSET_R) X(EEPROM_EESUPP_R)
+
+#define SIM_DECLARE_REG(r) extern volatile uint32_t r;
+SIM_PLAIN_REGS(SIM_DECLARE_REG)
+
+/* I2C Modules: one block per module with the real register offsets */
+#define SIM_I2C_BLOCK_WORDS		(16)
+extern volatile uint32_t SIM_I2C_REGS[4][SIM_I2C_BLOCK_WORDS];
+
+#define I2C0_MSA_R				(SIM_I2C_REGS[0][0x000>>2])
+#define I2C0_MCS_R				(SIM_I2C_REGS[0][0x004>>2])
+#define I2C0_MDR_R				(SIM_I2C_REGS[0][0x008>>2])
+#define I2C0_MTPR_R				(SIM_I2C_REGS[0][0x00C>>2])
+#define I2C0_MIMR_R				(SIM_I2C_REGS[0][0x010>>2])
+#define I2C0_MRIS_R				(SIM_I2C_REGS[0][0x014>>2])
+#define I2C0_MMIS_R				(SIM_I2C_REGS[0][0x018>>2])
+#define I2C0_MICR_R				(SIM_I2C_REGS[0][0x01C>>2])
+#define I2C0_MCR_R				(SIM_I2C_REGS[0][0x020>>2])
+#define I2C0_MCLKOCNT_R		(SIM_I2C_REGS[0][0x024>>2])
+#define I2C0_MBMON_R			(SIM_I2C_REGS[0][0x02C>>2])
+#define I2C1_MSA_R				(SIM_I2C_REGS[1][0x000>>2])
+#define I2C1_MCS_R				(SIM_I2C_REGS[1][0x004>>2])
+#define I2C1_MDR_R				(SIM_I2C_REGS[1][0x008>>2])
+#define I2C2_MSA_R				(SIM_I2C_REGS[2][0x000>>2])
+#define I2C2_MCS_R				(SIM_I2C_REGS[2][0x004>>2])
+#define I2C2_MDR_R				(SIM_I2C_REGS[2][0x008>>2])
+#define I2C3_MSA_R				(SIM_I2C_REGS[3][0x000>>2])
+#define I2C3_MCS_R				(SIM_I2C_REGS[3][0x004>>2])
+#define I2C3_MDR_R				(SIM_I2C_REGS[3][0x008>>2])
+
+/* NVIC: enable and priority registers are contiguous like on the part */
+extern volatile uint32_t SIM_NVIC_EN[5];
+extern volatile uint32_t SIM_NVIC_PRI[35];
+#define NVIC_EN0_R				(SIM_NVIC_EN[0])
+#define NVIC_EN1_R				(SIM_NVIC_EN[1])
+#define NVIC_EN2_R				(SIM_NVIC_EN[2])
+#define NVIC_EN3_R				(SIM_NVIC_EN[3])
+#define NVIC_EN4_R				(SIM_NVIC_EN[4])
+#define NVIC_PRI0_R				(SIM_NVIC_PRI[0])
+#define NVIC_PRI1_R				(SIM_NVIC_PRI[1])
+#define NVIC_PRI2_R				(SIM_NVIC_PRI[2])
+#define NVIC_PRI3_R				(SIM_NVIC_PRI[3])
+#define NVIC_PRI4_R				(SIM_NVIC_PRI[4])
+#define NVIC_PRI5_R				(SIM_NVIC_PRI[5])
+#define NVIC_PRI6_R				(SIM_NVIC_PRI[6])
+#define NVIC_PRI7_R				(SIM_NVIC_PRI[7])
+#define NVIC_PRI8_R				(SIM_NVIC_PRI[8])
+#define NVIC_PRI9_R				(SIM_NVIC_PRI[9])
+#define NVIC_PRI10_R			(SIM_NVIC_PRI[10])
+#define NVIC_PRI11_R			(SIM_NVIC_PRI[11])
+#define NVIC_PRI12_R			(SIM_NVIC_PRI[12])
+#define NVIC_PRI13_R			(SIM_NVIC_PRI[13])
+#define NVIC_PRI14_R			(SIM_NVIC_PRI[14])
+#define NVIC_PRI15_R			(SIM_NVIC_PRI[15])
+#define NVIC_PRI16_R			(SIM_NVIC_PRI[16])
+#define NVIC_PRI17_R			(SIM_NVIC_PRI[17])
+
+/* Registers with Side Effects: every access runs the simulator */
+volatile uint32_t* Sim_WTIMER_TAR(uint8_t timer);
+volatile uint32_t* Sim_WTIMER_CTL(uint8_t timer);
+volatile uint32_t* Sim_UART0_DR(void);
+volatile uint32_t* Sim_UART0_FR(void);
+volatile uint32_t* Sim_SRI2C(void);
+volatile uint32_t* Sim_EEPROM_RDWR(uint8_t inc);
+volatile uint32_t* Sim_EEPROM_DONE(void);
+
+#define WTIMER0_TAR_R			(*Sim_WTIMER_TAR(0))
+#define WTIMER0_CTL_R			(*Sim_WTIMER_CTL(0))
+#define WTIMER1_TAR_R			(*Sim_WTIMER_TAR(1))
+#define WTIMER1_CTL_R			(*Sim_WTIMER_CTL(1))
+#define UART0_DR_R				(*Sim_UART0_DR())
+#define UART0_FR_R				(*Sim_UART0_FR())
+#define SYSCTL_SRI2C_R		(*Sim_SRI2C())
+#define EEPROM_EERDWR_R		(*Sim_EEPROM_RDWR(0))
+#define EEPROM_EERDWRINC_R	(*Sim_EEPROM_RDWR(1))
+#define EEPROM_EEDONE_R		(*Sim_EEPROM_DONE())
+
+/* Bit Field Values used by the drivers (same as the TI header) */
+#define SYSCTL_RCGC1_UART0		0x00000001
+#define SYSCTL_RCGC2_GPIOA		0x00000001
+#define SYSCTL_RCGC2_GPIOF		0x00000020
+#define UART_FR_TXFF					0x00000020
+#define UART_FR_RXFE					0x00000010
+#define UART_LCRH_WLEN_8			0x00000060
+#define UART_LCRH_FEN					0x00000010
+#define UART_CTL_RXE					0x00000200
+#define UART_CTL_TXE					0x00000100
+#define UART_CTL_UARTEN				0x00000001
+
+#endif //TM4C123GH6PM_H_
@@ -0,0 +1,258 @@
+/*
+ * AHRS.c
+ *
+ *	Main implementation of the Madgwick and Mahony quaternion
+ *	orientation estimators (6 axis, gyro and accelerometer)
+ *
+ */
+
+#include "AHRS.h"
+#include "FastMath.h"
+#include <string.h>
+
+#define DEGREE_TO_RAD				(0.0174532925f)
+#define RAD_TO_DEGREE				(57.2957795f)
+#define US_TO_S							(1e-6f)
+
+/*
+ *	-----------------AHRS_Normalize-----------------
+ *	Local function that scales a vector to unit length, a zero
+ *	vector is left as is
+ *	Input: Vector & Length (3 or 4)
+ *	Output: 0 if the vector was zero, otherwise 1
+ */
+static uint8_t AHRS_Normalize(float* v, uint8_t n){
+
+	float sum = 0.0f;
+	float scale;
+	uint8_t i;
+
+	for(i = 0; i < n; i++)
+		sum += v[i]*v[i];
+	if(sum == 0.0f)
+		return 0;
+
+	scale = FastMath_InvSqrt(sum);
+	for(i = 0; i < n; i++)
+		v[i] *= scale;
+	return 1;
+}
+
+/*
+ *	-------------------AHRS_Start-------------------
+ *	Local function, the smallest rotation that lines earth "up" with
+ *	the measured gravity: q = (1 + az, ay, -ax, 0), normalized
+ *	Input: Estimator & Unit Accelerometer Vector
+ *	Output: None
+ */
+static void AHRS_Start(AHRS_t* ahrs, const float* a){
+
+	ahrs->q[0] = 1.0f + a[2];
+	ahrs->q[1] = a[1];
+	ahrs->q[2] = -a[0];
+	ahrs->q[3] = 0.0f;
+
+	//Upside down has no smallest rotation, any half turn about a level axis will do
+	if(ahrs->q[0] < 1e-6f){
+		ahrs->q[0] = 0.0f;
+		ahrs->q[1] = 1.0f;
+		ahrs->q[2] = 0.0f;
+	}
+	AHRS_Normalize(ahrs->q, 4);
+}
+
+#ifndef AHRS_MAHONY
+/*
+ *	------------------AHRS_Step-------------------
+ *	Local function, Madgwick: the gyro rate turns the quaternion, one
+ *	gradient descent step of size beta pulls its "down" toward the
+ *	accelerometer
+ *	Input: Estimator, Gyro Rate in rad/s, Unit Accelerometer Vector
+ *				 (0 to skip the correction) & dt in s
+ *	Output: None
+ */
+static void AHRS_Step(AHRS_t* ahrs, const float* g, const float* a, float dt){
+
+	float q0 = ahrs->q[0];
+	float q1 = ahrs->q[1];
+	float q2 = ahrs->q[2];
+	float q3 = ahrs->q[3];
+	float dot[4];
+	float s[4];
+	uint8_t i;
+
+	/* Rate of change from the gyro: q' = 1/2 q (0, g) */
+	dot[0] = 0.5f*(-q1*g[0] - q2*g[1] - q3*g[2]);
+	dot[1] = 0.5f*(q0*g[0] + q2*g[2] - q3*g[1]);
+	dot[2] = 0.5f*(q0*g[1] - q1*g[2] + q3*g[0]);
+	dot[3] = 0.5f*(q0*g[2] + q1*g[1] - q2*g[0]);
+
+	/* Gradient of the gravity error, zero once lined up (nothing to normalize then) */
+	if(a){
+		s[0] = 4.0f*q0*(q1*q1 + q2*q2) + 2.0f*(q2*a[0] - q1*a[1]);
+		s[1] = 4.0f*q1*(q0*q0 + q3*q3) - 2.0f*(q3*a[0] + q0*a[1]) + 4.0f*q1*(2.0f*(q1*q1 + q2*q2) - 1.0f + a[2]);
+		s[2] = 4.0f*q2*(q0*q0 + q3*q3) + 2.0f*(q0*a[0] - q3*a[1]) + 4.0f*q2*(2.0f*(q1*q1 + q2*q2) - 1.0f + a[2]);
+		s[3] = 4.0f*q3*(q1*q1 + q2*q2) - 2.0f*(q1*a[0] + q2*a[1]);
+		if(AHRS_Normalize(s, 4))
+			for(i = 0; i < 4; i++)
+				dot[i] -= ahrs->beta*s[i];
+	}
+
+	for(i = 0; i < 4; i++)
+		ahrs->q[i] += dot[i]*dt;
+	AHRS_Normalize(ahrs->q, 4);
+}
+#else
+/*
+ *	------------------AHRS_Step-------------------
+ *	Local function, Mahony: the cross product of the measured and
+ *	estimated "down" is a rotation error, fed back into the gyro rate
+ *	through a PI controller
+ *	Input: Estimator, Gyro Rate in rad/s, Unit Accelerometer Vector
+ *				 (0 to skip the correction) & dt in s
+ *	Output: None
+ */
+static void AHRS_Step(AHRS_t* ahrs, const float* g, const float* a, float dt){
+
+	float q0 = ahrs->q[0];
+	float q1 = ahrs->q[1];
+	float q2 = ahrs->q[2];
+	float q3 = ahrs->q[3];
+	float rate[3];
+	float v[3];
+	float e[3];
+	uint8_t i;
+
+	for(i = 0; i < 3; i++)
+		rate[i] = g[i];
+
+	if(a){
+		/* Estimated "down" in sensor axes (bottom row of the rotation matrix), halved */
+		v[0] = q1*q3 - q0*q2;
+		v[1] = q0*q1 + q2*q3;
+		v[2] = q0*q0 - 0.5f + q3*q3;
+
+		e[0] = a[1]*v[2] - a[2]*v[1];
+		e[1] = a[2]*v[0] - a[0]*v[2];
+		e[2] = a[0]*v[1] - a[1]*v[0];
+
+		for(i = 0; i < 3; i++){
+			ahrs->integral[i] += 2.0f*ahrs->ki*e[i]*dt;
+			rate[i] += 2.0f*ahrs->kp*e[i] + ahrs->integral[i];
+		}
+	}
+
+	/* q' = 1/2 q (0, rate) */
+	for(i = 0; i < 3; i++)
+		rate[i] *= 0.5f*dt;
+	ahrs->q[0] += -q1*rate[0] - q2*rate[1] - q3*rate[2];
+	ahrs->q[1] += q0*rate[0] + q2*rate[2] - q3*rate[1];
+	ahrs->q[2] += q0*rate[1] - q1*rate[2] + q3*rate[0];
+	ahrs->q[3] += q0*rate[2] + q1*rate[1] - q2*rate[0];
+	AHRS_Normalize(ahrs->q, 4);
+}
+#endif
+
+/*
+ *	-------------------AHRS_Init------------------
+ *	Set up an estimator with the default tuning, the first update
+ *	starts it from the accelerometer. Tuning fields can be changed
+ *	after this
+ *	Input: Estimator
+ *	Output: None
+ */
+void AHRS_Init(AHRS_t* ahrs){
+	memset(ahrs, 0, sizeof(*ahrs));
+	ahrs->q[0] = 1.0f;
+	ahrs->beta = AHRS_DEFAULT_BETA;
+	ahrs->kp = AHRS_DEFAULT_KP;
+	ahrs->ki = AHRS_DEFAULT_KI;
+}
+
+/*
+ *	------------------AHRS_Update-----------------
+ *	One step from a processed sample (g, degrees/s), dt is the time
+ *	since the previous update. Stamps wrap at 2^32 us
+ *	Input: Estimator, MPU6050 Accel & Gyro User Instance Structs &
+ *				 Sample Time in us (TIMESTAMP_US when it was read)
+ *	Output: None
+ */
+void AHRS_Update(AHRS_t* ahrs, const MPU6050_ACCEL_t* Accel_Instance, const MPU6050_GYRO_t* Gyro_Instance, uint32_t timestamp_us){
+
+	uint32_t elapsed_us = timestamp_us - ahrs->last_us;		//Unsigned difference survives the wrap
+	float g[3];
+	float a[3];
+	uint8_t have_accel;
+
+	a[0] = Accel_Instance->Ax;
+	a[1] = Accel_Instance->Ay;
+	a[2] = Accel_Instance->Az;
+	have_accel = AHRS_Normalize(a, 3);
+
+	ahrs->last_us = timestamp_us;
+
+	//First sample, or too long since the last one to integrate across
+	if(!ahrs->started || elapsed_us > AHRS_MAX_DT_US){
+		if(have_accel){
+			AHRS_Start(ahrs, a);
+			ahrs->started = 1;
+		}
+		return;
+	}
+
+	//Same sample again, nothing to integrate
+	if(elapsed_us == 0)
+		return;
+
+	g[0] = Gyro_Instance->Gx*DEGREE_TO_RAD;
+	g[1] = Gyro_Instance->Gy*DEGREE_TO_RAD;
+	g[2] = Gyro_Instance->Gz*DEGREE_TO_RAD;
+
+	//Free fall reads no gravity: gyro only for that sample
+	AHRS_Step(ahrs, g, have_accel ? a : 0, (float)elapsed_us*US_TO_S);
+}
+
+/*
+ *	----------------AHRS_Get_Euler----------------
+ *	Orientation as roll, pitch and yaw. Pitch is kept within +-90,
+ *	roll and yaw lose their meaning only right at +-90 pitch (the
+ *	quaternion itself doesn't)
+ *	Input: Estimator & Euler Angles (filled)
+ *	Output: None
+ */
+void AHRS_Get_Euler(const AHRS_t* ahrs, AHRS_EULER_t* euler){
+
+	float R[3][3];
+
+	AHRS_Get_Matrix(ahrs, R);
+
+	//atan2 all the way: no asin domain error from rounding near +-90 pitch
+	euler->roll = FastMath_Atan2(R[2][1], R[2][2])*RAD_TO_DEGREE;
+	euler->pitch = FastMath_Atan2(-R[2][0], FastMath_Hypot(R[2][1], R[2][2]))*RAD_TO_DEGREE;
+	euler->yaw = FastMath_Atan2(R[1][0], R[0][0])*RAD_TO_DEGREE;
+}
+
+/*
+ *	----------------AHRS_Get_Matrix---------------
+ *	Orientation as a rotation matrix, sensor axes to earth axes:
+ *	earth = R * sensor. The bottom row is "up" in sensor axes
+ *	Input: Estimator & Matrix (filled, row major)
+ *	Output: None
+ */
+void AHRS_Get_Matrix(const AHRS_t* ahrs, float R[3][3]){
+
+	float q0 = ahrs->q[0];
+	float q1 = ahrs->q[1];
+	float q2 = ahrs->q[2];
+	float q3 = ahrs->q[3];
+
+	R[0][0] = 1.0f - 2.0f*(q2*q2 + q3*q3);
+	R[0][1] = 2.0f*(q1*q2 - q0*q3);
+	R[0][2] = 2.0f*(q1*q3 + q0*q2);
+	R[1][0] = 2.0f*(q1*q2 + q0*q3);
+	R[1][1] = 1.0f - 2.0f*(q1*q1 + q3*q3);
+	R[1][2] = 2.0f*(q2*q3 - q0*q1);
+	R[2][0] = 2.0f*(q1*q3 - q0*q2);
+	R[2][1] = 2.0f*(q2*q3 + q0*q1);
+	R[2][2] = 1.0f - 2.0f*(q1*q1 + q2*q2);
+}
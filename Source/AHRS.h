@@ -0,0 +1,91 @@
+/*
+ * AHRS.h
+ *
+ *	Provides a quaternion orientation estimator for the MPU6050
+ *	stream: the gyro rate turns the quaternion, the accelerometer
+ *	pulls its "down" back into line. Full 3D orientation with no
+ *	gimbal lock, yaw is gyro only (there is no magnetometer)
+ *
+ *	Madgwick (gradient descent) by default, Mahony (PI feedback) with
+ *	AHRS_MAHONY defined. Nothing is allocated, the square roots are
+ *	FastMath_InvSqrt
+ *
+ *	The quaternion takes sensor axes to earth axes, earth Z is up:
+ *	level and face up (Az = +1g) is the identity
+ *
+ */
+
+#ifndef AHRS_H_
+#define AHRS_H_
+
+#include <stdint.h>
+#include "MPU6050.h"
+
+//#define AHRS_MAHONY
+
+/* List of AHRS Macros */
+#define AHRS_DEFAULT_BETA				(0.1f)			//Madgwick gain, rad/s of correction (~ gyro error)
+#define AHRS_DEFAULT_KP					(1.0f)			//Mahony proportional gain
+#define AHRS_DEFAULT_KI					(0.02f)			//Mahony integral gain, learns the gyro bias
+#define AHRS_MAX_DT_US					(500000)		//A longer gap restarts from the accelerometer
+
+/* Estimator State, one per sensor */
+typedef struct{
+	float q[4];												//w, x, y, z (unit length)
+
+	float beta;												//Madgwick tuning
+	float kp;													//Mahony tuning
+	float ki;
+	float integral[3];								//Mahony gyro bias estimate, rad/s
+
+	uint8_t started;
+	uint32_t last_us;
+} AHRS_t;
+
+/* Euler Angles, Z-Y-X (yaw, then pitch, then roll), degrees */
+typedef struct{
+	float roll;
+	float pitch;
+	float yaw;
+} AHRS_EULER_t;
+
+/*
+ *	-------------------AHRS_Init------------------
+ *	Set up an estimator with the default tuning, the first update
+ *	starts it from the accelerometer. Tuning fields can be changed
+ *	after this
+ *	Input: Estimator
+ *	Output: None
+ */
+void AHRS_Init(AHRS_t* ahrs);
+
+/*
+ *	------------------AHRS_Update-----------------
+ *	One step from a processed sample (g, degrees/s), dt is the time
+ *	since the previous update. Stamps wrap at 2^32 us
+ *	Input: Estimator, MPU6050 Accel & Gyro User Instance Structs &
+ *				 Sample Time in us (TIMESTAMP_US when it was read)
+ *	Output: None
+ */
+void AHRS_Update(AHRS_t* ahrs, const MPU6050_ACCEL_t* Accel_Instance, const MPU6050_GYRO_t* Gyro_Instance, uint32_t timestamp_us);
+
+/*
+ *	----------------AHRS_Get_Euler----------------
+ *	Orientation as roll, pitch and yaw. Pitch is kept within +-90,
+ *	roll and yaw lose their meaning only right at +-90 pitch (the
+ *	quaternion itself doesn't)
+ *	Input: Estimator & Euler Angles (filled)
+ *	Output: None
+ */
+void AHRS_Get_Euler(const AHRS_t* ahrs, AHRS_EULER_t* euler);
+
+/*
+ *	----------------AHRS_Get_Matrix---------------
+ *	Orientation as a rotation matrix, sensor axes to earth axes:
+ *	earth = R * sensor. The bottom row is "up" in sensor axes
+ *	Input: Estimator & Matrix (filled, row major)
+ *	Output: None
+ */
+void AHRS_Get_Matrix(const AHRS_t* ahrs, float R[3][3]);
+
+#endif //AHRS_H_
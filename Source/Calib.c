@@ -0,0 +1,260 @@
+/*
+ * Calib.c
+ *
+ *	Main implementation of the MPU6050 calibration and its EEPROM
+ *	record
+ *
+ */
+
+#include "Calib.h"
+#include "EEPROM.h"
+#include "util.h"
+#include <string.h>
+
+#define CALIB_CRC_POLY				(0xEDB88320)		//CRC-32 (IEEE), reflected
+#define CALIB_PAYLOAD_WORDS		(sizeof(CALIB_t)/sizeof(uint32_t))
+#define CALIB_RECORD_WORDS		(2 + CALIB_PAYLOAD_WORDS + 1)
+
+/* EEPROM Record: magic, version, payload, CRC-32 of everything before it */
+typedef struct{
+	uint32_t words[CALIB_RECORD_WORDS];
+} CALIB_RECORD_t;
+
+/*
+ *	-------------------Calib_CRC32------------------
+ *	Local function, CRC-32 over words taken least significant byte
+ *	first (same value whatever the byte order)
+ *	Input: Words & Word Count
+ *	Output: CRC
+ */
+static uint32_t Calib_CRC32(const uint32_t* words, uint32_t count){
+
+	uint32_t crc = 0xFFFFFFFF;
+	uint8_t byte;
+	uint8_t bit;
+
+	while(count--){
+		for(byte = 0; byte < 4; byte++){
+			crc ^= (*words >> (8*byte)) & 0xFF;
+			for(bit = 0; bit < 8; bit++)
+				crc = (crc >> 1) ^ (CALIB_CRC_POLY & (0U - (crc & 1)));
+		}
+		words++;
+	}
+	return ~crc;
+}
+
+/*
+ *	-------------------Calib_Measure------------------
+ *	Local function that averages CALIB_SAMPLES processed samples
+ *	Input: Accel Mean & Gyro Mean, X Y Z
+ *	Output: CALIB_OK or CALIB_ERROR
+ */
+static uint8_t Calib_Measure(float accel[3], float gyro[3]){
+
+	MPU6050_ACCEL_t a;
+	MPU6050_GYRO_t g;
+	float sum[6] = {0};
+	uint16_t i;
+
+	for(i = 0; i < CALIB_SAMPLES; i++){
+		DELAY_1MS(CALIB_SAMPLE_MS);
+		if(MPU6050_Get_Motion(&a, &g, 0) != I2C_STATUS_OK)
+			return CALIB_ERROR;
+		MPU6050_Process_Accel(&a);
+		MPU6050_Process_Gyro(&g);
+		sum[0] += a.Ax;
+		sum[1] += a.Ay;
+		sum[2] += a.Az;
+		sum[3] += g.Gx;
+		sum[4] += g.Gy;
+		sum[5] += g.Gz;
+	}
+
+	for(i = 0; i < 3; i++){
+		accel[i] = sum[i] / CALIB_SAMPLES;
+		gyro[i] = sum[3 + i] / CALIB_SAMPLES;
+	}
+	return CALIB_OK;
+}
+
+/*
+ *	-------------------Calib_Reset------------------
+ *	No correction: zero bias and offset, unit scale
+ *	Input: Calibration
+ *	Output: None
+ */
+void Calib_Reset(CALIB_t* calib){
+
+	uint8_t i;
+
+	for(i = 0; i < 3; i++){
+		calib->gyro_bias[i] = 0;
+		calib->accel_offset[i] = 0;
+		calib->accel_scale[i] = 1.0f;
+	}
+}
+
+/*
+ *	-------------------Calib_Init------------------
+ *	Boot time calibration: load the stored one, or measure (board
+ *	still and level) and store a new one if there is none or if
+ *	forced. Starts the EEPROM if it isn't yet, needs MPU6050_Init
+ *	Input: Calibration & Force Flag
+ *	Output: CALIB_OK (loaded), CALIB_NEW or CALIB_ERROR
+ */
+uint8_t Calib_Init(CALIB_t* calib, uint8_t force){
+
+	uint8_t status;
+
+	if(!EEPROM_Size() && EEPROM_Init() != EEPROM_OK)
+		return CALIB_ERROR;
+
+	if(!force){
+		status = Calib_Load(calib);
+		if(status != CALIB_INVALID)
+			return status;
+	}
+
+	Calib_Reset(calib);
+	if(Calib_Run(calib) != CALIB_NEW || Calib_Store(calib) != CALIB_OK)
+		return CALIB_ERROR;
+	return CALIB_NEW;
+}
+
+/*
+ *	-------------------Calib_Load------------------
+ *	Read the stored calibration, left as is unless the record is
+ *	intact and of this version
+ *	Input: Calibration
+ *	Output: CALIB_OK, CALIB_INVALID or CALIB_ERROR
+ */
+uint8_t Calib_Load(CALIB_t* calib){
+
+	CALIB_RECORD_t record;
+
+	if(EEPROM_Read(CALIB_EEPROM_ADDR, record.words, CALIB_RECORD_WORDS) != EEPROM_OK)
+		return CALIB_ERROR;
+
+	if(record.words[0] != CALIB_MAGIC || record.words[1] != CALIB_VERSION
+		|| record.words[CALIB_RECORD_WORDS - 1] != Calib_CRC32(record.words, CALIB_RECORD_WORDS - 1))
+		return CALIB_INVALID;
+
+	memcpy(calib, &record.words[2], sizeof(CALIB_t));
+	return CALIB_OK;
+}
+
+/*
+ *	-------------------Calib_Store------------------
+ *	Write the calibration to the EEPROM, unchanged words are not
+ *	programmed again
+ *	Input: Calibration
+ *	Output: CALIB_OK or CALIB_ERROR
+ */
+uint8_t Calib_Store(const CALIB_t* calib){
+
+	CALIB_RECORD_t record;
+
+	record.words[0] = CALIB_MAGIC;
+	record.words[1] = CALIB_VERSION;
+	memcpy(&record.words[2], calib, sizeof(CALIB_t));
+	record.words[CALIB_RECORD_WORDS - 1] = Calib_CRC32(record.words, CALIB_RECORD_WORDS - 1);
+
+	if(EEPROM_Write(CALIB_EEPROM_ADDR, record.words, CALIB_RECORD_WORDS) != EEPROM_OK)
+		return CALIB_ERROR;
+	return CALIB_OK;
+}
+
+/*
+ *	-------------------Calib_Run------------------
+ *	Measure gyro bias and accelerometer offset with the board still
+ *	and level, face up. The accelerometer scale is kept
+ *	Input: Calibration
+ *	Output: CALIB_NEW or CALIB_ERROR
+ */
+uint8_t Calib_Run(CALIB_t* calib){
+
+	float accel[3];
+	float gyro[3];
+	uint8_t i;
+
+	if(Calib_Measure(accel, gyro) != CALIB_OK)
+		return CALIB_ERROR;
+
+	//Level: X and Y read their offset, Z reads offset + 1g/scale
+	for(i = 0; i < 3; i++){
+		calib->gyro_bias[i] = gyro[i];
+		calib->accel_offset[i] = accel[i];
+	}
+	calib->accel_offset[2] -= 1.0f / calib->accel_scale[2];
+	return CALIB_NEW;
+}
+
+/*
+ *	-------------------Calib_Face------------------
+ *	Measure one face of the six face procedure, board still
+ *	Input: Face Measurements & Face (CALIB_FACE_*)
+ *	Output: CALIB_OK, CALIB_INVALID or CALIB_ERROR
+ */
+uint8_t Calib_Face(CALIB_FACES_t* faces, uint8_t face){
+
+	float accel[3];
+	float gyro[3];
+
+	if(face >= CALIB_FACES)
+		return CALIB_INVALID;
+	if(Calib_Measure(accel, gyro) != CALIB_OK)
+		return CALIB_ERROR;
+
+	faces->up[face] = accel[face / 2];
+	faces->seen |= 1U << face;
+	return CALIB_OK;
+}
+
+/*
+ *	-------------------Calib_Faces_Solve------------------
+ *	Accelerometer offset and scale of every axis from its up and
+ *	down faces, the gyro bias is kept
+ *	Input: Face Measurements & Calibration
+ *	Output: CALIB_NEW, or CALIB_INVALID if a face is missing
+ */
+uint8_t Calib_Faces_Solve(const CALIB_FACES_t* faces, CALIB_t* calib){
+
+	float up;
+	float down;
+	uint8_t i;
+
+	if(faces->seen != (1U << CALIB_FACES) - 1)
+		return CALIB_INVALID;
+
+	//Up reads offset + 1g/scale, down reads offset - 1g/scale
+	for(i = 0; i < 3; i++){
+		up = faces->up[2*i];
+		down = faces->up[2*i + 1];
+		if(up <= down)
+			return CALIB_INVALID;
+		calib->accel_offset[i] = (up + down) * 0.5f;
+		calib->accel_scale[i] = 2.0f / (up - down);
+	}
+	return CALIB_NEW;
+}
+
+/*
+ *	-------------------Calib_Apply------------------
+ *	Correct processed readings (MPU6050_Process_Accel/Gyro)
+ *	Input: Calibration, Accel & Gyro (either can be 0)
+ *	Output: None
+ */
+void Calib_Apply(const CALIB_t* calib, MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance){
+
+	if(Accel_Instance){
+		Accel_Instance->Ax = (Accel_Instance->Ax - calib->accel_offset[0]) * calib->accel_scale[0];
+		Accel_Instance->Ay = (Accel_Instance->Ay - calib->accel_offset[1]) * calib->accel_scale[1];
+		Accel_Instance->Az = (Accel_Instance->Az - calib->accel_offset[2]) * calib->accel_scale[2];
+	}
+	if(Gyro_Instance){
+		Gyro_Instance->Gx -= calib->gyro_bias[0];
+		Gyro_Instance->Gy -= calib->gyro_bias[1];
+		Gyro_Instance->Gz -= calib->gyro_bias[2];
+	}
+}
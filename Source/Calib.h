@@ -0,0 +1,127 @@
+/*
+ * Calib.h
+ *
+ *	Provides MPU6050 calibration that survives a reset: gyro bias,
+ *	accelerometer offset and scale are measured once and kept in the
+ *	on-chip EEPROM with a version and a CRC-32. A warm boot loads
+ *	them in a few microseconds, a new calibration only runs when the
+ *	record is missing, damaged or from another firmware version, or
+ *	when it is asked for
+ *
+ *	Calib_Run needs the board still and level, face up (Az = +1g).
+ *	The six face procedure (Calib_Face, Calib_Faces_Solve) also finds
+ *	the accelerometer scale, it needs each axis pointed up and down
+ *
+ */
+
+#ifndef CALIB_H_
+#define CALIB_H_
+
+#include <stdint.h>
+#include "MPU6050.h"
+
+/* List of Calib Macros */
+#define CALIB_VERSION					(1)					//Bump when CALIB_t changes, older records recalibrate
+#define CALIB_MAGIC						(0x43414C42)	//"CALB"
+#define CALIB_EEPROM_ADDR			(0)					//Word address of the record
+#define CALIB_SAMPLES					(256)				//Samples averaged per measurement
+#define CALIB_SAMPLE_MS				(1)					//New sample every 1ms at the default rate
+
+#define CALIB_OK							(0)					//Loaded from the EEPROM
+#define CALIB_NEW							(1)					//Measured and stored
+#define CALIB_INVALID					(2)					//No usable record, or faces missing
+#define CALIB_ERROR						(3)					//Bus or EEPROM error
+
+//Six face procedure, the axis that points up (or down)
+#define CALIB_FACE_X_UP				(0)
+#define CALIB_FACE_X_DOWN			(1)
+#define CALIB_FACE_Y_UP				(2)
+#define CALIB_FACE_Y_DOWN			(3)
+#define CALIB_FACE_Z_UP				(4)
+#define CALIB_FACE_Z_DOWN			(5)
+#define CALIB_FACES						(6)
+
+/* Calibration: corrected = (reading - offset) * scale, gyro = reading - bias */
+typedef struct{
+	float gyro_bias[3];								//degrees/s read at rest, X Y Z
+	float accel_offset[3];						//g read at 0g
+	float accel_scale[3];							//true g per g read
+} CALIB_t;
+
+/* Six Face Measurements */
+typedef struct{
+	float up[CALIB_FACES];						//g the vertical axis read on each face
+	uint8_t seen;											//One bit per face measured, start from 0
+} CALIB_FACES_t;
+
+/*
+ *	-------------------Calib_Reset------------------
+ *	No correction: zero bias and offset, unit scale
+ *	Input: Calibration
+ *	Output: None
+ */
+void Calib_Reset(CALIB_t* calib);
+
+/*
+ *	-------------------Calib_Init------------------
+ *	Boot time calibration: load the stored one, or measure (board
+ *	still and level) and store a new one if there is none or if
+ *	forced. Starts the EEPROM if it isn't yet, needs MPU6050_Init
+ *	Input: Calibration & Force Flag
+ *	Output: CALIB_OK (loaded), CALIB_NEW or CALIB_ERROR
+ */
+uint8_t Calib_Init(CALIB_t* calib, uint8_t force);
+
+/*
+ *	-------------------Calib_Load------------------
+ *	Read the stored calibration, left as is unless the record is
+ *	intact and of this version
+ *	Input: Calibration
+ *	Output: CALIB_OK, CALIB_INVALID or CALIB_ERROR
+ */
+uint8_t Calib_Load(CALIB_t* calib);
+
+/*
+ *	-------------------Calib_Store------------------
+ *	Write the calibration to the EEPROM, unchanged words are not
+ *	programmed again
+ *	Input: Calibration
+ *	Output: CALIB_OK or CALIB_ERROR
+ */
+uint8_t Calib_Store(const CALIB_t* calib);
+
+/*
+ *	-------------------Calib_Run------------------
+ *	Measure gyro bias and accelerometer offset with the board still
+ *	and level, face up. The accelerometer scale is kept
+ *	Input: Calibration
+ *	Output: CALIB_NEW or CALIB_ERROR
+ */
+uint8_t Calib_Run(CALIB_t* calib);
+
+/*
+ *	-------------------Calib_Face------------------
+ *	Measure one face of the six face procedure, board still
+ *	Input: Face Measurements & Face (CALIB_FACE_*)
+ *	Output: CALIB_OK, CALIB_INVALID or CALIB_ERROR
+ */
+uint8_t Calib_Face(CALIB_FACES_t* faces, uint8_t face);
+
+/*
+ *	-------------------Calib_Faces_Solve------------------
+ *	Accelerometer offset and scale of every axis from its up and
+ *	down faces, the gyro bias is kept
+ *	Input: Face Measurements & Calibration
+ *	Output: CALIB_NEW, or CALIB_INVALID if a face is missing
+ */
+uint8_t Calib_Faces_Solve(const CALIB_FACES_t* faces, CALIB_t* calib);
+
+/*
+ *	-------------------Calib_Apply------------------
+ *	Correct processed readings (MPU6050_Process_Accel/Gyro)
+ *	Input: Calibration, Accel & Gyro (either can be 0)
+ *	Output: None
+ */
+void Calib_Apply(const CALIB_t* calib, MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance);
+
+#endif //CALIB_H_
@@ -0,0 +1,114 @@
+/*
+ * EEPROM.c
+ *
+ *	Main implementation of the TM4C123 EEPROM driver
+ *
+ */
+
+#include "EEPROM.h"
+#include "tm4c123gh6pm.h"
+
+static uint32_t EEPROM_Words;									//0 until EEPROM_Init succeeds
+
+/*
+ *	-------------------EEPROM_Wait------------------
+ *	Local function that waits for the current program/erase
+ *	Input: None
+ *	Output: EEDONE as it was when the EEPROM went idle
+ */
+static uint32_t EEPROM_Wait(void){
+	uint32_t done;
+
+	do{
+		done = EEPROM_EEDONE_R;
+	}while(done & EEPROM_EEDONE_WORKING);
+	return done;
+}
+
+/*
+ *	-------------------EEPROM_Init------------------
+ *	Clock the EEPROM, let it finish recovering from the last power
+ *	loss and reset it as the datasheet requires
+ *	Input: None
+ *	Output: EEPROM_OK, or EEPROM_ERROR if recovery failed
+ */
+uint8_t EEPROM_Init(void){
+
+	EEPROM_Words = 0;
+	SYSCTL_RCGCEEPROM_R |= EN_EEPROM_CLOCK;
+	while(!(SYSCTL_PREEPROM_R & EN_EEPROM_CLOCK));
+
+	//Power-on recovery of an interrupted program/erase
+	EEPROM_Wait();
+	if(EEPROM_EESUPP_R & EEPROM_EESUPP_RETRY)
+		return EEPROM_ERROR;
+
+	SYSCTL_SREEPROM_R |= EN_EEPROM_CLOCK;
+	SYSCTL_SREEPROM_R &= ~EN_EEPROM_CLOCK;
+	while(!(SYSCTL_PREEPROM_R & EN_EEPROM_CLOCK));
+
+	EEPROM_Wait();
+	if(EEPROM_EESUPP_R & EEPROM_EESUPP_RETRY)
+		return EEPROM_ERROR;
+
+	EEPROM_Words = EEPROM_EESIZE_R & EEPROM_EESIZE_WORDS;
+	return EEPROM_OK;
+}
+
+/*
+ *	-------------------EEPROM_Size------------------
+ *	Words in the part
+ *	Input: None
+ *	Output: Word count (0 before EEPROM_Init)
+ */
+uint32_t EEPROM_Size(void){
+	return EEPROM_Words;
+}
+
+/*
+ *	-------------------EEPROM_Read------------------
+ *	Read consecutive words
+ *	Input: First Word Address, Buffer & Word Count
+ *	Output: EEPROM_OK or EEPROM_INVALID
+ */
+uint8_t EEPROM_Read(uint32_t addr, uint32_t* data, uint32_t count){
+
+	if(count > EEPROM_Words || addr > EEPROM_Words - count)
+		return EEPROM_INVALID;
+
+	EEPROM_EEBLOCK_R = addr / EEPROM_BLOCK_WORDS;
+	EEPROM_EEOFFSET_R = addr % EEPROM_BLOCK_WORDS;
+	while(count--){
+		*data++ = EEPROM_EERDWRINC_R;
+
+		//EERDWRINC wraps within the block, the next block is selected by hand
+		if(++addr % EEPROM_BLOCK_WORDS == 0 && count)
+			EEPROM_EEBLOCK_R = addr / EEPROM_BLOCK_WORDS;
+	}
+	return EEPROM_OK;
+}
+
+/*
+ *	-------------------EEPROM_Write------------------
+ *	Program consecutive words, waiting for each one. Words that
+ *	already hold the value are skipped
+ *	Input: First Word Address, Data & Word Count
+ *	Output: EEPROM_OK, EEPROM_INVALID or EEPROM_ERROR
+ */
+uint8_t EEPROM_Write(uint32_t addr, const uint32_t* data, uint32_t count){
+
+	if(count > EEPROM_Words || addr > EEPROM_Words - count)
+		return EEPROM_INVALID;
+
+	for(; count; count--, addr++, data++){
+		EEPROM_EEBLOCK_R = addr / EEPROM_BLOCK_WORDS;
+		EEPROM_EEOFFSET_R = addr % EEPROM_BLOCK_WORDS;
+		if(EEPROM_EERDWR_R == *data)
+			continue;
+
+		EEPROM_EERDWR_R = *data;
+		if(EEPROM_Wait() & EEPROM_EEDONE_ERRORS)
+			return EEPROM_ERROR;
+	}
+	return EEPROM_OK;
+}
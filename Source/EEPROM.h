@@ -0,0 +1,65 @@
+/*
+ * EEPROM.h
+ *
+ *	Provides word access to the TM4C123 on-chip EEPROM: 2KB as 32
+ *	blocks of 16 words. Addresses are word addresses across the
+ *	whole part, a transfer may cross blocks. Writes skip words that
+ *	already hold the value, so rewriting the same data costs no
+ *	wear and no program time
+ *
+ *	Every access polls EEDONE, nothing here runs from an interrupt
+ *
+ */
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include <stdint.h>
+
+/* List of EEPROM Macros */
+#define EN_EEPROM_CLOCK				(0x01)			//RCGCEEPROM Bit
+#define EEPROM_BLOCK_WORDS		(16)
+#define EEPROM_EESIZE_WORDS		(0xFFFF)		//EESIZE word count field
+#define EEPROM_EEDONE_WORKING	(0x01)			//Program/erase in progress
+#define EEPROM_EEDONE_ERRORS	(0x3C)			//WRBUSY, NOPERM, WKCOPY, WKERASE
+#define EEPROM_EESUPP_RETRY		(0x0C)			//PRETRY, ERETRY: power loss interrupted a program/erase
+
+#define EEPROM_OK							(0)
+#define EEPROM_ERROR					(1)			//Retry failed or the write was refused
+#define EEPROM_INVALID				(2)			//Not initialized, or outside the part
+
+/*
+ *	-------------------EEPROM_Init------------------
+ *	Clock the EEPROM, let it finish recovering from the last power
+ *	loss and reset it as the datasheet requires
+ *	Input: None
+ *	Output: EEPROM_OK, or EEPROM_ERROR if recovery failed
+ */
+uint8_t EEPROM_Init(void);
+
+/*
+ *	-------------------EEPROM_Size------------------
+ *	Words in the part
+ *	Input: None
+ *	Output: Word count (0 before EEPROM_Init)
+ */
+uint32_t EEPROM_Size(void);
+
+/*
+ *	-------------------EEPROM_Read------------------
+ *	Read consecutive words
+ *	Input: First Word Address, Buffer & Word Count
+ *	Output: EEPROM_OK or EEPROM_INVALID
+ */
+uint8_t EEPROM_Read(uint32_t addr, uint32_t* data, uint32_t count);
+
+/*
+ *	-------------------EEPROM_Write------------------
+ *	Program consecutive words, waiting for each one. Words that
+ *	already hold the value are skipped
+ *	Input: First Word Address, Data & Word Count
+ *	Output: EEPROM_OK, EEPROM_INVALID or EEPROM_ERROR
+ */
+uint8_t EEPROM_Write(uint32_t addr, const uint32_t* data, uint32_t count);
+
+#endif //EEPROM_H_
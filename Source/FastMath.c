@@ -0,0 +1,178 @@
+/*
+ * FastMath.c
+ *
+ *	Main implementation of the approximate atan2, inverse square
+ *	root and hypot kernels
+ *
+ */
+
+#include "FastMath.h"
+#include <string.h>
+#include <math.h>
+
+/* atan(z) for 0 <= z <= 1, Abramowitz & Stegun 4.4.49: |error| <= 1e-5 rad (1.2e-5 in float) */
+#define ATAN_A1								(0.9998660f)
+#define ATAN_A3								(-0.3302995f)
+#define ATAN_A5								(0.1801410f)
+#define ATAN_A7								(-0.0851330f)
+#define ATAN_A9								(0.0208351f)
+
+/* Estimate of 1/sqrt(x) from the float bits, 1.75e-3 relative before the Newton steps */
+#define INV_SQRT_MAGIC				(0x5F375A86UL)
+
+/* atan(z) for 0 <= z <= 1 in millidegrees: 45z + z(1-z)(14.02 + 3.80z), |error| <= 0.09 degree */
+#define ATAN_Q_BITS						(15)
+#define ATAN_Q_ONE						(1L << ATAN_Q_BITS)
+#define ATAN_Q_45							(45000L)
+#define ATAN_Q_C1							(14021L)
+#define ATAN_Q_C2							(3799L)
+
+/*
+ *	---------------FastMath_Atan_Unit----------------
+ *	Local function, atan(z) on the first octant
+ *	Input: z (0..1)
+ *	Output: Angle in radians
+ */
+static float FastMath_Atan_Unit(float z){
+
+	float z2 = z*z;
+
+	return z*(ATAN_A1 + z2*(ATAN_A3 + z2*(ATAN_A5 + z2*(ATAN_A7 + z2*ATAN_A9))));
+}
+
+/*
+ *	-----------------FastMath_Atan2------------------
+ *	Angle of (x, y) from the x axis, single precision. Polynomial
+ *	on the octant (Abramowitz & Stegun 4.4.49) and one divide
+ *	Max Error: 1.2e-5 rad (0.0007 degree), atan2(0, 0) is 0
+ *	Input: y & x
+ *	Output: Angle in radians, -pi..pi
+ */
+float FastMath_Atan2(float y, float x){
+
+	float ax = fabsf(x);
+	float ay = fabsf(y);
+	float angle;
+
+	if(ax == 0.0f && ay == 0.0f)
+		return 0.0f;
+
+	//Fold into the first octant: the ratio stays within 0..1
+	if(ay <= ax)
+		angle = FastMath_Atan_Unit(ay / ax);
+	else
+		angle = FAST_MATH_HALF_PI - FastMath_Atan_Unit(ax / ay);
+
+	if(x < 0.0f)
+		angle = FAST_MATH_PI - angle;
+
+	return (y < 0.0f) ? -angle : angle;
+}
+
+/*
+ *	----------------FastMath_InvSqrt-----------------
+ *	1/sqrt(x), single precision: exponent halving estimate and two
+ *	Newton steps, no divide
+ *	Max Error: 5e-6 relative, for x > 0
+ *	Input: x (> 0)
+ *	Output: 1/sqrt(x)
+ */
+float FastMath_InvSqrt(float x){
+
+	float half = 0.5f*x;
+	float y;
+	uint32_t bits;
+
+	//memcpy keeps the bit reinterpretation well defined, it compiles to a register move
+	memcpy(&bits, &x, sizeof(bits));
+	bits = INV_SQRT_MAGIC - (bits >> 1);
+	memcpy(&y, &bits, sizeof(y));
+
+	y = y*(1.5f - half*y*y);
+	y = y*(1.5f - half*y*y);
+
+	return y;
+}
+
+/*
+ *	-----------------FastMath_Hypot------------------
+ *	sqrt(x*x + y*y), single precision, through FastMath_InvSqrt
+ *	Max Error: 5e-6 relative, hypot(0, 0) is 0
+ *	Input: x & y
+ *	Output: Length of (x, y)
+ */
+float FastMath_Hypot(float x, float y){
+
+	float sum = x*x + y*y;
+
+	if(sum == 0.0f)
+		return 0.0f;
+
+	return sum*FastMath_InvSqrt(sum);
+}
+
+/*
+ *	----------------FastMath_Atan2_Q-----------------
+ *	Angle of (x, y) from the x axis, integer only. Cubic on the
+ *	octant in millidegrees and one integer divide, suits raw counts
+ *	or milli-g directly
+ *	Max Error: 0.1 degree (100 mdeg), atan2(0, 0) is 0
+ *	Input: y & x (each within +-FAST_MATH_Q_MAX)
+ *	Output: Angle in millidegrees, -180000..180000
+ */
+int32_t FastMath_Atan2_Q(int32_t y, int32_t x){
+
+	uint32_t ax = (x < 0) ? -x : x;
+	uint32_t ay = (y < 0) ? -y : y;
+	uint32_t z;
+	uint32_t inner;
+	int32_t angle;
+
+	if(ax == 0 && ay == 0)
+		return 0;
+
+	//Octant ratio in Q15, both operands fit 32 bits for inputs within +-FAST_MATH_Q_MAX
+	z = (ay <= ax) ? (ay << ATAN_Q_BITS) / ax : (ax << ATAN_Q_BITS) / ay;
+
+	inner = ATAN_Q_C1 + ((ATAN_Q_C2*z) >> ATAN_Q_BITS);
+	inner = ((ATAN_Q_ONE - z)*inner) >> ATAN_Q_BITS;
+	angle = (int32_t)((z*(ATAN_Q_45 + inner) + (ATAN_Q_ONE >> 1)) >> ATAN_Q_BITS);
+
+	if(ay > ax)
+		angle = 2*ATAN_Q_45 - angle;
+	if(x < 0)
+		angle = 4*ATAN_Q_45 - angle;
+
+	return (y < 0) ? -angle : angle;
+}
+
+/*
+ *	----------------FastMath_Hypot_Q-----------------
+ *	sqrt(x*x + y*y), integer only: bit by bit square root, 16 steps
+ *	Max Error: 0.5 (exact, rounded to nearest)
+ *	Input: x & y (each within +-FAST_MATH_Q_MAX)
+ *	Output: Length of (x, y)
+ */
+uint32_t FastMath_Hypot_Q(int32_t x, int32_t y){
+
+	uint32_t rest = (uint32_t)(x*x) + (uint32_t)(y*y);
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+
+	while(bit > rest)
+		bit >>= 2;
+
+	while(bit){
+		if(rest >= root + bit){
+			rest -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	//rest is now sum - root^2, round up past (root + 0.5)^2
+	return (rest > root) ? root + 1 : root;
+}
@@ -0,0 +1,70 @@
+/*
+ * FastMath.h
+ *
+ *	Provides single precision and fixed point approximations of
+ *	atan2, inverse square root and hypot for the sensor hot path,
+ *	in place of the double precision libm calls. Each function
+ *	states its worst case error
+ *
+ */
+
+#ifndef FASTMATH_H_
+#define FASTMATH_H_
+
+#include <stdint.h>
+
+/* List of FastMath Macros */
+#define FAST_MATH_PI					(3.14159265f)
+#define FAST_MATH_HALF_PI			(1.57079633f)
+#define FAST_MATH_Q_MAX				(32768)			//Largest magnitude the fixed point functions take
+
+/*
+ *	-----------------FastMath_Atan2------------------
+ *	Angle of (x, y) from the x axis, single precision. Polynomial
+ *	on the octant (Abramowitz & Stegun 4.4.49) and one divide
+ *	Max Error: 1.2e-5 rad (0.0007 degree), atan2(0, 0) is 0
+ *	Input: y & x
+ *	Output: Angle in radians, -pi..pi
+ */
+float FastMath_Atan2(float y, float x);
+
+/*
+ *	----------------FastMath_InvSqrt-----------------
+ *	1/sqrt(x), single precision: exponent halving estimate and two
+ *	Newton steps, no divide
+ *	Max Error: 5e-6 relative, for x > 0
+ *	Input: x (> 0)
+ *	Output: 1/sqrt(x)
+ */
+float FastMath_InvSqrt(float x);
+
+/*
+ *	-----------------FastMath_Hypot------------------
+ *	sqrt(x*x + y*y), single precision, through FastMath_InvSqrt
+ *	Max Error: 5e-6 relative, hypot(0, 0) is 0
+ *	Input: x & y
+ *	Output: Length of (x, y)
+ */
+float FastMath_Hypot(float x, float y);
+
+/*
+ *	----------------FastMath_Atan2_Q-----------------
+ *	Angle of (x, y) from the x axis, integer only. Cubic on the
+ *	octant in millidegrees and one integer divide, suits raw counts
+ *	or milli-g directly
+ *	Max Error: 0.1 degree (100 mdeg), atan2(0, 0) is 0
+ *	Input: y & x (each within +-FAST_MATH_Q_MAX)
+ *	Output: Angle in millidegrees, -180000..180000
+ */
+int32_t FastMath_Atan2_Q(int32_t y, int32_t x);
+
+/*
+ *	----------------FastMath_Hypot_Q-----------------
+ *	sqrt(x*x + y*y), integer only: bit by bit square root, 16 steps
+ *	Max Error: 0.5 (exact, rounded to nearest)
+ *	Input: x & y (each within +-FAST_MATH_Q_MAX)
+ *	Output: Length of (x, y)
+ */
+uint32_t FastMath_Hypot_Q(int32_t x, int32_t y);
+
+#endif //FASTMATH_H_
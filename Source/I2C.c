@@ -7,7 +7,7 @@
  *		Author: Omar Fayoumi
  *
  */
- 
+
 #include "I2C.h"
 #include "tm4c123gh6pm.h"
 
@@ -16,258 +16,870 @@
 #define MCS_STOP_CMD  0x04
 #define MCS_RUN_CMD   0x01
 #define MCS_ACK_CMD   0x08
+#define MCS_HS_CMD    0x10
 #define I2C_CTRL_BUSY_BIT 0x20
 #define I2C_BSY_BIT 0x01
 #define MCS_ERROR_BIT 0x02
+#define MCS_ARBLST_BIT 0x10
+#define MCS_ADRACK_BIT 0x04
+#define MCS_DATACK_BIT 0x08
+#define MCS_CLKTO_BIT  0x80
+
+/* Module Register Offsets (from I2Cx_MSA_R) */
+#define I2C_MSA(bus)		((bus)->regs[0x000>>2])
+#define I2C_MCS(bus)		((bus)->regs[0x004>>2])
+#define I2C_MDR(bus)		((bus)->regs[0x008>>2])
+#define I2C_MTPR(bus)		((bus)->regs[0x00C>>2])
+#define I2C_MIMR(bus)		((bus)->regs[0x010>>2])
+#define I2C_MRIS(bus)		((bus)->regs[0x014>>2])
+#define I2C_MICR(bus)		((bus)->regs[0x01C>>2])
+#define I2C_MCR(bus)		((bus)->regs[0x020>>2])
+#define I2C_MCLKOCNT(bus)	((bus)->regs[0x024>>2])
+
+/* Transaction Engine Phases */
+typedef enum{
+	I2C_PHASE_MASTER_CODE,
+	I2C_PHASE_START,								//Segment transfer with nothing on the wire yet
+	I2C_PHASE_WRITE,
+	I2C_PHASE_READ
+} I2C_PHASE;
+
+/* Bus Handles */
+I2C_BUS_t I2C0_Bus = {
+	.regs = &I2C0_MSA_R,
+	.pins = {&GPIO_PORTB_DATA_R, &GPIO_PORTB_DIR_R, &GPIO_PORTB_AFSEL_R, &GPIO_PORTB_ODR_R, &GPIO_PORTB_DEN_R, &GPIO_PORTB_AMSEL_R, &GPIO_PORTB_PCTL_R,
+	 I2C0_SCL_PIN, I2C0_SDA_PIN, I2C0_ALT_FUNC_MSK, I2C0_ALT_FUNC_SET},
+	.i2c_clock = EN_I2C0_CLOCK,
+	.gpio_clock = EN_GPIOB_CLOCK,
+	.irq = I2C0_IRQ,
+	.speed = 0														//I2C_Submit refuses the bus until I2C_Init_Speed sets it
+};
+
+I2C_BUS_t I2C1_Bus = {
+	.regs = &I2C1_MSA_R,
+	.pins = {&GPIO_PORTA_DATA_R, &GPIO_PORTA_DIR_R, &GPIO_PORTA_AFSEL_R, &GPIO_PORTA_ODR_R, &GPIO_PORTA_DEN_R, &GPIO_PORTA_AMSEL_R, &GPIO_PORTA_PCTL_R,
+	 I2C1_SCL_PIN, I2C1_SDA_PIN, I2C1_ALT_FUNC_MSK, I2C1_ALT_FUNC_SET},
+	.i2c_clock = EN_I2C1_CLOCK,
+	.gpio_clock = EN_GPIOA_CLOCK,
+	.irq = I2C1_IRQ,
+	.speed = 0														//I2C_Submit refuses the bus until I2C_Init_Speed sets it
+};
+
+I2C_BUS_t I2C2_Bus = {
+	.regs = &I2C2_MSA_R,
+	.pins = {&GPIO_PORTE_DATA_R, &GPIO_PORTE_DIR_R, &GPIO_PORTE_AFSEL_R, &GPIO_PORTE_ODR_R, &GPIO_PORTE_DEN_R, &GPIO_PORTE_AMSEL_R, &GPIO_PORTE_PCTL_R,
+	 I2C2_SCL_PIN, I2C2_SDA_PIN, I2C2_ALT_FUNC_MSK, I2C2_ALT_FUNC_SET},
+	.i2c_clock = EN_I2C2_CLOCK,
+	.gpio_clock = EN_GPIOE_CLOCK,
+	.irq = I2C2_IRQ,
+	.speed = 0														//I2C_Submit refuses the bus until I2C_Init_Speed sets it
+};
+
+I2C_BUS_t I2C3_Bus = {
+	.regs = &I2C3_MSA_R,
+	.pins = {&GPIO_PORTD_DATA_R, &GPIO_PORTD_DIR_R, &GPIO_PORTD_AFSEL_R, &GPIO_PORTD_ODR_R, &GPIO_PORTD_DEN_R, &GPIO_PORTD_AMSEL_R, &GPIO_PORTD_PCTL_R,
+	 I2C3_SCL_PIN, I2C3_SDA_PIN, I2C3_ALT_FUNC_MSK, I2C3_ALT_FUNC_SET},
+	.i2c_clock = EN_I2C3_CLOCK,
+	.gpio_clock = EN_GPIOD_CLOCK,
+	.irq = I2C3_IRQ,
+	.speed = 0														//I2C_Submit refuses the bus until I2C_Init_Speed sets it
+};
 
 /*
- *	-------------------I2C0_Init------------------
- *	Basic I2C Initialization function for master mode @ 100kHz
- *	Input: None
+ *	-------------------I2C_Delay_US------------------
+ *	Local busy wait on the WTIMER1 timebase
+ *	Input: Delay in us
  *	Output: None
  */
-void I2C0_Init(void){
-	
-	/* Enable Required System Clock */
-	SYSCTL_RCGC1_R |= EN_I2C0_CLOCK;							//Enable I2C0 System Clock
-	SYSCTL_RCGC2_R |= EN_GPIOB_CLOCK;							//Enable GPIOB System Clock
-	
-	//Wait Until GPIOx System Clock is enabled
-	while((SYSCTL_RCGC2_R&EN_GPIOB_CLOCK)!= EN_GPIOB_CLOCK);
-	
+static void I2C_Delay_US(uint32_t us){
+	uint32_t start = TIMESTAMP_US();
+	while((TIMESTAMP_US() - start) < us);
+}
+
+/*
+ *	-------------------I2C_Error_Status------------------
+ *	Local function that turns the MCS error flags into a status
+ *	Input: MCS Register Value (Error Bit set)
+ *	Output: I2C_STATUS_ARBLST, CLKTO, ADRACK, DATACK or ERROR
+ */
+static uint8_t I2C_Error_Status(uint32_t mcs){
+	if(mcs&MCS_ARBLST_BIT)
+		return I2C_STATUS_ARBLST;
+	if(mcs&MCS_CLKTO_BIT)
+		return I2C_STATUS_CLKTO;
+	if(mcs&MCS_ADRACK_BIT)
+		return I2C_STATUS_ADRACK;
+	if(mcs&MCS_DATACK_BIT)
+		return I2C_STATUS_DATACK;
+	return I2C_STATUS_ERROR;
+}
+
+/*
+ *	-------------------I2C_Pins_Init------------------
+ *	Local function that hands SCL/SDA to the I2C module
+ *	Input: Bus Handle
+ *	Output: None
+ */
+static void I2C_Pins_Init(I2C_BUS_t* bus){
+
+	I2C_PINS_t* pins = &bus->pins;
+
 	/* GPIOx I2C Alternate Function Setup	*/
-	GPIO_PORTB_DEN_R	 |= I2C0_PINS;								//Enable Digital I/O
-	GPIO_PORTB_AFSEL_R |= I2C0_PINS;								//Enable Alternate Function Selection
-	
-	//Select I2C0 as the alternate function 
-	GPIO_PORTB_PCTL_R  |= (GPIO_PORTB_PCTL_R&I2C0_ALT_FUNC_MSK)+I2C0_ALT_FUNC_SET;
-	GPIO_PORTB_ODR_R	 |= I2C0_SDA_PIN;						  //Enable Open Drain for SDA pin
-	GPIO_PORTB_AMSEL_R &= ~I2C0_PINS;								//Disable Analog Mode
-	
-	/*	I2C0 Setup as Master Mode @ 100kBits	*/
-	I2C0_MCR_R |= EN_I2C0_MASTER;									//Configure I2C0 as Master 
-	
-	/* Configuring I2C Clock Frequency to 100KHz
-		
+	*pins->DEN	 |= pins->scl_pin|pins->sda_pin;			//Enable Digital I/O
+	*pins->AFSEL |= pins->scl_pin|pins->sda_pin;			//Enable Alternate Function Selection
+
+	//Select I2C as the alternate function
+	*pins->PCTL  = (*pins->PCTL&~pins->alt_func_msk)|pins->alt_func_set;
+	*pins->ODR	 |= pins->sda_pin;										//Enable Open Drain for SDA pin
+	*pins->AMSEL &= ~(pins->scl_pin|pins->sda_pin);		//Disable Analog Mode
+}
+
+/*
+ *	-------------------I2C_Master_Init------------------
+ *	Local function that sets up the module as master with its
+ *	timer period, clock low timeout and interrupts
+ *	Input: Bus Handle & MTPR Value
+ *	Output: None
+ */
+static void I2C_Master_Init(I2C_BUS_t* bus, uint32_t mtpr){
+	I2C_MCR(bus) |= EN_I2C_MASTER;										//Configure I2Cx as Master
+	I2C_MTPR(bus) = mtpr;
+	I2C_MCLKOCNT(bus) = I2C_MCLKOCNT_CNTL;						//Raise CLKTO if a slave stretches SCL forever
+
+	/* Interrupt Setup: every finished MCS command and a clock timeout raise the master interrupt */
+	I2C_MICR(bus) = I2C_MICR_IC|I2C_MICR_CLKIC;				//Clear any stale interrupt
+	I2C_MIMR(bus) |= I2C_MIMR_IM|I2C_MIMR_CLKIM;			//Arm the master interrupts
+}
+
+/*
+ *	-------------------I2C_Seg_Seek------------------
+ *	Local function that moves a segment cursor past empty segments
+ *	Input: Transaction Descriptor, Segment Index & Byte Position
+ *	Output: None (index is seg_count once the list is used up)
+ */
+static void I2C_Seg_Seek(I2C_TRANSACTION_t* transaction, uint32_t* index, uint32_t* pos){
+	while(*index < transaction->seg_count && *pos >= transaction->segments[*index].len){
+		(*index)++;
+		*pos = 0;
+	}
+}
+
+/*
+ *	-------------------I2C_Seg_Restart------------------
+ *	Local function that checks if the byte at a segment cursor
+ *	needs a (repeated) START in front of it
+ *	Input: Transaction Descriptor, Segment Index, Byte Position & Direction of the byte before (1 = read)
+ *	Output: 1 if a START goes first, otherwise 0
+ */
+static uint8_t I2C_Seg_Restart(I2C_TRANSACTION_t* transaction, uint32_t index, uint32_t pos, uint8_t prev_read){
+	uint8_t flags = transaction->segments[index].flags;
+
+	if(pos != 0)
+		return 0;
+	return (flags&I2C_SEG_RESTART) || (((flags&I2C_SEG_READ) != 0) != prev_read);
+}
+
+/*
+ *	-------------------I2C_Seg_Issue------------------
+ *	Local function that puts the byte at the segment cursor on the
+ *	wire: START + address when needed, STOP on the last byte, and a
+ *	read is ACKed only if the next byte continues the same read
+ *	Input: Bus Handle & Transaction Descriptor
+ *	Output: None
+ */
+static void I2C_Seg_Issue(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction){
+
+	const I2C_SEGMENT_t* seg = &transaction->segments[bus->seg_index];
+	uint8_t read = (seg->flags&I2C_SEG_READ) ? 1 : 0;
+	uint32_t next_index = bus->seg_index;
+	uint32_t next_pos = bus->seg_pos + 1;
+	uint32_t cmd = MCS_RUN_CMD;
+
+	if(bus->phase == I2C_PHASE_START || I2C_Seg_Restart(transaction, bus->seg_index, bus->seg_pos, bus->phase == I2C_PHASE_READ)){
+		I2C_MSA(bus) = (transaction->slave_addr << I2C_RW_PIN) + (read ? I2C_RW_PIN : 0);
+		cmd |= MCS_START_CMD;
+		bus->tx_index++;
+	}
+	if(!read)
+		I2C_MDR(bus) = seg->buf[bus->seg_pos];
+	bus->tx_index++;
+	bus->phase = read ? I2C_PHASE_READ : I2C_PHASE_WRITE;
+
+	I2C_Seg_Seek(transaction, &next_index, &next_pos);
+	if(next_index == transaction->seg_count)
+		cmd |= MCS_STOP_CMD;
+	else if(read && !I2C_Seg_Restart(transaction, next_index, next_pos, 1))
+		cmd |= MCS_ACK_CMD;
+
+	I2C_MCS(bus) = cmd;
+}
+
+/*
+ *	-------------------I2C_Seg_Bytes------------------
+ *	Local function that adds up the data bytes of a segment list
+ *	Input: Transaction Descriptor
+ *	Output: Number of data bytes
+ */
+static uint32_t I2C_Seg_Bytes(I2C_TRANSACTION_t* transaction){
+	uint32_t bytes = 0;
+	uint32_t i;
+
+	for(i = 0; i < transaction->seg_count; i++)
+		bytes += transaction->segments[i].len;
+	return bytes;
+}
+
+/*
+ *	-------------------I2C_Start_Address------------------
+ *	Local function that sends START + slave address in write mode
+ *	with the slave register address as the first data byte (or the
+ *	first byte of a segment transfer)
+ *	Input: Bus Handle & Transaction Descriptor
+ *	Output: None
+ */
+static void I2C_Start_Address(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction){
+
+	if(transaction->segments){
+		I2C_Seg_Issue(bus, transaction);
+		return;
+	}
+
+	/* Configure Slave Address in Write Mode and the Register to access */
+	I2C_MSA(bus) = (transaction->slave_addr << 1);
+	I2C_MDR(bus) = transaction->slave_reg_addr;
+
+	/* A register write with nothing following it ends right away */
+	if(transaction->tx_size == 0 && transaction->rx_size == 0)
+		I2C_MCS(bus) = MCS_START_CMD|MCS_RUN_CMD|MCS_STOP_CMD;
+	else
+		I2C_MCS(bus) = MCS_START_CMD|MCS_RUN_CMD;
+}
+
+/*
+ *	-------------------I2C_Start_Transaction------------------
+ *	Local function that loads the address phase of a transaction
+ *	and kicks off the MCS state machine. Called inside a critical
+ *	section or from the ISR itself
+ *	Input: Bus Handle & Transaction Descriptor
+ *	Output: None
+ */
+static void I2C_Start_Transaction(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction){
+
+	uint32_t bits;
+
+	bus->current = transaction;
+	bus->phase = transaction->segments ? I2C_PHASE_START : I2C_PHASE_WRITE;
+	bus->stopping = 0;
+	bus->tx_index = 0;
+	bus->seg_index = bus->seg_pos = 0;
+	transaction->rx_count = 0;
+	if(transaction->segments)
+		I2C_Seg_Seek(transaction, &bus->seg_index, &bus->seg_pos);
+
+	/* No waiting for BUSBSY here (this runs in the ISR or a critical section): the master
+	   holds its START until the bus is free, and a bus that never frees up runs the
+	   transaction over its budget, so I2C_Check_Timeout recovers it. The previous
+	   transaction's STOP is always out by now, even after an error */
+	I2C_MICR(bus) = I2C_MICR_IC;										//Drop the STOP's own interrupt
+
+	/* Time Budget: twice the wire time (9 bits per byte) plus a margin for clock stretching */
+	if(transaction->segments)
+		bits = 9*(I2C_Seg_Bytes(transaction) + transaction->seg_count) + 2;		//Worst case: an address in front of every segment
+	else
+		bits = 9*(2 + transaction->tx_size + (transaction->rx_size ? 1 + transaction->rx_size : 0)) + 2;
+	bus->budget_us = 2*bits*((1000000 + bus->speed - 1)/bus->speed) + I2C_TIMEOUT_MARGIN_US;
+	bus->start_us = TIMESTAMP_US();
+
+	/* High-Speed: master code goes out at Fast speed first, address phase follows from the ISR */
+	if(bus->hs_mode){
+		bus->phase = I2C_PHASE_MASTER_CODE;
+		I2C_MSA(bus) = I2C_HS_MASTER_CODE;
+		I2C_MCS(bus) = MCS_HS_CMD|MCS_START_CMD|MCS_RUN_CMD;
+		return;
+	}
+
+	I2C_Start_Address(bus, transaction);
+}
+
+/*
+ *	-------------------I2C_Start_Next------------------
+ *	Local function that pops the next queued transaction (if any)
+ *	and starts it
+ *	Input: Bus Handle
+ *	Output: None
+ */
+static void I2C_Start_Next(I2C_BUS_t* bus){
+	I2C_TRANSACTION_t* next;
+
+	if(bus->queue_count == 0){
+		bus->current = 0;
+		return;
+	}
+
+	next = bus->queue[bus->queue_tail];
+	bus->queue_tail = (bus->queue_tail + 1) % I2C_QUEUE_SIZE;
+	bus->queue_count--;
+
+	I2C_Start_Transaction(bus, next);
+}
+
+/*
+ *	-------------------I2C_Retire------------------
+ *	Local function to complete the current transaction and move
+ *	on to the next one, without notifying the owner
+ *	Input: Bus Handle & Status to report
+ *	Output: Owner's callback, for the caller to run (can be 0)
+ */
+static I2C_CALLBACK_t I2C_Retire(I2C_BUS_t* bus, uint8_t status){
+	I2C_TRANSACTION_t* finished = bus->current;
+	I2C_CALLBACK_t callback = finished->callback;
+
+	I2C_STATS_FINISH(bus, finished, status, finished->segments ? bus->tx_index : 2 + bus->tx_index + (bus->phase == I2C_PHASE_READ ? 1 + finished->rx_count : 0));
+
+	//Owner may reuse the descriptor as soon as done is set
+	finished->status = status;
+	finished->done = 1;
+
+	I2C_Start_Next(bus);
+
+	return callback;
+}
+
+/*
+ *	-------------------I2C_Finish------------------
+ *	Local function to complete the current transaction, notify
+ *	the owner, and move on to the next one
+ *	Input: Bus Handle & Status to report
+ *	Output: None
+ */
+static void I2C_Finish(I2C_BUS_t* bus, uint8_t status){
+	I2C_TRANSACTION_t* finished = bus->current;
+	I2C_CALLBACK_t callback = I2C_Retire(bus, status);
+
+	if(callback)
+		callback(finished);
+}
+
+/*
+ *	-------------------I2C_Submit_Blocking------------------
+ *	Local function used by the blocking calls: submit, and if the
+ *	queue is full keep trying while the bus keeps its timeouts
+ *	Input: Bus Handle & Transaction Descriptor
+ *	Output: None
+ */
+static void I2C_Submit_Blocking(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction){
+
+	if(I2C_Submit(bus, transaction) != I2C_STATUS_QUEUE_FULL)
+		return;
+
+	I2C_STATS_RETRY(bus);
+	while(I2C_Submit(bus, transaction) == I2C_STATUS_QUEUE_FULL)
+		I2C_Check_Timeout(bus);
+}
+
+/*
+ *	-------------------I2C_Init------------------
+ *	Basic I2C Initialization function for master mode @ 100kHz
+ *	Input: Bus Handle
+ *	Output: None
+ */
+void I2C_Init(I2C_BUS_t* bus){
+	I2C_Init_Speed(bus, I2C_SPEED_STANDARD, SYS_CLOCK_HZ);
+}
+
+/*
+ *	-----------------I2C_Init_Speed----------------
+ *	I2C Initialization function for master mode at a chosen SCL
+ *	rate. Rates above 1MHz use High-Speed mode (master code is
+ *	sent in front of every transaction). WTIMER1_Init has to run
+ *	first, every wait on the bus is timed with it
+ *	Input: Bus Handle, SCL Frequency (Hz) & System Clock (Hz)
+ *	Output: I2C_STATUS_OK, or I2C_STATUS_INVALID if the rate can't
+ *					be reached from this system clock (nothing is configured)
+ */
+uint8_t I2C_Init_Speed(I2C_BUS_t* bus, uint32_t scl_hz, uint32_t sys_clock_hz){
+
+	uint32_t scl_lp_hp;
+	uint32_t tpr;
+
+	/* Configuring I2C Clock Frequency
+
 		TPR = (System Clock / (2*(SCL_LP + SCL_HP) * SCL_CLK)) - 1
 		SCL_LP and SCL_HP are fixed
-		SCL_LP = 6 & SCL_HP = 4
-		
-		Example if we want to configure I2C speed to 100kHz for 40MHz system clock
+		SCL_LP = 6 & SCL_HP = 4 (Standard, Fast, Fast-mode Plus)
+		SCL_LP = 2 & SCL_HP = 1 (High-Speed)
+
+		Example if we want to configure I2C speed to 100kHz for 16MHz system clock
 		TPR = (16,000,000Hz / ((2*(6+4)) * 100,000Hz)) - 1 		(Convert Everything to Hz)
 		TPR = 7
-		
+
+		Division is rounded up so SCL never runs faster than asked. TPR
+		has to land in 1-127, which rules out e.g. 1MHz or High-Speed
+		on the default 16MHz clock
 	*/
-	
-	// take care of master timer period: standard speed and TPR value	
-	I2C0_MTPR_R = (I2C0_MTPR_R&~(0xFF))|I2C_MTPR_TPR_VALUE|I2C_MTPR_STD_SPEED;
 
+	/* Asserting Param */
+	if(scl_hz == 0 || scl_hz > I2C_SPEED_HIGH || sys_clock_hz == 0)
+		return I2C_STATUS_INVALID;
+
+	scl_lp_hp = (scl_hz > I2C_SPEED_FAST_PLUS) ? I2C_HS_SCL_LP_HP : I2C_SCL_LP_HP;
+	tpr = (sys_clock_hz + (2*scl_lp_hp*scl_hz) - 1) / (2*scl_lp_hp*scl_hz);
+	if(tpr < 2 || (tpr - 1) > I2C_MTPR_TPR_MAX)
+		return I2C_STATUS_INVALID;
+	tpr = tpr - 1;
+
+	/* Enable Required System Clock */
+	SYSCTL_RCGCI2C_R |= bus->i2c_clock;							//Enable I2Cx System Clock
+	SYSCTL_RCGCGPIO_R |= bus->gpio_clock;						//Enable GPIOx System Clock
+
+	//Wait Until GPIOx and I2Cx System Clock are enabled
+	while((SYSCTL_PRGPIO_R&bus->gpio_clock) != bus->gpio_clock);
+	while((SYSCTL_PRI2C_R&bus->i2c_clock) != bus->i2c_clock);
+
+	/* GPIOx I2C Alternate Function Setup	*/
+	I2C_Pins_Init(bus);
+
+	/* Reset the Transaction Engine */
+	bus->queue_head = bus->queue_tail = bus->queue_count = 0;
+	bus->current = 0;
+	bus->fault = bus->recovering = 0;
+	I2C_STATS_RESET(bus);
+
+	/*	I2Cx Setup as Master Mode, take care of master timer period: speed mode and TPR value	*/
+	bus->hs_mode = (scl_hz > I2C_SPEED_FAST_PLUS);
+	bus->speed = sys_clock_hz / (2*scl_lp_hp*(tpr + 1));
+	I2C_Master_Init(bus, (I2C_MTPR(bus)&~(0xFF))|tpr|(bus->hs_mode ? I2C_MTPR_HS_SPEED : I2C_MTPR_STD_SPEED));
+
+	((volatile uint8_t*)&NVIC_PRI0_R)[bus->irq] = I2C_INT_PRIORITY << 5;		//One priority byte per interrupt
+	(&NVIC_EN0_R)[bus->irq/32] = 1U << (bus->irq%32);											//Enable interrupt in NVIC
+
+	return I2C_STATUS_OK;
 }
 
 /*
- *	-------------------I2C0_Receive------------------
- *	Polls to receive data from specified peripheral
- *	Input: Slave address & Slave Register Address
- *	Output: Returns 8-bit data that has been received
+ *	-------------------I2C_Submit------------------
+ *	Queue a transaction to be run by the bus interrupt. Returns
+ *	right away, completion is reported through the done flag and
+ *	the optional callback
+ *	Input: Bus Handle & Transaction Descriptor
+ *	Output: I2C_STATUS_OK if queued, I2C_STATUS_QUEUE_FULL otherwise,
+ *					I2C_STATUS_INVALID for a segment list without any bytes
+ *					or a bus that was never initialized (the transaction is
+ *					done right away)
  */
-uint8_t I2C0_Receive(uint8_t slave_addr, uint8_t slave_reg_addr){
-	
-	char error;																	//Temp Variable to hold errors
-	
-	/* Check if I2C0 is busy: check MCS register Busy bit */
-	while(I2C_BSY_BIT&I2C0_MCS_R);
-	
-	/* Configure I2C0 Slave Address and Read Mode */
-	I2C0_MSA_R = (slave_addr << 1);								// Slave Address is the 7 MSB
-	I2C0_MDR_R = slave_reg_addr;								// Set Data Register to slave register address
-	
-	/* Initiate I2C by generating a START & RUN cmd:
-	   Set MCS register START bit to generate and RUN bit to enable I2C Master
-	*/
-	I2C0_MCS_R = MCS_START_CMD|MCS_RUN_CMD;
-	
-	/* Wait until write is done: check MCS register to see is I2C is still busy */
-	while(I2C_BSY_BIT&I2C0_MCS_R); //I2C_CTRL_BUSY_BIT is 1 when idle
-	
-	/* Set I2C to Receive with Slave Address and change to Read */
-	I2C0_MSA_R = (slave_addr << I2C0_RW_PIN) + I2C0_RW_PIN;
-	
-	/* Initiate I2C by generating a repeated START, STOP, & RUN cmd */
-	I2C0_MCS_R = MCS_START_CMD|MCS_RUN_CMD|MCS_STOP_CMD;
-	
-	/* Wait until I2C bus is not busy: check MCS register for I2C bus busy bit */
-	while(I2C_BUS_BUSY_BIT&I2C0_MCS_R);
-	
-	/* Check for any error: read the error flag from MCS register */
-	error = I2C0_MCS_R & MCS_ERROR_BIT;
-	if(error != 0)
-		return error;
-  else
-		return (I2C0_MDR_R & 0xFF);  // return I2C data register least significant 8 bits.
-	
+uint8_t I2C_Submit(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction){
+
+	uint8_t ret = I2C_STATUS_OK;
+	uint32_t state;
+
+	/* Asserting Param: no time budget without a bus speed, and the engine can't put an address on the wire with no byte after it */
+	if(bus->speed == 0 || (transaction->segments && I2C_Seg_Bytes(transaction) == 0)){
+		transaction->status = I2C_STATUS_INVALID;
+		transaction->done = 1;
+		return I2C_STATUS_INVALID;
+	}
+
+	transaction->status = I2C_STATUS_PENDING;
+	transaction->done = 0;
+	I2C_STATS_SUBMIT(transaction);
+
+	/* Keep the bus ISR and other submitting ISRs out while the queue is being touched */
+	state = START_CRITICAL();
+
+	if(bus->current == 0){
+		I2C_Start_Transaction(bus, transaction);
+	}
+	else if(bus->queue_count < I2C_QUEUE_SIZE){
+		bus->queue[bus->queue_head] = transaction;
+		bus->queue_head = (bus->queue_head + 1) % I2C_QUEUE_SIZE;
+		bus->queue_count++;
+	}
+	else{
+		ret = I2C_STATUS_QUEUE_FULL;
+	}
+
+	END_CRITICAL(state);
+
+	return ret;
 }
 
 /*
- *	-------------------I2C0_Transmit------------------
- *	Transmit a byte of data to specified peripheral
- *	Input: Slave address, Slave Register Address, Data to Transmit
- *	Output: Any Errors if detected, otherwise 0
+ *	-------------------I2C_Wait------------------
+ *	Wait until a submitted transaction has finished. Never hangs:
+ *	a transaction stuck on the wire is aborted once it runs over
+ *	its time budget
+ *	Input: Bus Handle & Transaction Descriptor
+ *	Output: Transaction Status
  */
-uint8_t I2C0_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data){
-	
-	char error;																	//Temp Variable to hold errors
-	
-	/* Check if I2C0 is busy: check MCS register Busy bit */
-	while(I2C_BSY_BIT&I2C0_MCS_R);
-	
-	/* Configure I2C Slave Address, R/W Mode, and what to transmit */
-	I2C0_MSA_R = slave_addr << 1;								//Slave Address is the first 7 MSB
-	I2C0_MSA_R &= ~I2C0_RW_PIN; 						// Clear LSB to write
-	I2C0_MDR_R = slave_reg_addr;								//Transmit register addr to interact
-	
-	/* Initiate I2C by generate a START bit and RUN cmd */
-	I2C0_MCS_R = MCS_START_CMD|MCS_RUN_CMD;
-	
-	/* Wait until write has been completed */
-	while(I2C_BSY_BIT&I2C0_MCS_R);
-	
-	/* Update Data Register with data to be transmitted */
-	I2C0_MDR_R = data; 
-	
-	/* Initiate I2C by generating a STOP & RUN cmd */
-	I2C0_MCS_R = MCS_RUN_CMD|MCS_STOP_CMD;
-	
-	/* Wait until write has been completed: check MCS register Busy bit */
-	while(I2C_BSY_BIT&I2C0_MCS_R);
-	
-	/* Wait until bus isn't busy: check MCS register for I2C bus busy bit */
-	while(I2C_BUS_BUSY_BIT&I2C0_MCS_R);
-	
-	/* Check for any error: read the error flag from MCS register */
-	error = I2C0_MCS_R&MCS_ERROR_BIT;
-	if(error != 0)
-		return error;
-  else
-		return 0;
+uint8_t I2C_Wait(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction){
+	while(!transaction->done)
+		I2C_Check_Timeout(bus);
+	return transaction->status;
 }
 
-//Has Yet to be Implemented
 /*
- *	----------------I2C0_Burst_Receive-----------------
- *	Polls to receive multiple bytes of data from specified
- *  peripheral by incrementing starting slave register address
- *	Input: Slave address, Slave Register Address, Data Buffer
+ *	---------------I2C_Check_Timeout----------------
+ *	Abort the transaction on the wire if it ran over its time
+ *	budget or a slave held SCL past the clock low timeout: the bus
+ *	is recovered and the transaction finishes with I2C_STATUS_TIMEOUT
+ *	or I2C_STATUS_CLKTO. Recovery runs here with interrupts on, never
+ *	in the bus ISR, so call this from any loop that waits on the bus
+ *	(not from an ISR). The aborted transaction's callback runs here
+ *	too, once interrupts are back on
+ *	Input: Bus Handle
  *	Output: None
  */
-void I2C0_Burst_Receive(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size){
-	uint32_t counter = 0;
-	char error;																	//Temp Variable to hold errors
-	
-	/* Check if I2C0 is busy: check MCS register Busy bit */
-	while(I2C_BSY_BIT&I2C0_MCS_R);
-	
-	/* Configure I2C0 Slave Address and Read Mode */
-	I2C0_MSA_R = (slave_addr << 1);								// Slave Address is the 7 MSB
-	I2C0_MDR_R = slave_reg_addr;								// Set Data Register to slave register address
-	
-	/* Initiate I2C by generating a START & RUN cmd:
-	   Set MCS register START bit to generate and RUN bit to enable I2C Master
-	*/
-	I2C0_MCS_R = MCS_START_CMD|MCS_RUN_CMD;
-	
-	/* Wait until write is done: check MCS register to see is I2C is still busy */
-	while((I2C_CTRL_BUSY_BIT&I2C0_MCS_R) != I2C_CTRL_BUSY_BIT); //I2C_CTRL_BUSY_BIT is 1 when idle
-	for(counter = 0; counter < size - 1; counter++){
-		/* Set I2C to Receive with Slave Address and change to Read */
-		I2C0_MSA_R = (slave_addr << I2C0_RW_PIN) + I2C0_RW_PIN;
-		
-		/* Initiate I2C by generating a repeated START, STOP, & RUN cmd */
-		I2C0_MCS_R = MCS_START_CMD|MCS_RUN_CMD;
-		
-		/* Wait until I2C bus is not busy: check MCS register for I2C bus busy bit */
-		while(I2C_BUS_BUSY_BIT&I2C0_MCS_R);
-		
-		/* Check for any error: read the error flag from MCS register */
-		error = I2C0_MCS_R & MCS_ERROR_BIT;
-		if(error){
-			data[counter] = 0x00;// if there was an error set data to 0;
+void I2C_Check_Timeout(I2C_BUS_t* bus){
+
+	I2C_TRANSACTION_t* finished;
+	I2C_CALLBACK_t callback;
+	uint32_t state;
+	uint8_t expired;
+	uint8_t status;
+
+	/* Claim the stuck transaction, from here on the ISR leaves the bus alone */
+	state = START_CRITICAL();
+	expired = (bus->current != 0 && !bus->recovering &&
+		(bus->fault || (TIMESTAMP_US() - bus->start_us) > bus->budget_us));
+	if(expired)
+		bus->recovering = 1;
+	END_CRITICAL(state);
+
+	if(!expired)
+		return;
+
+	I2C_Recover(bus);
+
+	state = START_CRITICAL();
+	status = bus->fault ? bus->fault : I2C_STATUS_TIMEOUT;
+	bus->fault = bus->recovering = 0;
+	finished = bus->current;
+	callback = I2C_Retire(bus, status);
+	END_CRITICAL(state);
+
+	//Owner is told once interrupts are back on
+	if(callback)
+		callback(finished);
+}
+
+/*
+ *	-----------------I2C_Recover------------------
+ *	Free a bus held by a slave stuck mid-byte: pins go to GPIO,
+ *	SCL is pulsed 9 times, a STOP is bit banged, then the module is
+ *	reset and handed back its pins and settings. Queued transactions
+ *	are kept. Takes about 100us with interrupts on, so call it from
+ *	thread level on an idle bus (I2C_Check_Timeout does it for a
+ *	stuck transaction)
+ *	Input: Bus Handle
+ *	Output: I2C_STATUS_OK if SDA is released, otherwise I2C_STATUS_ERROR
+ */
+uint8_t I2C_Recover(I2C_BUS_t* bus){
+
+	I2C_PINS_t* pins = &bus->pins;
+	uint32_t mtpr = I2C_MTPR(bus);
+	uint8_t ret;
+	uint8_t i;
+
+	I2C_MIMR(bus) = 0;																//No bus interrupts until the module is set up again
+	I2C_STATS_RECOVERY(bus);
+
+	/* Take the pins back as GPIO: SCL open drain output (released), SDA input */
+	*pins->DATA	 |= pins->scl_pin|pins->sda_pin;
+	*pins->ODR	 |= pins->scl_pin|pins->sda_pin;
+	*pins->DIR	 = (*pins->DIR|pins->scl_pin)&~pins->sda_pin;
+	*pins->AFSEL &= ~(pins->scl_pin|pins->sda_pin);
+
+	/* Clock out whatever is left of the byte the slave is stuck in */
+	for(i = 0; i < I2C_RECOVERY_PULSES; i++){
+		*pins->DATA &= ~pins->scl_pin;
+		I2C_Delay_US(I2C_RECOVERY_HALF_US);
+		*pins->DATA |= pins->scl_pin;
+		I2C_Delay_US(I2C_RECOVERY_HALF_US);
+	}
+
+	/* STOP: SDA low while SCL is low, then SDA rises while SCL is high */
+	*pins->DATA &= ~(pins->scl_pin|pins->sda_pin);
+	*pins->DIR	|= pins->sda_pin;
+	I2C_Delay_US(I2C_RECOVERY_HALF_US);
+	*pins->DATA |= pins->scl_pin;
+	I2C_Delay_US(I2C_RECOVERY_HALF_US);
+	*pins->DIR	&= ~pins->sda_pin;
+	I2C_Delay_US(I2C_RECOVERY_HALF_US);
+
+	ret = (*pins->DATA&pins->sda_pin) ? I2C_STATUS_OK : I2C_STATUS_ERROR;
+
+	/* Reset the module, then hand back its pins and settings */
+	SYSCTL_SRI2C_R |= bus->i2c_clock;
+	SYSCTL_SRI2C_R &= ~bus->i2c_clock;
+	while((SYSCTL_PRI2C_R&bus->i2c_clock) != bus->i2c_clock);
+
+	*pins->DIR &= ~(pins->scl_pin|pins->sda_pin);
+	*pins->ODR &= ~pins->scl_pin;
+	I2C_Pins_Init(bus);
+	I2C_Master_Init(bus, mtpr);
+
+	return ret;
+}
+
+/*
+ *	-------------------I2C_Is_Idle------------------
+ *	Check if the bus has nothing left to run
+ *	Input: Bus Handle
+ *	Output: 1 if idle, otherwise 0
+ */
+uint8_t I2C_Is_Idle(I2C_BUS_t* bus){
+	return (bus->current == 0);
+}
+
+/*
+ *	-------------------I2C_Handler------------------
+ *	Shared master interrupt body. Runs once per finished MCS
+ *	command and issues the next command of the current transaction
+ *	Input: Bus Handle
+ *	Output: None
+ */
+static void I2C_Handler(I2C_BUS_t* bus){
+
+	I2C_TRANSACTION_t* t = bus->current;
+	uint32_t ris;
+	uint32_t mcs;
+	uint32_t remaining;
+	uint8_t status;
+
+	/* Ignore a stale request left pending in the NVIC */
+	ris = I2C_MRIS(bus);
+	if(!(ris&(I2C_MICR_IC|I2C_MICR_CLKIC)))
+		return;
+	I2C_MICR(bus) = I2C_MICR_IC|I2C_MICR_CLKIC;					//Acknowledge Interrupt
+
+	//Nothing to do, or I2C_Check_Timeout has the bus
+	if(t == 0 || bus->fault || bus->recovering)
+		return;
+
+	/* A slave held SCL low past the clock low timeout: the bit banged recovery is too long for the ISR */
+	if(ris&I2C_MICR_CLKIC){
+		bus->fault = I2C_STATUS_CLKTO;
+		return;
+	}
+
+	/* The STOP after an error is out, the bus takes the next command now */
+	if(bus->stopping){
+		I2C_Finish(bus, t->status);
+		return;
+	}
+
+	/* Master code is never acknowledged, move on to the address at High-Speed */
+	if(bus->phase == I2C_PHASE_MASTER_CODE){
+		bus->phase = t->segments ? I2C_PHASE_START : I2C_PHASE_WRITE;
+		I2C_Start_Address(bus, t);
+		return;
+	}
+
+	/* Check for any error: read the error flag from MCS register */
+	mcs = I2C_MCS(bus);
+	if(mcs&MCS_ERROR_BIT){
+		status = I2C_Error_Status(mcs);
+
+		//A stuck clock needs a full recovery, left to I2C_Check_Timeout
+		if(status == I2C_STATUS_CLKTO){
+			bus->fault = status;
+			return;
 		}
-		else{
-			data[counter] = (I2C0_MDR_R & 0xFF);
+
+		//Lost to another master: nothing of ours left on the wire
+		if(status == I2C_STATUS_ARBLST){
+			I2C_Finish(bus, status);
+			return;
 		}
+
+		//Release the bus, the STOP's own interrupt finishes the transaction (status is held until done is set)
+		t->status = status;
+		bus->stopping = 1;
+		I2C_MCS(bus) = MCS_STOP_CMD;
+		return;
 	}
-	/* Set I2C to Receive with Slave Address and change to Read */
-	I2C0_MSA_R = (slave_addr << I2C0_RW_PIN) + I2C0_RW_PIN;
-		
-	/* Initiate I2C by generating a repeated START, STOP, & RUN cmd */
-	I2C0_MCS_R = MCS_START_CMD|MCS_RUN_CMD|MCS_STOP_CMD;
-		
-	/* Wait until I2C bus is not busy: check MCS register for I2C bus busy bit */
-	while(I2C_BUS_BUSY_BIT&I2C0_MCS_R);
-		
-	/* Check for any error: read the error flag from MCS register */
-	error = I2C0_MCS_R & MCS_ERROR_BIT;
-	if(error){
-		data[counter] = 0x00;// if there was an error set data to 0;
+
+	/* Segment Transfer: store a read byte, then step to the next byte (its STOP is already out after the last) */
+	if(t->segments){
+		if(bus->phase == I2C_PHASE_READ){
+			t->segments[bus->seg_index].buf[bus->seg_pos] = (I2C_MDR(bus) & 0xFF);
+			t->rx_count++;
+		}
+		bus->seg_pos++;
+		I2C_Seg_Seek(t, &bus->seg_index, &bus->seg_pos);
+		if(bus->seg_index == t->seg_count)
+			I2C_Finish(bus, I2C_STATUS_OK);
+		else
+			I2C_Seg_Issue(bus, t);
+		return;
 	}
-	else{
-		data[counter] = (I2C0_MDR_R & 0xFF);
+
+	if(bus->phase == I2C_PHASE_WRITE){
+
+		/* Keep feeding data bytes, STOP on the last one if nothing is read after */
+		if(bus->tx_index < t->tx_size){
+			I2C_MDR(bus) = t->tx_data[bus->tx_index++];
+			if(bus->tx_index == t->tx_size && t->rx_size == 0)
+				I2C_MCS(bus) = MCS_RUN_CMD|MCS_STOP_CMD;
+			else
+				I2C_MCS(bus) = MCS_RUN_CMD;
+			return;
+		}
+
+		/* Write phase is over with STOP already sent */
+		if(t->rx_size == 0){
+			I2C_Finish(bus, I2C_STATUS_OK);
+			return;
+		}
+
+		/* Repeated START in Read Mode, NACK+STOP right away for a single byte */
+		bus->phase = I2C_PHASE_READ;
+		I2C_MSA(bus) = (t->slave_addr << I2C_RW_PIN) + I2C_RW_PIN;
+		if(t->rx_size == 1)
+			I2C_MCS(bus) = MCS_START_CMD|MCS_RUN_CMD|MCS_STOP_CMD;
+		else
+			I2C_MCS(bus) = MCS_START_CMD|MCS_RUN_CMD|MCS_ACK_CMD;
+		return;
 	}
-	
+
+	/* Read Phase: store the byte and ACK until the last one */
+	t->rx_data[t->rx_count] = (I2C_MDR(bus) & 0xFF);
+	t->rx_count++;
+	remaining = t->rx_size - t->rx_count;
+
+	if(remaining == 0)
+		I2C_Finish(bus, I2C_STATUS_OK);
+	else if(remaining == 1)
+		I2C_MCS(bus) = MCS_RUN_CMD|MCS_STOP_CMD;
+	else
+		I2C_MCS(bus) = MCS_RUN_CMD|MCS_ACK_CMD;
 }
 
+/* Vector Table Entries */
+void I2C0_Handler(void){ I2C_Handler(&I2C0_Bus); }
+void I2C1_Handler(void){ I2C_Handler(&I2C1_Bus); }
+void I2C2_Handler(void){ I2C_Handler(&I2C2_Bus); }
+void I2C3_Handler(void){ I2C_Handler(&I2C3_Bus); }
+
 /*
- *	----------------I2C0_Burst_Transmit-----------------
+ *	-------------------I2C_Receive------------------
+ *	Receive a byte of data from specified peripheral
+ *	Input: Bus Handle, Slave address & Slave Register Address
+ *	Output: Returns 8-bit data that has been received
+ */
+uint8_t I2C_Receive(I2C_BUS_t* bus, uint8_t slave_addr, uint8_t slave_reg_addr){
+
+	I2C_TRANSACTION_t transaction = {0};
+	uint8_t data;
+	uint8_t error;
+
+	transaction.slave_addr = slave_addr;
+	transaction.slave_reg_addr = slave_reg_addr;
+	transaction.rx_data = &data;
+	transaction.rx_size = 1;
+
+	I2C_Submit_Blocking(bus, &transaction);
+
+	/* Return error if any, otherwise the received byte */
+	error = I2C_Wait(bus, &transaction);
+	if(error != 0)
+		return error;
+	else
+		return data;
+
+}
+
+/*
+ *	-------------------I2C_Transmit------------------
+ *	Transmit a byte of data to specified peripheral
+ *	Input: Bus Handle, Slave address, Slave Register Address, Data to Transmit
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t I2C_Transmit(I2C_BUS_t* bus, uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data){
+
+	I2C_TRANSACTION_t transaction = {0};
+
+	transaction.slave_addr = slave_addr;
+	transaction.slave_reg_addr = slave_reg_addr;
+	transaction.tx_data = &data;
+	transaction.tx_size = 1;
+
+	I2C_Submit_Blocking(bus, &transaction);
+
+	return I2C_Wait(bus, &transaction);
+}
+
+/*
+ *	----------------I2C_Burst_Receive-----------------
+ *	Receive multiple bytes of data from specified peripheral in
+ *	one transaction: register address write, repeated START, then
+ *	size bytes with ACK and a final NACK+STOP. The peripheral
+ *	increments the slave register address on its own
+ *	Input: Bus Handle, Slave address, Slave Register Address, Data Buffer, Size of Receive
+ *	Output: Any Errors if detected, otherwise 0 (data is only valid on 0)
+ */
+uint8_t I2C_Burst_Receive(I2C_BUS_t* bus, uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size){
+
+	I2C_TRANSACTION_t transaction = {0};
+
+	/* Asserting Param */
+	if(size == 0)
+		return 0;
+
+	transaction.slave_addr = slave_addr;
+	transaction.slave_reg_addr = slave_reg_addr;
+	transaction.rx_data = data;
+	transaction.rx_size = size;
+
+	I2C_Submit_Blocking(bus, &transaction);
+
+	return I2C_Wait(bus, &transaction);
+}
+
+/*
+ *	----------------I2C_Burst_Transmit-----------------
  *	Transmit multiple bytes of data to specified peripheral
  *  by incrementing starting slave address
- *	Input: Slave address, Slave Register Address, Data Buffer to transmit
- *	Output: None
+ *	Input: Bus Handle, Slave address, Slave Register Address, Data Buffer to transmit, Size of Transmit
+ *	Output: Any Errors if detected, otherwise 0
  */
-uint8_t I2C0_Burst_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size){
-	
-	char error;															//Temp Error Variable
-	char counter = 0;
+uint8_t I2C_Burst_Transmit(I2C_BUS_t* bus, uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size){
+
+	I2C_TRANSACTION_t transaction = {0};
+
 	/* Asserting Param */
 	if(size <= 0)
 		return 0;
-	
-	/* Check if I2C0 is busy */
-	while(I2C_BSY_BIT&I2C0_MCS_R);
-	
-	/* Configure I2C Slave Address, R/W Mode, and what to transmit */
-	I2C0_MSA_R = slave_addr << 1;								//Slave Address is the first 7 MSB
-	I2C0_MSA_R &= ~I2C0_RW_PIN; 						// Clear LSB to write
-	I2C0_MDR_R = slave_reg_addr;								//Transmit register addr to interact
-	
-	/* Initiate I2C by generate a START bit and RUN cmd */
-	I2C0_MCS_R = MCS_START_CMD|MCS_RUN_CMD;
-	
-	/* Wait until write has been completed */
-	while(I2C_BSY_BIT&I2C0_MCS_R);
-	
-	/* Loop to Burst Transmit what is stored in data buffer */
-	while(size > 1){
-		
-		I2C0_MDR_R = data[counter];							//Deference Pointer from data array and load into data reg. Post-Increment the pointer after
-		I2C0_MCS_R = RUN_CMD;									//Initiate I2C RUN CMD
-		while(I2C_BSY_BIT&I2C0_MCS_R);							//Wait until transmit is complete
-		size--;																//Reduce size until 1 is left
-		counter++;
-	}
-	
-	I2C0_MDR_R = data[counter];								//Deference Pointer from data array and load into data reg
-	I2C0_MCS_R = MCS_RUN_CMD|MCS_STOP_CMD;							//Initiate I2C STOP condition and RUN CMD
-	
-	/* Wait until write has been completed */
-	while(I2C_BSY_BIT&I2C0_MCS_R);
-	
-	/* Wait until bus isn't busy */
-	while(I2C_BUS_BUSY_BIT&I2C0_MCS_R);
-	
-	/* Check for any error */
-	error = I2C0_MCS_R&MCS_ERROR_BIT;
-	if(error != 0)
-		return error;
-  else
-		return 0;
+
+	transaction.slave_addr = slave_addr;
+	transaction.slave_reg_addr = slave_reg_addr;
+	transaction.tx_data = data;
+	transaction.tx_size = size;
+
+	I2C_Submit_Blocking(bus, &transaction);
+
+	return I2C_Wait(bus, &transaction);
+}
+
+/*
+ *	-------------------I2C_Transfer------------------
+ *	Run a list of write/read segments as one transaction: START,
+ *	the segments with a repeated START where they ask for one (or
+ *	change direction), then STOP. Data goes straight from and into
+ *	the segment buffers
+ *	Input: Bus Handle, Slave address, Segment List & Number of Segments
+ *	Output: Any Errors if detected, otherwise 0 (read data is only valid on 0)
+ */
+uint8_t I2C_Transfer(I2C_BUS_t* bus, uint8_t slave_addr, const I2C_SEGMENT_t* segments, uint32_t count){
+
+	I2C_TRANSACTION_t transaction = {0};
+
+	transaction.slave_addr = slave_addr;
+	transaction.segments = segments;
+	transaction.seg_count = count;
+
+	//An empty list is refused by I2C_Submit and comes back done
+	I2C_Submit_Blocking(bus, &transaction);
+
+	return I2C_Wait(bus, &transaction);
 }
\ No newline at end of file
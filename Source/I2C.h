@@ -15,67 +15,328 @@
 #include "tm4c123gh6pm.h"
 #include "util.h"
 
+/* Build Options */
+//#define I2C_STATS													//Bus instrumentation (I2CStats.h), no cost when left out
+
 /* List of Fill In Macros */
 
 //Init Function
-#define EN_I2C0_CLOCK			(0x1000)
+#define EN_I2C0_CLOCK			(0x01)						//RCGCI2C Bits
+#define EN_I2C1_CLOCK			(0x02)
+#define EN_I2C2_CLOCK			(0x04)
+#define EN_I2C3_CLOCK			(0x08)
+#define EN_GPIOA_CLOCK		(0x01)						//RCGCGPIO Bits
 #define EN_GPIOB_CLOCK		(0x02)
-#define I2C0_PINS					(0x0C)
-#define I2C0_ALT_FUNC_MSK	(0xFFFF00FF)
-#define I2C0_ALT_FUNC_SET	(0x3300)
-#define I2C0_SDA_PIN			(0x08)
-#define I2C0_SCL_PIN			(0x04)
-#define EN_I2C0_MASTER		(0x10)
-#define I2C_MTPR_TPR_VALUE	(0x07)
+#define EN_GPIOD_CLOCK		(0x08)
+#define EN_GPIOE_CLOCK		(0x10)
+
+#define I2C0_SCL_PIN			(0x04)						//PB2
+#define I2C0_SDA_PIN			(0x08)						//PB3
+#define I2C0_ALT_FUNC_MSK	(0x0000FF00)
+#define I2C0_ALT_FUNC_SET	(0x00003300)
+#define I2C1_SCL_PIN			(0x40)						//PA6
+#define I2C1_SDA_PIN			(0x80)						//PA7
+#define I2C1_ALT_FUNC_MSK	(0xFF000000)
+#define I2C1_ALT_FUNC_SET	(0x33000000)
+#define I2C2_SCL_PIN			(0x10)						//PE4
+#define I2C2_SDA_PIN			(0x20)						//PE5
+#define I2C2_ALT_FUNC_MSK	(0x00FF0000)
+#define I2C2_ALT_FUNC_SET	(0x00330000)
+#define I2C3_SCL_PIN			(0x01)						//PD0
+#define I2C3_SDA_PIN			(0x02)						//PD1
+#define I2C3_ALT_FUNC_MSK	(0x000000FF)
+#define I2C3_ALT_FUNC_SET	(0x00000033)
+
+#define EN_I2C_MASTER			(0x10)
 #define I2C_MTPR_STD_SPEED (0x00)
+#define I2C_MTPR_HS_SPEED	(0x80)
+#define I2C_MTPR_TPR_MAX	(0x7F)
+
+//Bus Speed Selection (SCL Frequency in Hz)
+#define I2C_SPEED_STANDARD	(100000)
+#define I2C_SPEED_FAST			(400000)
+#define I2C_SPEED_FAST_PLUS	(1000000)
+#define I2C_SPEED_HIGH			(3330000)
+#define I2C_SCL_LP_HP				(6+4)				//SCL Low + High Period in Standard/Fast/Fast-mode Plus
+#define I2C_HS_SCL_LP_HP		(2+1)				//SCL Low + High Period in High-Speed
+#define I2C_HS_MASTER_CODE	(0x08)			//00001xxx, unique per master on the bus
 
 //Transmit Function (Most came from above Macros)
-#define I2C0_RW_PIN				(0x01)
+#define I2C_RW_PIN				(0x01)
+
+//Interrupt Driven Transaction Engine
+#define I2C_QUEUE_SIZE		(8)							//Max Number of Queued Transactions per Bus
+#define I2C_MIMR_IM				(0x01)					//Master Interrupt Mask
+#define I2C_MICR_IC				(0x01)					//Master Interrupt Clear
+#define I2C0_IRQ					(8)							//NVIC Interrupt Numbers
+#define I2C1_IRQ					(37)
+#define I2C2_IRQ					(68)
+#define I2C3_IRQ					(69)
+#define I2C_INT_PRIORITY	(2)
+
+//Timeouts & Bus Recovery
+#define I2C_MIMR_CLKIM		(0x02)					//Clock Timeout Interrupt Mask
+#define I2C_MICR_CLKIC		(0x02)					//Clock Timeout Interrupt Clear
+#define I2C_MCLKOCNT_CNTL	(0xFF)					//Longest SCL low period before CLKTO (upper 8 bits of 12-bit count)
+#define I2C_TIMEOUT_MARGIN_US	(1000)		//Slack on top of twice the wire time of a transaction
+#define I2C_RECOVERY_PULSES	(9)					//SCL pulses to flush a slave stuck mid-byte
+#define I2C_RECOVERY_HALF_US	(5)				//Half SCL period while bit banging (~100kHz)
+
+/* Transaction Status Values (bus errors are the MCS Error Bit plus the cause) */
+#define I2C_STATUS_OK					(0x00)
+#define I2C_STATUS_ERROR			(0x02)			//Same as MCS Error Bit
+#define I2C_STATUS_ADRACK			(0x06)			//Address not acknowledged (device missing)
+#define I2C_STATUS_DATACK			(0x0A)			//Data not acknowledged
+#define I2C_STATUS_ARBLST			(0x12)			//Arbitration lost to another master
+#define I2C_STATUS_CLKTO			(0x82)			//SCL held low too long, bus was recovered
+#define I2C_STATUS_TIMEOUT		(0xFC)			//Transaction took too long, bus was recovered
+#define I2C_STATUS_INVALID		(0xFD)			//Rejected Parameter
+#define I2C_STATUS_QUEUE_FULL	(0xFE)
+#define I2C_STATUS_PENDING		(0xFF)
+
+/* Transfer Segment Flags */
+#define I2C_SEG_WRITE			(0x00)
+#define I2C_SEG_READ			(0x01)					//Read into buf instead of writing from it
+#define I2C_SEG_RESTART		(0x02)					//Repeated START before this segment (always done when the direction changes)
+
+/* Transfer Segment
+ *
+ *	One piece of a segment transfer, like a Linux i2c_msg. Segments
+ *	in the same direction without I2C_SEG_RESTART run back to back
+ *	on the wire, so a header and its payload can come from separate
+ *	buffers. Empty segments are skipped
+ */
+typedef struct{
+	uint8_t flags;
+	uint8_t* buf;
+	uint32_t len;
+} I2C_SEGMENT_t;
+
+/* Transaction Descriptor
+ *
+ *	Transmits the slave register address followed by tx_size bytes of
+ *	tx_data, then (if rx_size is not 0) issues a repeated START and reads
+ *	rx_size bytes into rx_data. The descriptor and its buffers must stay
+ *	valid until done is set.
+ *
+ *	With segments set the register form is ignored: the segment list
+ *	runs as one transaction (START, segments, STOP). Leave segments 0
+ *	otherwise.
+ */
+typedef struct I2C_TRANSACTION I2C_TRANSACTION_t;
+
+typedef struct I2C_BUS I2C_BUS_t;
+
+typedef void (*I2C_CALLBACK_t)(I2C_TRANSACTION_t* transaction);
+
+#include "I2CStats.h"
+
+struct I2C_TRANSACTION{
+	uint8_t slave_addr;
+	uint8_t slave_reg_addr;
+
+	const uint8_t* tx_data;
+	uint32_t tx_size;
+
+	uint8_t* rx_data;
+	uint32_t rx_size;
+	volatile uint32_t rx_count;				//Bytes actually received (valid up to an error)
+
+	const I2C_SEGMENT_t* segments;		//Segment transfer (can be 0)
+	uint32_t seg_count;
+
+	I2C_CALLBACK_t callback;					//Called on completion from the bus ISR, or at thread level from I2C_Check_Timeout (can be 0)
+	void* context;										//User data for the callback
+
+	volatile uint8_t status;					//I2C_STATUS_PENDING until done
+	volatile uint8_t done;						//Set to 1 once the transaction has finished
+
+#ifdef I2C_STATS
+	uint32_t submit_us;								//Latency start
+#endif
+};
+
+/* Pin Mux of an I2C Module: GPIO port registers and pin masks */
+typedef struct{
+	volatile uint32_t* DATA;
+	volatile uint32_t* DIR;
+	volatile uint32_t* AFSEL;
+	volatile uint32_t* ODR;
+	volatile uint32_t* DEN;
+	volatile uint32_t* AMSEL;
+	volatile uint32_t* PCTL;
+
+	uint32_t scl_pin;
+	uint32_t sda_pin;
+	uint32_t alt_func_msk;
+	uint32_t alt_func_set;
+} I2C_PINS_t;
+
+/* Bus Descriptor: one per TM4C123 I2C module
+ *
+ *	Everything above the engine state is fixed hardware description.
+ *	The engine state belongs to the driver, don't touch it.
+ */
+struct I2C_BUS{
+	volatile uint32_t* regs;					//Module register block (I2Cx_MSA_R is offset 0)
+	I2C_PINS_t pins;
+	uint32_t i2c_clock;								//RCGCI2C Bit
+	uint32_t gpio_clock;							//RCGCGPIO Bit
+	uint32_t irq;											//NVIC Interrupt Number
+
+	uint32_t speed;										//SCL Frequency set by I2C_Init_Speed (Hz), 0 before that
+
+	/* Transaction Engine State (Shared with the bus ISR) */
+	I2C_TRANSACTION_t* queue[I2C_QUEUE_SIZE];
+	volatile uint32_t queue_head;
+	volatile uint32_t queue_tail;
+	volatile uint32_t queue_count;
+	I2C_TRANSACTION_t* volatile current;
+	uint8_t phase;
+	uint8_t hs_mode;
+	uint8_t stopping;									//Error STOP on the wire, the transaction finishes once it is out
+	uint32_t tx_index;								//Segment transfers: wire bytes so far, address bytes included
+	uint32_t seg_index;								//Segment transfers: segment and byte on the wire
+	uint32_t seg_pos;
+	uint32_t start_us;								//When the current transaction went on the wire
+	uint32_t budget_us;								//How long it may take before it is aborted
+	volatile uint8_t fault;						//Clock low timeout seen by the ISR, waiting for I2C_Check_Timeout
+	volatile uint8_t recovering;			//I2C_Check_Timeout owns the bus, the ISR keeps out
+
+#ifdef I2C_STATS
+	I2C_STATS_t stats;
+#endif
+};
 
-//Burst Transmit Function
-#define RUN_CMD						(CONSTANT_FILL)
+/* Bus Handles */
+extern I2C_BUS_t I2C0_Bus;							//PB2 SCL, PB3 SDA
+extern I2C_BUS_t I2C1_Bus;							//PA6 SCL, PA7 SDA
+extern I2C_BUS_t I2C2_Bus;							//PE4 SCL, PE5 SDA
+extern I2C_BUS_t I2C3_Bus;							//PD0 SCL, PD1 SDA
 
 /*
- *	-------------------I2C0_Init------------------
+ *	-------------------I2C_Init------------------
  *	Basic I2C Initialization function for master mode @ 100kHz
- *	Input: None
+ *	Input: Bus Handle
  *	Output: None
  */
-void I2C0_Init(void);
+void I2C_Init(I2C_BUS_t* bus);
 
 /*
- *	-------------------I2C0_Receive------------------
- *	Polls to receive data from specified peripheral
- *	Input: Slave address & Slave Register Address
+ *	-----------------I2C_Init_Speed----------------
+ *	I2C Initialization function for master mode at a chosen SCL
+ *	rate. Rates above 1MHz use High-Speed mode (master code is
+ *	sent in front of every transaction). WTIMER1_Init has to run
+ *	first, every wait on the bus is timed with it
+ *	Input: Bus Handle, SCL Frequency (Hz) & System Clock (Hz)
+ *	Output: I2C_STATUS_OK, or I2C_STATUS_INVALID if the rate can't
+ *					be reached from this system clock (nothing is configured)
+ */
+uint8_t I2C_Init_Speed(I2C_BUS_t* bus, uint32_t scl_hz, uint32_t sys_clock_hz);
+
+/*
+ *	-------------------I2C_Submit------------------
+ *	Queue a transaction to be run by the bus interrupt. Returns
+ *	right away, completion is reported through the done flag and
+ *	the optional callback
+ *	Input: Bus Handle & Transaction Descriptor
+ *	Output: I2C_STATUS_OK if queued, I2C_STATUS_QUEUE_FULL otherwise,
+ *					I2C_STATUS_INVALID for a segment list without any bytes
+ *					or a bus that was never initialized (the transaction is
+ *					done right away)
+ */
+uint8_t I2C_Submit(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction);
+
+/*
+ *	-------------------I2C_Wait------------------
+ *	Wait until a submitted transaction has finished. Never hangs:
+ *	a transaction stuck on the wire is aborted once it runs over
+ *	its time budget
+ *	Input: Bus Handle & Transaction Descriptor
+ *	Output: Transaction Status
+ */
+uint8_t I2C_Wait(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction);
+
+/*
+ *	---------------I2C_Check_Timeout----------------
+ *	Abort the transaction on the wire if it ran over its time
+ *	budget or a slave held SCL past the clock low timeout: the bus
+ *	is recovered and the transaction finishes with I2C_STATUS_TIMEOUT
+ *	or I2C_STATUS_CLKTO. Recovery runs here with interrupts on, never
+ *	in the bus ISR, so call this from any loop that waits on the bus
+ *	(not from an ISR). The aborted transaction's callback runs here
+ *	too, once interrupts are back on
+ *	Input: Bus Handle
+ *	Output: None
+ */
+void I2C_Check_Timeout(I2C_BUS_t* bus);
+
+/*
+ *	-----------------I2C_Recover------------------
+ *	Free a bus held by a slave stuck mid-byte: pins go to GPIO,
+ *	SCL is pulsed 9 times, a STOP is bit banged, then the module is
+ *	reset and handed back its pins and settings. Queued transactions
+ *	are kept. Takes about 100us with interrupts on, so call it from
+ *	thread level on an idle bus (I2C_Check_Timeout does it for a
+ *	stuck transaction)
+ *	Input: Bus Handle
+ *	Output: I2C_STATUS_OK if SDA is released, otherwise I2C_STATUS_ERROR
+ */
+uint8_t I2C_Recover(I2C_BUS_t* bus);
+
+/*
+ *	-------------------I2C_Is_Idle------------------
+ *	Check if the bus has nothing left to run
+ *	Input: Bus Handle
+ *	Output: 1 if idle, otherwise 0
+ */
+uint8_t I2C_Is_Idle(I2C_BUS_t* bus);
+
+/*
+ *	-------------------I2C_Receive------------------
+ *	Receive a byte of data from specified peripheral
+ *	Input: Bus Handle, Slave address & Slave Register Address
  *	Output: Returns 8-bit data that has been received
  */
-uint8_t I2C0_Receive(uint8_t slave_addr, uint8_t slave_reg_addr);
+uint8_t I2C_Receive(I2C_BUS_t* bus, uint8_t slave_addr, uint8_t slave_reg_addr);
 
 /*
- *	-------------------I2C0_Transmit------------------
+ *	-------------------I2C_Transmit------------------
  *	Transmit a byte of data to specified peripheral
- *	Input: Slave address, Slave Register Address, Data to Transmit
+ *	Input: Bus Handle, Slave address, Slave Register Address, Data to Transmit
  *	Output: Any Errors if detected, otherwise 0
  */
-uint8_t I2C0_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data);
+uint8_t I2C_Transmit(I2C_BUS_t* bus, uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t data);
 
-//Has Yet to be Implemented
 /*
- *	----------------I2C0_Burst_Receive-----------------
- *	Polls to receive multiple bytes of data from specified
- *  peripheral by incrementing starting slave register address
- *	Input: Slave address, Slave Register Address, Data Buffer
- *	Output: None
+ *	----------------I2C_Burst_Receive-----------------
+ *	Receive multiple bytes of data from specified peripheral in
+ *	one transaction: register address write, repeated START, then
+ *	size bytes with ACK and a final NACK+STOP. The peripheral
+ *	increments the slave register address on its own
+ *	Input: Bus Handle, Slave address, Slave Register Address, Data Buffer, Size of Receive
+ *	Output: Any Errors if detected, otherwise 0 (data is only valid on 0)
  */
-void I2C0_Burst_Receive(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size);
+uint8_t I2C_Burst_Receive(I2C_BUS_t* bus, uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size);
 
 /*
- *	----------------I2C0_Burst_Transmit-----------------
+ *	----------------I2C_Burst_Transmit-----------------
  *	Transmit multiple bytes of data to specified peripheral
  *  by incrementing starting slave address
- *	Input: Slave address, Slave Register Address, Data Buffer to transmit, Size of Transmit
- *	Output: None
+ *	Input: Bus Handle, Slave address, Slave Register Address, Data Buffer to transmit, Size of Transmit
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t I2C_Burst_Transmit(I2C_BUS_t* bus, uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size);
+
+/*
+ *	-------------------I2C_Transfer------------------
+ *	Run a list of write/read segments as one transaction: START,
+ *	the segments with a repeated START where they ask for one (or
+ *	change direction), then STOP. Data goes straight from and into
+ *	the segment buffers
+ *	Input: Bus Handle, Slave address, Segment List & Number of Segments
+ *	Output: Any Errors if detected, otherwise 0 (read data is only valid on 0)
  */
-uint8_t I2C0_Burst_Transmit(uint8_t slave_addr, uint8_t slave_reg_addr, uint8_t* data, uint32_t size);
+uint8_t I2C_Transfer(I2C_BUS_t* bus, uint8_t slave_addr, const I2C_SEGMENT_t* segments, uint32_t count);
 
 #endif //I2C_H_
\ No newline at end of file
@@ -19,9 +19,11 @@
 #include "util.h"
 #include "Servo.h"
 #include "LCD.h"
+#include "I2CSched.h"
 #include <stdio.h>
 #include <string.h>
 #include "ModuleTest.h"
+#include "Calib.h"
 
 /* List of Predefined Macros for individual Peripheral Testing */
 #define DELAY
@@ -33,6 +35,70 @@
 #define LCD
 //#define FULL_SYSTEM
 
+/* Bus Assignment: point LCD_BUS at &I2C1_Bus (PA6/PA7) to take the LCD off the sensor bus */
+#define SENSOR_BUS		(&I2C0_Bus)
+#define LCD_BUS				(&I2C0_Bus)
+
+#ifdef FULL_SYSTEM
+/* Bus Scheduler: the IMU goes first, then the color sensor, and the
+ * LCD is split into one job per write, so a sensor read only ever
+ * waits behind a single 4-byte LCD transaction */
+#define IMU_PERIOD_US		(5000)									//200Hz motion reads
+#define COLOR_PERIOD_US	(25000)									//Longer than the 2.4ms integration
+#define LCD_PERIOD_US		(50000)
+static I2C_SCHED_t Sensor_Sched;
+static I2C_SCHED_CLIENT_t IMU_Sched_Client;
+static I2C_SCHED_CLIENT_t Color_Sched_Client;
+static I2C_SCHED_CLIENT_t LCD_Sched_Client;
+
+/* Sensor Reads: one job per sensor, queued again once it is done */
+static I2C_SCHED_JOB_t IMU_Job;
+static I2C_SCHED_JOB_t Color_Job;
+static uint8_t IMU_Data[MPU6050_MOTION_DATA_SIZE];
+static uint8_t Color_Data[TCS34727_RGBC_DATA_SIZE];
+
+/* IMU Calibration: the stored one on a warm boot, SW1 held through reset measures a new one */
+static CALIB_t IMU_Calib;
+
+/*
+ *	-------------------Sensor_Resubmit------------------
+ *	Queue a finished sensor read again, released one client period
+ *	after its last release (right away if that already went by)
+ *	Input: Client & Job
+ *	Output: None
+ */
+static void Sensor_Resubmit(I2C_SCHED_CLIENT_t* client, I2C_SCHED_JOB_t* job){
+	uint32_t elapsed = TIMESTAMP_US() - job->release_us;
+	I2C_Sched_Submit(&Sensor_Sched, client, job, (elapsed < client->period_us) ? (client->period_us - elapsed) : 0);
+}
+
+/*
+ *	-------------------Sensor_Update------------------
+ *	Turn finished sensor reads into the instances Test_Full_System
+ *	works with and queue the next ones
+ *	Input: None
+ *	Output: None
+ */
+static void Sensor_Update(void){
+	
+	if(IMU_Job.transaction.done){
+		if(IMU_Job.transaction.status == I2C_STATUS_OK){
+			MPU6050_Unpack_Motion(IMU_Data, &Accel_Instance, &Gyro_Instance, 0);
+			MPU6050_Process_Accel(&Accel_Instance);
+			MPU6050_Process_Gyro(&Gyro_Instance);
+			Calib_Apply(&IMU_Calib, &Accel_Instance, &Gyro_Instance);
+		}
+		Sensor_Resubmit(&IMU_Sched_Client, &IMU_Job);
+	}
+	
+	if(Color_Job.transaction.done){
+		if(Color_Job.transaction.status == I2C_STATUS_OK)
+			TCS34727_Unpack_RGBC(Color_Data, &RGB_COLOR);
+		Sensor_Resubmit(&Color_Sched_Client, &Color_Job);
+	}
+}
+#endif
+
 int main(void){
 	
 	/* Peripheral Initialization */
@@ -45,17 +111,30 @@ int main(void){
 	#endif
 	
 	#if defined (I2C) || defined(TCS34727) || defined(MPU6050) || defined(LCD) || defined(FULL_SYSTEM)
-	I2C0_Init();
+	WTIMER1_Init();																		//I2C Timeout and Scheduler Timebase
+	#endif
+	
+	#if defined (I2C) || defined(TCS34727) || defined(MPU6050) || defined(LCD) || defined(FULL_SYSTEM)
+	/* Both sensors and the LCD backpack run at 400kHz */
+	if(I2C_Init_Speed(SENSOR_BUS, I2C_SPEED_FAST, SYS_CLOCK_HZ) != I2C_STATUS_OK)
+		I2C_Init(SENSOR_BUS);
+	if(LCD_BUS != SENSOR_BUS && I2C_Init_Speed(LCD_BUS, I2C_SPEED_FAST, SYS_CLOCK_HZ) != I2C_STATUS_OK)
+		I2C_Init(LCD_BUS);
 	#endif
 	
 	#if defined(TCS34727) || defined(FULL_SYSTEM)
 	/* Color Sensor Initialization */
-	TCS34727_Init();
+	TCS34727_Init(SENSOR_BUS);
 	#endif
 	
 	#if defined(MPU6050) || defined(FULL_SYSTEM)
 	/* MPU6050 Initialization */
-	MPU6050_Init();
+	MPU6050_Init(SENSOR_BUS);
+	#endif
+	
+	#ifdef FULL_SYSTEM
+	if(Calib_Init(&IMU_Calib, !(GPIO_PORTF_DATA_R & SW1_PIN)) == CALIB_ERROR)
+		UART0_OutString("IMU Calibration Error\r\n");
 	#endif
 	
 	#if defined(SERVO) || defined(FULL_SYSTEM)
@@ -65,11 +144,36 @@ int main(void){
 	
 	#if defined(LCD) || defined(FULL_SYSTEM)
 	/* LCD Initialization */
-	LCD_Init();
+	LCD_Init(LCD_BUS);
+	#endif
+	
+	#ifdef FULL_SYSTEM
+	/* Every sensor read from here on goes through the scheduler, and the LCD writes too when it shares the bus */
+	I2C_Sched_Init(&Sensor_Sched, SENSOR_BUS);
+	I2C_Sched_Register(&Sensor_Sched, &IMU_Sched_Client, I2C_SCHED_PRIO_IMU, IMU_PERIOD_US);
+	I2C_Sched_Register(&Sensor_Sched, &Color_Sched_Client, I2C_SCHED_PRIO_COLOR, COLOR_PERIOD_US);
+	if(LCD_BUS == SENSOR_BUS){
+		I2C_Sched_Register(&Sensor_Sched, &LCD_Sched_Client, I2C_SCHED_PRIO_DISPLAY, LCD_PERIOD_US);
+		LCD_Attach_Scheduler(&Sensor_Sched, &LCD_Sched_Client);
+	}
+	
+	MPU6050_Motion_Transaction(&IMU_Job.transaction, IMU_Data);
+	TCS34727_RGBC_Transaction(&Color_Job.transaction, Color_Data);
+	I2C_Sched_Submit(&Sensor_Sched, &IMU_Sched_Client, &IMU_Job, 0);
+	I2C_Sched_Submit(&Sensor_Sched, &Color_Sched_Client, &Color_Job, 0);
 	#endif
 	
 	while(1){
 		
+		#ifdef I2C_STATS
+		/* Bus statistics on demand from the terminal */
+		if(!(UART0_FR_R&UART_FR_RXFE) && UART0_InChar() == I2C_STATS_DUMP_CHAR){
+			I2C_Stats_Dump(SENSOR_BUS);
+			if(LCD_BUS != SENSOR_BUS)
+				I2C_Stats_Dump(LCD_BUS);
+		}
+		#endif
+		
 		#ifdef DELAY
 		Module_Test(DELAY_TEST);
 		#endif
@@ -99,7 +203,9 @@ int main(void){
 		#endif
 		
 		#ifdef FULL_SYSTEM
+		Sensor_Update();
 		Module_Test(FULL_SYSTEM_TEST);
+		I2C_Sched_Poll(&Sensor_Sched);										//Start sensor reads and LCD writes that are due
 		#endif
 		
 	}
@@ -0,0 +1,283 @@
+/*
+ * I2CSched.c
+ *
+ *	Main implementation of the priority and deadline aware
+ *	I2C transaction scheduler
+ *
+ */
+
+#include "I2CSched.h"
+#include "util.h"
+
+/*
+ *	----------------I2C_Sched_Account----------------
+ *	Local function that updates the deadline statistics of a
+ *	finished job's client
+ *	Input: Finished Job
+ *	Output: None
+ */
+static void I2C_Sched_Account(I2C_SCHED_JOB_t* job){
+
+	I2C_SCHED_CLIENT_t* client = job->client;
+	uint32_t now = TIMESTAMP_US();
+	uint32_t latency = now - job->release_us;
+
+	client->completed++;
+	if((int32_t)(now - job->deadline_us) > 0)
+		client->missed++;
+	if(latency > client->worst_latency_us)
+		client->worst_latency_us = latency;
+}
+
+/*
+ *	---------------I2C_Sched_Dispatch----------------
+ *	Local function that puts the most urgent released job on the
+ *	bus: lowest priority value first, earliest deadline among equal
+ *	priorities. A job the bus refuses for good moves to the refused
+ *	list and the next one is tried. Called inside a critical section
+ *	Input: Scheduler
+ *	Output: None
+ */
+static void I2C_Sched_Dispatch(I2C_SCHED_t* sched){
+
+	I2C_SCHED_CLIENT_t* best;
+	I2C_SCHED_CLIENT_t* client;
+	I2C_SCHED_JOB_t* job;
+	uint32_t now;
+	uint8_t status;
+	uint8_t i;
+
+	/* Non-preemptive at transaction boundaries: one job on the bus at a time */
+	while(sched->active == 0){
+
+		now = TIMESTAMP_US();
+		best = 0;
+
+		for(i = 0; i < sched->client_count; i++){
+			client = sched->clients[i];
+			job = client->head;
+
+			//Skip clients with nothing released yet
+			if(job == 0 || (int32_t)(now - job->release_us) < 0)
+				continue;
+
+			if(best == 0 || client->priority < best->priority ||
+				(client->priority == best->priority && (int32_t)(job->deadline_us - best->head->deadline_us) < 0))
+				best = client;
+		}
+
+		if(best == 0)
+			return;
+
+		/* Pop from the client and hand it to the engine */
+		job = best->head;
+		best->head = job->next;
+		if(best->head == 0)
+			best->tail = 0;
+
+		sched->active = job;
+		status = I2C_Submit(sched->bus, &job->transaction);
+		if(status == I2C_STATUS_OK)
+			return;
+		sched->active = 0;
+
+		if(status == I2C_STATUS_QUEUE_FULL){
+			//Someone bypassed the scheduler and filled the queue, retry on next poll
+			I2C_STATS_RETRY(sched->bus);
+			job->next = best->head;
+			best->head = job;
+			if(best->tail == 0)
+				best->tail = job;
+			return;
+		}
+
+		//Refused for good (status is in the transaction), its callback runs once out of the critical section
+		I2C_Sched_Account(job);
+		job->next = 0;
+		if(sched->refused_tail)
+			sched->refused_tail->next = job;
+		else
+			sched->refused = job;
+		sched->refused_tail = job;
+	}
+}
+
+/*
+ *	--------------I2C_Sched_Run_Refused--------------
+ *	Local function that runs the callbacks of the jobs the bus
+ *	refused, outside the critical section. A callback that submits
+ *	again only adds to the list this loop is working through, so
+ *	nothing nests
+ *	Input: Scheduler
+ *	Output: None
+ */
+static void I2C_Sched_Run_Refused(I2C_SCHED_t* sched){
+
+	I2C_SCHED_JOB_t* job;
+	uint32_t state;
+
+	state = START_CRITICAL();
+	if(sched->draining){
+		END_CRITICAL(state);
+		return;
+	}
+	sched->draining = 1;
+
+	while((job = sched->refused) != 0){
+		sched->refused = job->next;
+		if(sched->refused == 0)
+			sched->refused_tail = 0;
+		END_CRITICAL(state);
+
+		if(job->callback)
+			job->callback(&job->transaction);
+
+		state = START_CRITICAL();
+	}
+
+	sched->draining = 0;
+	END_CRITICAL(state);
+}
+
+/*
+ *	---------------I2C_Sched_Complete----------------
+ *	Local completion callback of every scheduled transaction.
+ *	Updates deadline statistics and dispatches the next job
+ *	Input: Finished Transaction (context is the scheduler)
+ *	Output: None
+ */
+static void I2C_Sched_Complete(I2C_TRANSACTION_t* transaction){
+
+	I2C_SCHED_t* sched = (I2C_SCHED_t*)transaction->context;
+	I2C_SCHED_JOB_t* job = sched->active;
+	I2C_CALLBACK_t callback = job->callback;
+	uint32_t state;
+
+	I2C_Sched_Account(job);
+
+	state = START_CRITICAL();
+	sched->active = 0;
+	I2C_Sched_Dispatch(sched);
+	END_CRITICAL(state);
+
+	if(callback)
+		callback(transaction);
+
+	I2C_Sched_Run_Refused(sched);
+}
+
+/*
+ *	-----------------I2C_Sched_Init------------------
+ *	Initialize a scheduler for one bus (bus must be initialized,
+ *	WTIMER1_Init must have been called)
+ *	Input: Scheduler & Bus Handle
+ *	Output: None
+ */
+void I2C_Sched_Init(I2C_SCHED_t* sched, I2C_BUS_t* bus){
+	sched->bus = bus;
+	sched->client_count = 0;
+	sched->active = 0;
+	sched->refused = sched->refused_tail = 0;
+	sched->draining = 0;
+}
+
+/*
+ *	---------------I2C_Sched_Register----------------
+ *	Register a client with the scheduler
+ *	Input: Scheduler, Client, Priority (0 most urgent), Period/Relative Deadline in us
+ *	Output: I2C_STATUS_OK, or I2C_STATUS_INVALID if the table is full
+ */
+uint8_t I2C_Sched_Register(I2C_SCHED_t* sched, I2C_SCHED_CLIENT_t* client, uint8_t priority, uint32_t period_us){
+
+	uint32_t state;
+
+	/* Asserting Param */
+	if(sched->client_count >= I2C_SCHED_MAX_CLIENTS)
+		return I2C_STATUS_INVALID;
+
+	client->priority = priority;
+	client->period_us = period_us;
+	client->head = client->tail = 0;
+	client->completed = client->missed = client->worst_latency_us = 0;
+
+	state = START_CRITICAL();
+	sched->clients[sched->client_count++] = client;
+	END_CRITICAL(state);
+
+	return I2C_STATUS_OK;
+}
+
+/*
+ *	----------------I2C_Sched_Submit-----------------
+ *	Queue a job for a client. It becomes eligible delay_us from now
+ *	and is due one client period after that. A job the bus refuses
+ *	(I2C_Submit error other than a full queue) completes with that
+ *	status
+ *	Input: Scheduler, Client, Job & Release Delay in us
+ *	Output: I2C_STATUS_OK
+ */
+uint8_t I2C_Sched_Submit(I2C_SCHED_t* sched, I2C_SCHED_CLIENT_t* client, I2C_SCHED_JOB_t* job, uint32_t delay_us){
+
+	uint32_t state;
+
+	job->client = client;
+	job->next = 0;
+	job->release_us = TIMESTAMP_US() + delay_us;
+	job->deadline_us = job->release_us + client->period_us;
+
+	//Scheduler gets the completion first, then forwards it to job->callback
+	job->transaction.callback = I2C_Sched_Complete;
+	job->transaction.context = sched;
+	job->transaction.status = I2C_STATUS_PENDING;
+	job->transaction.done = 0;
+
+	state = START_CRITICAL();
+
+	if(client->tail)
+		client->tail->next = job;
+	else
+		client->head = job;
+	client->tail = job;
+
+	I2C_Sched_Dispatch(sched);
+
+	END_CRITICAL(state);
+
+	I2C_Sched_Run_Refused(sched);
+
+	return I2C_STATUS_OK;
+}
+
+/*
+ *	-----------------I2C_Sched_Poll------------------
+ *	Dispatch jobs whose release time has come and abort a job that
+ *	overran its time budget. Completions dispatch on their own, call
+ *	this from the main loop or a periodic timer so delayed jobs get
+ *	started
+ *	Input: Scheduler
+ *	Output: None
+ */
+void I2C_Sched_Poll(I2C_SCHED_t* sched){
+	uint32_t state;
+
+	//A stuck job is aborted here, its completion dispatches the next one
+	I2C_Check_Timeout(sched->bus);
+
+	state = START_CRITICAL();
+	I2C_Sched_Dispatch(sched);
+	END_CRITICAL(state);
+
+	I2C_Sched_Run_Refused(sched);
+}
+
+/*
+ *	-----------------I2C_Sched_Wait------------------
+ *	Wait until a job has finished, polling the scheduler meanwhile
+ *	Input: Scheduler & Job
+ *	Output: Transaction Status
+ */
+uint8_t I2C_Sched_Wait(I2C_SCHED_t* sched, I2C_SCHED_JOB_t* job){
+	while(!job->transaction.done)
+		I2C_Sched_Poll(sched);
+	return job->transaction.status;
+}
\ No newline at end of file
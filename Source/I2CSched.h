@@ -0,0 +1,121 @@
+/*
+ * I2CSched.h
+ *
+ *	Provides a priority and deadline aware transaction scheduler
+ *	that sits above the I2C transaction engine. Clients (IMU,
+ *	color sensor, LCD, ...) register with a priority and a period,
+ *	and only one scheduled job is on the bus at a time so a
+ *	long LCD write can never hold off a more urgent client for
+ *	more than one transaction
+ *
+ */
+
+#ifndef I2CSCHED_H_
+#define I2CSCHED_H_
+
+#include <stdint.h>
+#include "I2C.h"
+
+/* List of Scheduler Macros */
+#define I2C_SCHED_MAX_CLIENTS		(4)
+
+//Client Priorities (0 is the most urgent)
+#define I2C_SCHED_PRIO_IMU			(0)
+#define I2C_SCHED_PRIO_COLOR		(1)
+#define I2C_SCHED_PRIO_DISPLAY	(3)
+
+typedef struct I2C_SCHED_CLIENT I2C_SCHED_CLIENT_t;
+typedef struct I2C_SCHED_JOB I2C_SCHED_JOB_t;
+
+/* Scheduled Job
+ *
+ *	Fill in transaction like a normal I2C transaction. The scheduler
+ *	owns transaction.callback/context while the job is queued, put
+ *	your own completion callback in callback instead. It never runs
+ *	inside a critical section: it runs from the bus ISR, or at thread
+ *	level for a job the bus refused or I2C_Check_Timeout aborted
+ */
+struct I2C_SCHED_JOB{
+	I2C_TRANSACTION_t transaction;
+	I2C_CALLBACK_t callback;					//Called on completion (can be 0)
+
+	uint32_t release_us;							//Earliest start time
+	uint32_t deadline_us;							//Has to be done by this time
+	I2C_SCHED_CLIENT_t* client;
+	I2C_SCHED_JOB_t* next;
+};
+
+/* Client Descriptor */
+struct I2C_SCHED_CLIENT{
+	uint8_t priority;
+	uint32_t period_us;								//Relative deadline of every job
+
+	I2C_SCHED_JOB_t* head;						//Pending jobs, run in order per client
+	I2C_SCHED_JOB_t* tail;
+
+	/* Statistics */
+	volatile uint32_t completed;
+	volatile uint32_t missed;					//Jobs that finished after their deadline
+	volatile uint32_t worst_latency_us;	//Longest release to completion time
+};
+
+/* Scheduler for one bus */
+typedef struct{
+	I2C_BUS_t* bus;
+	I2C_SCHED_CLIENT_t* clients[I2C_SCHED_MAX_CLIENTS];
+	uint8_t client_count;
+	I2C_SCHED_JOB_t* volatile active;	//Job currently on the bus
+
+	I2C_SCHED_JOB_t* refused;			//Jobs the bus refused, callbacks still to run
+	I2C_SCHED_JOB_t* refused_tail;
+	uint8_t draining;					//Refused callbacks are being run
+} I2C_SCHED_t;
+
+/*
+ *	-----------------I2C_Sched_Init------------------
+ *	Initialize a scheduler for one bus (bus must be initialized,
+ *	WTIMER1_Init must have been called)
+ *	Input: Scheduler & Bus Handle
+ *	Output: None
+ */
+void I2C_Sched_Init(I2C_SCHED_t* sched, I2C_BUS_t* bus);
+
+/*
+ *	---------------I2C_Sched_Register----------------
+ *	Register a client with the scheduler
+ *	Input: Scheduler, Client, Priority (0 most urgent), Period/Relative Deadline in us
+ *	Output: I2C_STATUS_OK, or I2C_STATUS_INVALID if the table is full
+ */
+uint8_t I2C_Sched_Register(I2C_SCHED_t* sched, I2C_SCHED_CLIENT_t* client, uint8_t priority, uint32_t period_us);
+
+/*
+ *	----------------I2C_Sched_Submit-----------------
+ *	Queue a job for a client. It becomes eligible delay_us from now
+ *	and is due one client period after that. A job the bus refuses
+ *	(I2C_Submit error other than a full queue) completes with that
+ *	status
+ *	Input: Scheduler, Client, Job & Release Delay in us
+ *	Output: I2C_STATUS_OK
+ */
+uint8_t I2C_Sched_Submit(I2C_SCHED_t* sched, I2C_SCHED_CLIENT_t* client, I2C_SCHED_JOB_t* job, uint32_t delay_us);
+
+/*
+ *	-----------------I2C_Sched_Poll------------------
+ *	Dispatch jobs whose release time has come and abort a job that
+ *	overran its time budget. Completions dispatch on their own, call
+ *	this from the main loop or a periodic timer so delayed jobs get
+ *	started
+ *	Input: Scheduler
+ *	Output: None
+ */
+void I2C_Sched_Poll(I2C_SCHED_t* sched);
+
+/*
+ *	-----------------I2C_Sched_Wait------------------
+ *	Wait until a job has finished, polling the scheduler meanwhile
+ *	Input: Scheduler & Job
+ *	Output: Transaction Status
+ */
+uint8_t I2C_Sched_Wait(I2C_SCHED_t* sched, I2C_SCHED_JOB_t* job);
+
+#endif //I2CSCHED_H_
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*
+ * I2CStats.c
+ *
+ *	Main implementation of the I2C bus instrumentation
+ *
+ */
+
+#include "I2CStats.h"
+
+#ifdef I2C_STATS
+
+#include <stdio.h>
+#include "UART0.h"
+#include "util.h"
+
+/*
+ *	----------------I2C_Stats_Record-----------------
+ *	Account for a finished transaction (called by the engine)
+ *	Input: Bus Handle, Transaction, Status & Bytes on the wire
+ *	Output: None
+ */
+void I2C_Stats_Record(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction, uint8_t status, uint32_t bytes){
+
+	I2C_STATS_t* stats = &bus->stats;
+	I2C_SLAVE_STATS_t* slave = 0;
+	uint32_t now = TIMESTAMP_US();
+	uint32_t latency = now - transaction->submit_us;
+	uint8_t i;
+
+	stats->transactions++;
+	stats->bytes += bytes;
+	stats->busy_us += now - bus->start_us;
+
+	if(status == I2C_STATUS_ADRACK || status == I2C_STATUS_DATACK)
+		stats->nacks++;
+	else if(status != I2C_STATUS_OK)
+		stats->errors++;
+
+	/* Find the slave, take a new slot the first time it shows up */
+	for(i = 0; i < stats->slave_count; i++){
+		if(stats->slaves[i].addr == transaction->slave_addr){
+			slave = &stats->slaves[i];
+			break;
+		}
+	}
+	if(slave == 0){
+		if(stats->slave_count >= I2C_STATS_MAX_SLAVES)
+			return;
+		slave = &stats->slaves[stats->slave_count++];
+		slave->addr = transaction->slave_addr;
+		slave->min_us = 0xFFFFFFFF;
+	}
+
+	slave->count++;
+	slave->total_us += latency;
+	if(latency < slave->min_us)
+		slave->min_us = latency;
+	if(latency > slave->max_us)
+		slave->max_us = latency;
+}
+
+/*
+ *	-----------------I2C_Stats_Reset------------------
+ *	Clear the statistics of a bus and start a new window
+ *	Input: Bus Handle
+ *	Output: None
+ */
+void I2C_Stats_Reset(I2C_BUS_t* bus){
+
+	I2C_STATS_t* stats = &bus->stats;
+	uint32_t state;
+	uint8_t i;
+
+	state = START_CRITICAL();
+
+	stats->transactions = stats->bytes = stats->nacks = stats->errors = 0;
+	stats->retries = stats->recoveries = stats->busy_us = 0;
+	for(i = 0; i < I2C_STATS_MAX_SLAVES; i++){
+		stats->slaves[i].addr = 0;
+		stats->slaves[i].count = stats->slaves[i].total_us = stats->slaves[i].max_us = 0;
+		stats->slaves[i].min_us = 0xFFFFFFFF;
+	}
+	stats->slave_count = 0;
+	stats->since_us = TIMESTAMP_US();
+
+	END_CRITICAL(state);
+}
+
+/*
+ *	------------------I2C_Stats_Get-------------------
+ *	Take a consistent copy of the statistics of a bus
+ *	Input: Bus Handle & Snapshot to fill
+ *	Output: None
+ */
+void I2C_Stats_Get(I2C_BUS_t* bus, I2C_STATS_t* snapshot){
+	uint32_t state = START_CRITICAL();
+	*snapshot = bus->stats;
+	END_CRITICAL(state);
+}
+
+/*
+ *	------------------I2C_Stats_Dump------------------
+ *	Print a compact summary of a bus through UART0
+ *
+ *	I2C tx=<n> B=<bytes> nack=<n> err=<n> retry=<n> rec=<n> busy=<us> util=<%>
+ *	 <addr> n=<count> min/avg/max=<us>/<us>/<us>
+ *
+ *	Input: Bus Handle
+ *	Output: None
+ */
+void I2C_Stats_Dump(I2C_BUS_t* bus){
+
+	I2C_STATS_t stats;
+	I2C_SLAVE_STATS_t* slave;
+	char stringBuf[160];														//Every counter at 10 digits still fits
+	uint32_t window_us;
+	uint32_t util;
+	uint8_t i;
+
+	I2C_Stats_Get(bus, &stats);
+
+	//Busy time over the window in tenths of a percent (whole ms windows overstate it on short windows)
+	window_us = TIMESTAMP_US() - stats.since_us;
+	util = window_us ? (uint32_t)((uint64_t)stats.busy_us * 1000 / window_us) : 0;
+
+	snprintf(stringBuf, sizeof(stringBuf), "I2C tx=%lu B=%lu nack=%lu err=%lu retry=%lu rec=%lu busy=%lu util=%lu.%lu%%\r\n",
+		(unsigned long)stats.transactions, (unsigned long)stats.bytes, (unsigned long)stats.nacks,
+		(unsigned long)stats.errors, (unsigned long)stats.retries, (unsigned long)stats.recoveries,
+		(unsigned long)stats.busy_us, (unsigned long)(util / 10), (unsigned long)(util % 10));
+	UART0_OutString(stringBuf);
+
+	for(i = 0; i < stats.slave_count; i++){
+		slave = &stats.slaves[i];
+		snprintf(stringBuf, sizeof(stringBuf), " %02X n=%lu min/avg/max=%lu/%lu/%lu\r\n", slave->addr, (unsigned long)slave->count,
+			(unsigned long)slave->min_us, (unsigned long)(slave->total_us / slave->count), (unsigned long)slave->max_us);
+		UART0_OutString(stringBuf);
+	}
+}
+
+#endif //I2C_STATS
@@ -0,0 +1,96 @@
+/*
+ * I2CStats.h
+ *
+ *	Provides bus instrumentation for the I2C transaction engine:
+ *	transaction and byte counters, NACKs, retries, busy time and
+ *	per slave latency. Build with I2C_STATS defined to turn it on,
+ *	without it every hook compiles to nothing
+ *
+ */
+
+#ifndef I2CSTATS_H_
+#define I2CSTATS_H_
+
+#include <stdint.h>
+
+/* List of Instrumentation Macros */
+#define I2C_STATS_MAX_SLAVES	(8)					//Slave addresses tracked per bus
+#define I2C_STATS_DUMP_CHAR		('s')				//UART key that dumps the statistics
+
+/* Per Slave Latency (submit to completion, queueing included) */
+typedef struct{
+	uint8_t addr;
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint32_t total_us;								//avg = total_us/count
+} I2C_SLAVE_STATS_t;
+
+/* Bus Statistics */
+typedef struct{
+	uint32_t transactions;
+	uint32_t bytes;										//Bytes on the wire, address bytes included
+	uint32_t nacks;										//ADRACK and DATACK
+	uint32_t errors;									//ARBLST, CLKTO and TIMEOUT
+	uint32_t retries;									//Submits turned away by a full queue
+	uint32_t recoveries;
+	uint32_t busy_us;									//Time transactions spent on the wire
+	uint32_t since_us;								//Start of the measurement window
+	uint8_t slave_count;
+	I2C_SLAVE_STATS_t slaves[I2C_STATS_MAX_SLAVES];
+} I2C_STATS_t;
+
+#include "I2C.h"
+
+/* Engine Hooks */
+#ifdef I2C_STATS
+#define I2C_STATS_SUBMIT(t)										((t)->submit_us = TIMESTAMP_US())
+#define I2C_STATS_RETRY(bus)									((bus)->stats.retries++)
+#define I2C_STATS_RECOVERY(bus)								((bus)->stats.recoveries++)
+#define I2C_STATS_FINISH(bus, t, status, bytes)	I2C_Stats_Record((bus), (t), (status), (bytes))
+#define I2C_STATS_RESET(bus)									I2C_Stats_Reset(bus)
+#else
+#define I2C_STATS_SUBMIT(t)
+#define I2C_STATS_RETRY(bus)
+#define I2C_STATS_RECOVERY(bus)
+#define I2C_STATS_FINISH(bus, t, status, bytes)
+#define I2C_STATS_RESET(bus)
+#endif
+
+#ifdef I2C_STATS
+
+/*
+ *	----------------I2C_Stats_Record-----------------
+ *	Account for a finished transaction (called by the engine)
+ *	Input: Bus Handle, Transaction, Status & Bytes on the wire
+ *	Output: None
+ */
+void I2C_Stats_Record(I2C_BUS_t* bus, I2C_TRANSACTION_t* transaction, uint8_t status, uint32_t bytes);
+
+/*
+ *	-----------------I2C_Stats_Reset------------------
+ *	Clear the statistics of a bus and start a new window
+ *	Input: Bus Handle
+ *	Output: None
+ */
+void I2C_Stats_Reset(I2C_BUS_t* bus);
+
+/*
+ *	------------------I2C_Stats_Get-------------------
+ *	Take a consistent copy of the statistics of a bus
+ *	Input: Bus Handle & Snapshot to fill
+ *	Output: None
+ */
+void I2C_Stats_Get(I2C_BUS_t* bus, I2C_STATS_t* snapshot);
+
+/*
+ *	------------------I2C_Stats_Dump------------------
+ *	Print a compact summary of a bus through UART0
+ *	Input: Bus Handle
+ *	Output: None
+ */
+void I2C_Stats_Dump(I2C_BUS_t* bus);
+
+#endif //I2C_STATS
+
+#endif //I2CSTATS_H_
@@ -13,6 +13,91 @@
 #include "tm4c123gh6pm.h"
 #include "util.h"
 #include "I2C.h"
+#include "I2CSched.h"
+
+/* Bus the LCD backpack is wired to, set by LCD_Init */
+static I2C_BUS_t* LCD_Bus;
+
+/* Every write is the PCF8574A register byte followed by a 4-byte pattern */
+static uint8_t LCD_Header = PCF8574A_REG;
+
+/* Scheduled Mode (LCD_Attach_Scheduler): every 4-byte pattern is its own job */
+static I2C_SCHED_t* LCD_Sched;
+static I2C_SCHED_CLIENT_t* LCD_Client;
+static I2C_SCHED_JOB_t LCD_Jobs[LCD_JOB_POOL_SIZE];
+static I2C_SEGMENT_t LCD_Job_Segments[LCD_JOB_POOL_SIZE][2];
+static uint8_t LCD_Job_Data[LCD_JOB_POOL_SIZE][4];		//Slot 0 doubles as the blocking mode pattern
+static uint32_t LCD_Job_Index;
+static uint32_t LCD_Next_Release;						//Earliest time the LCD takes the next pattern (us)
+
+/*
+ *	-------------------LCD_Pattern------------------
+ *	Local function that hands out the buffer the next pattern is
+ *	built in. With a scheduler this is the data of the oldest job
+ *	slot (waited for if the pool wrapped around), so the pattern is
+ *	never copied
+ *	Input: None
+ *	Output: 4-byte pattern buffer to fill and pass to LCD_Write
+ */
+static uint8_t* LCD_Pattern(void){
+
+	if(LCD_Sched == 0)
+		return LCD_Job_Data[0];
+
+	I2C_Sched_Wait(LCD_Sched, &LCD_Jobs[LCD_Job_Index]);
+	return LCD_Job_Data[LCD_Job_Index];
+}
+
+/*
+ *	-------------------LCD_Write------------------
+ *	Local function that sends the pattern from LCD_Pattern as one
+ *	transfer behind the register byte. Blocking without a scheduler,
+ *	otherwise the job is released no earlier than LCD_Next_Release
+ *	Input: Pattern to send
+ *	Output: None
+ */
+static void LCD_Write(uint8_t* pattern){
+
+	I2C_SEGMENT_t segments[2] = {{I2C_SEG_WRITE, &LCD_Header, 1}, {I2C_SEG_WRITE, 0, 4}};
+	I2C_SCHED_JOB_t* job;
+	uint32_t now, delay;
+
+	if(LCD_Sched == 0){
+		segments[1].buf = pattern;
+		I2C_Transfer(LCD_Bus, LCD_WRITE_ADDR, segments, 2);
+		return;
+	}
+
+	/* Pattern already sits in the slot LCD_Pattern handed out */
+	job = &LCD_Jobs[LCD_Job_Index];
+	LCD_Job_Index = (LCD_Job_Index + 1) % LCD_JOB_POOL_SIZE;
+
+	job->transaction.slave_addr = LCD_WRITE_ADDR;
+	job->transaction.segments = LCD_Job_Segments[job - LCD_Jobs];
+	job->transaction.seg_count = 2;
+	job->callback = 0;
+
+	/* Space the patterns out instead of busy waiting with the bus held */
+	now = TIMESTAMP_US();
+	delay = ((int32_t)(LCD_Next_Release - now) > 0) ? (LCD_Next_Release - now) : 0;
+	LCD_Next_Release = now + delay + LCD_WRITE_DELAY_US;
+
+	I2C_Sched_Submit(LCD_Sched, LCD_Client, job, delay);
+}
+
+/*
+ *	-------------------LCD_Delay------------------
+ *	Local delay after a command. Blocking without a scheduler,
+ *	otherwise it only pushes back the release of the next pattern
+ *	Input: Delay in ms
+ *	Output: None
+ */
+static void LCD_Delay(uint32_t ms){
+	if(LCD_Sched == 0)
+		DELAY_1MS(ms);
+	else
+		LCD_Next_Release += ms*1000;
+}
 
 /*
  *	-------------------LCD_Send_CMD------------------
@@ -24,7 +109,7 @@ static void LCD_Send_CMD(uint8_t cmd){
 	
 	/* Temp Variables to hold upper and lower value */
 	uint8_t cmd_upper, cmd_lower;
-	uint8_t cmd_array[4];								//Command Array to Burst Transmit
+	uint8_t* cmd_array = LCD_Pattern();	//Command Array to Burst Transmit
 	
 	/* Seperate Upper and Lower Nibble */
 	cmd_upper = UPPER_NIBBLE_MSK & cmd; // use UPPER_NIBBLE_MSK here
@@ -37,7 +122,31 @@ static void LCD_Send_CMD(uint8_t cmd){
 	cmd_array[3] = cmd_lower | BACKLIGHT;
 	
 	/* I2C Burst Transmit Command Array to LCD */
-	I2C0_Burst_Transmit(LCD_WRITE_ADDR, PCF8574A_REG, cmd_array, sizeof(cmd_array));
+	LCD_Write(cmd_array);
+}
+
+/*
+ *	------------------LCD_Send_Nibble------------------
+ *	Local function for the wake-up commands while the LCD is still
+ *	in 8-bit mode: only the upper nibble is clocked in (one EN pulse),
+ *	a second pulse would be taken as an instruction of its own
+ *	Input: Command to send (upper nibble)
+ *	Output: None
+ */
+static void LCD_Send_Nibble(uint8_t cmd){
+	
+	uint8_t cmd_upper;
+	uint8_t* cmd_array = LCD_Pattern();	//Command Array to Burst Transmit
+	
+	cmd_upper = UPPER_NIBBLE_MSK & cmd;
+	
+	/* LCD I2C Message Pattern, EN stays low for the second half */
+	cmd_array[0] = cmd_upper | (BACKLIGHT|EN_Pin);
+	cmd_array[1] = cmd_upper | BACKLIGHT;
+	cmd_array[2] = cmd_upper | BACKLIGHT;
+	cmd_array[3] = cmd_upper | BACKLIGHT;
+	
+	LCD_Write(cmd_array);
 }
 
 /*
@@ -50,7 +159,7 @@ static void LCD_Send_Data(uint8_t data){
 	
 	/* Temp Variables to hold upper and lower value */
 	uint8_t data_upper, data_lower;
-	uint8_t data_array[4];							//Data Array to Burst Transmit
+	uint8_t* data_array = LCD_Pattern();	//Data Array to Burst Transmit
 	
 	/* Seperate Upper and Lower Nibble */
 	data_upper = UPPER_NIBBLE_MSK & data; // use UPPER_NIBBLE_MSK here
@@ -63,26 +172,28 @@ static void LCD_Send_Data(uint8_t data){
 	data_array[3] = data_lower | (BACKLIGHT|RS_Pin);
 	
 	/* I2C Burst Transmit Data Array to LCD */
-	I2C0_Burst_Transmit(LCD_WRITE_ADDR, PCF8574A_REG, data_array, sizeof(data_array));
+	LCD_Write(data_array);
 }
 
 /*
  *	-------------------LCD_Init------------------
  *	Basic LCD Initialization Function
- *	Input: None
+ *	Input: Bus Handle the LCD backpack is on
  *	Output: None
  */
-void LCD_Init(void){
+void LCD_Init(I2C_BUS_t* bus){
+	
+	LCD_Bus = bus;
 	
 	/* Magic LCD Initialization */
 	DELAY_1MS(50);
-	LCD_Send_CMD(INIT_REG_CMD);
+	LCD_Send_Nibble(INIT_REG_CMD);
 	DELAY_1MS(5);
-	LCD_Send_CMD(INIT_REG_CMD);
+	LCD_Send_Nibble(INIT_REG_CMD);
 	DELAY_1MS(1);
-	LCD_Send_CMD(INIT_REG_CMD);
+	LCD_Send_Nibble(INIT_REG_CMD);
 	DELAY_1MS(10);
-	LCD_Send_CMD(INIT_FUNC_CMD);
+	LCD_Send_Nibble(INIT_FUNC_CMD);
 	DELAY_1MS(10);
 	
 	/* 4-Bit Display Mode Initialization */
@@ -115,7 +226,7 @@ void LCD_Init(void){
  */
 void LCD_Clear(void){
 	LCD_Send_CMD(CLEAR_DISP_CMD);
-	DELAY_1MS(1);
+	LCD_Delay(2);
 }
 
 /*
@@ -141,7 +252,7 @@ void LCD_Set_Cursor(uint8_t row, uint8_t col){
 	
 	/* Send Command to set Row and Column */
 	LCD_Send_CMD(col);
-	DELAY_1MS(2);
+	LCD_Delay(2);
 	
 }
 
@@ -153,7 +264,7 @@ void LCD_Set_Cursor(uint8_t row, uint8_t col){
  */
 void LCD_Reset_Cursor(void){
 	LCD_Send_CMD(RETURN_HOME_CMD);
-	DELAY_1MS(1);
+	LCD_Delay(2);
 }
 
 /*
@@ -164,7 +275,7 @@ void LCD_Reset_Cursor(void){
  */
 void LCD_Print_Char(uint8_t data){
 	LCD_Send_Data(data);
-	DELAY_1MS(1);
+	LCD_Delay(1);
 }
 
 /*
@@ -176,6 +287,36 @@ void LCD_Print_Char(uint8_t data){
 void LCD_Print_Str(uint8_t* str){
 	while(*str){
 		LCD_Send_Data(*str++);
-		DELAY_1MS(2);
+		LCD_Delay(2);
 	}
 }
+
+/*
+ *	-------------LCD_Attach_Scheduler-------------
+ *	Hand all further LCD writes to an I2C scheduler. Every command
+ *	and character becomes its own job, so other clients get the bus
+ *	between them, and the command delays become release times
+ *	instead of busy waits. Call after LCD_Init
+ *	Input: Scheduler & Registered Client of the LCD
+ *	Output: None
+ */
+void LCD_Attach_Scheduler(I2C_SCHED_t* sched, I2C_SCHED_CLIENT_t* client){
+
+	uint8_t i;
+
+	//Every slot starts out free, with its segments pointing at its own pattern
+	for(i = 0; i < LCD_JOB_POOL_SIZE; i++){
+		LCD_Jobs[i].transaction.done = 1;
+		LCD_Job_Segments[i][0].flags = I2C_SEG_WRITE;
+		LCD_Job_Segments[i][0].buf = &LCD_Header;
+		LCD_Job_Segments[i][0].len = 1;
+		LCD_Job_Segments[i][1].flags = I2C_SEG_WRITE;
+		LCD_Job_Segments[i][1].buf = LCD_Job_Data[i];
+		LCD_Job_Segments[i][1].len = 4;
+	}
+
+	LCD_Job_Index = 0;
+	LCD_Next_Release = TIMESTAMP_US();
+	LCD_Client = client;
+	LCD_Sched = sched;
+}
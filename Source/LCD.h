@@ -42,8 +42,8 @@
 	
 #define RETURN_HOME_CMD			(0x02)
 
-#define FIRST_ROW_CMD				(0x00)
-#define SECOND_ROW_CMD			(0x40)
+#define FIRST_ROW_CMD				(0x80)				//Set DDRAM Address, row 1 starts at 0x00
+#define SECOND_ROW_CMD			(0xC0)				//Set DDRAM Address, row 2 starts at 0x40
 
 /* LCD Module Macros */
 #define RS_Pin							(0x01)
@@ -58,15 +58,21 @@
 #define ROW2								(1U)
 #define LCD_ROW_SIZE				(16)
 
+/* Scheduled Mode Macros */
+#define LCD_JOB_POOL_SIZE		(2*LCD_ROW_SIZE)	//Patterns that can be in flight
+#define LCD_WRITE_DELAY_US	(50)							//HD44780 execution time of one write
+
 #include <stdint.h>
+#include "I2C.h"
+#include "I2CSched.h"
 
 /*
  *	-------------------LCD_Init------------------
  *	Basic LCD Initialization Function
- *	Input: None
+ *	Input: Bus Handle the LCD backpack is on
  *	Output: None
  */
-void LCD_Init(void);
+void LCD_Init(I2C_BUS_t* bus);
 
 /*
  *	-------------------LCD_Clear------------------
@@ -108,4 +114,15 @@ void LCD_Print_Char(uint8_t data);
  */
 void LCD_Print_Str(uint8_t* str);
 
+/*
+ *	-------------LCD_Attach_Scheduler-------------
+ *	Hand all further LCD writes to an I2C scheduler. Every command
+ *	and character becomes its own job, so other clients get the bus
+ *	between them, and the command delays become release times
+ *	instead of busy waits. Call after LCD_Init
+ *	Input: Scheduler & Registered Client of the LCD
+ *	Output: None
+ */
+void LCD_Attach_Scheduler(I2C_SCHED_t* sched, I2C_SCHED_CLIENT_t* client);
+
 #endif
\ No newline at end of file
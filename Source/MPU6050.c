@@ -11,105 +11,193 @@
  
 #include "MPU6050.h"
 #include "I2C.h"
+#include "RegCache.h"
+#include "RegBatch.h"
+#include "FastMath.h"
 #include "UART0.h"
 #include "tm4c123gh6pm.h"
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
-#define ACCEL_LSB_0_VALUE		(16384.0)
-#define ACCEL_LSB_1_VALUE		(8192.0)
-#define ACCEL_LSB_2_VALUE		(4096.0)
-#define ACCEL_LSB_3_VALUE		(2048.0)
+#define ACCEL_LSB_0_VALUE		(16384.0f)
+#define ACCEL_LSB_1_VALUE		(8192.0f)
+#define ACCEL_LSB_2_VALUE		(4096.0f)
+#define ACCEL_LSB_3_VALUE		(2048.0f)
 
-#define GYRO_LSB_0_VALUE		(131.0)
-#define GYRO_LSB_1_VALUE		(65.5)
-#define GYRO_LSB_2_VALUE		(32.8)
-#define GYRO_LSB_3_VALUE		(16.4)
+#define GYRO_LSB_0_VALUE		(131.0f)
+#define GYRO_LSB_1_VALUE		(65.5f)
+#define GYRO_LSB_2_VALUE		(32.8f)
+#define GYRO_LSB_3_VALUE		(16.4f)
+
+#define TEMP_LSB_VALUE			(340.0f)
+#define TEMP_OFFSET_VALUE		(36.53f)		//Degrees C at a raw reading of 0
+
+#define FS_SEL_SHIFT				(3)					//AFS_SEL / FS_SEL field of ACCEL_CONFIG / GYRO_CONFIG
+#define FS_SEL_MASK					(0x03)
+
+#define GYRO_RATE_HZ				(8000)			//Gyro output rate with the DLPF off
+#define GYRO_RATE_DLPF_HZ		(1000)			//Gyro output rate with the DLPF on
+#define SMPLRT_DIV_MAX			(256)
+#define CONFIG_REG_COUNT		(5)					//Rows of the init table: PWR_MGMT_1, SMPLRT_DIV..ACCEL_CONFIG
+
+#define SCALE_Q_BITS				(16)				//Fraction bits of the integer conversion multipliers
+#define SCALE_Q16(lsb)			((int32_t)(1000.0 * (1 << SCALE_Q_BITS) / (lsb) + 0.5))		//milli-units per LSB
+
+#define AUX_SLAVE_REGS			(3)					//I2C_SLVn_ADDR, _REG, _CTRL
+#define AUX_SLV_LEN_MAX			(15)
+
+#ifndef USE_HIGH
+#define MPU6050_ADDR				MPU6050_ADDR_AD0_LOW
+#else
+#define MPU6050_ADDR				MPU6050_ADDR_AD0_HIGH
+#endif
+
+/* Bus the MPU6050 is wired to, set by MPU6050_Init */
+static I2C_BUS_t* MPU6050_Bus;
+
+/* Shadow copy of the configuration registers, every write goes through it */
+static const uint8_t MPU6050_Cached_Regs[] = {SMPLRT_DIV, CONFIG, GYRO_CONFIG, ACCEL_CONFIG, PWR_MGMT_1};
+static uint8_t MPU6050_Cached_Values[sizeof(MPU6050_Cached_Regs)];
+static REG_CACHE_t MPU6050_Cache;
+
+/* FIFO Stream, set by MPU6050_Fifo_Start */
+static uint8_t MPU6050_Fifo_Sensors;
+static uint8_t MPU6050_Frame_Size;
+
+/* Aux Master, set by MPU6050_Aux_Start */
+static uint8_t MPU6050_Aux_User;											//USER_I2C_MST_EN while running, kept in every USER_CTRL write
+static uint8_t MPU6050_Aux_Len[MPU6050_AUX_SLAVES];
+static uint8_t MPU6050_Aux_Total;
+
+/* Data Ready Acquisition, set by MPU6050_Data_Ready_Start */
+static I2C_TRANSACTION_t MPU6050_DR_Transaction;
+static uint8_t MPU6050_DR_Data[MPU6050_MOTION_DATA_SIZE];
+static uint32_t MPU6050_DR_Timestamp;
+static RING_t* MPU6050_DR_Ring;
+static MPU6050_SAMPLE_CALLBACK_t MPU6050_DR_Callback;
+static volatile uint32_t MPU6050_DR_Missed;
+
+/* Conversion Scales of each full scale range setting, computed at compile time */
+static const float MPU6050_Accel_LSB[4] = {ACCEL_LSB_0_VALUE, ACCEL_LSB_1_VALUE, ACCEL_LSB_2_VALUE, ACCEL_LSB_3_VALUE};
+static const float MPU6050_Gyro_LSB[4] = {GYRO_LSB_0_VALUE, GYRO_LSB_1_VALUE, GYRO_LSB_2_VALUE, GYRO_LSB_3_VALUE};
+static const int32_t MPU6050_Accel_Q16[4] = {SCALE_Q16(ACCEL_LSB_0_VALUE), SCALE_Q16(ACCEL_LSB_1_VALUE),
+																						 SCALE_Q16(ACCEL_LSB_2_VALUE), SCALE_Q16(ACCEL_LSB_3_VALUE)};
+static const int32_t MPU6050_Gyro_Q16[4] = {SCALE_Q16(GYRO_LSB_0_VALUE), SCALE_Q16(GYRO_LSB_1_VALUE),
+																						SCALE_Q16(GYRO_LSB_2_VALUE), SCALE_Q16(GYRO_LSB_3_VALUE)};
+
+/* Gyro bandwidth of each DLPF setting in Hz, the sample rate must be twice that */
+static const uint16_t MPU6050_DLPF_Bandwidth[CONFIG_DFPL_6 + 1] = {256, 188, 98, 42, 20, 10, 5};
+
+/* Scales of the configured ranges, set by MPU6050_Update_Scale (0 while unknown) */
+static float MPU6050_Accel_Scale;
+static float MPU6050_Gyro_Scale;
+static int32_t MPU6050_Accel_mg_Q16;
+static int32_t MPU6050_Gyro_mdps_Q16;
+
+/* Bring-up after reset: wake on the internal clock, then 1kHz sample rate, DLPF off, +-2g and +-250dps as one
+	 burst. The settings the data scaling depends on are read back */
+static const REG_INIT_t MPU6050_Init_Table[CONFIG_REG_COUNT] = {
+	{PWR_MGMT_1,		PWR_CLK_SEL_INTERNAL,		0,	0},
+	{SMPLRT_DIV,		SMPLRT_DIV_8,						0,	0xFF},
+	{CONFIG,				CONFIG_DFPL_0,					0,	0xFF},
+	{GYRO_CONFIG,		GYRO_FS_SEL_0,					0,	0xFF},
+	{ACCEL_CONFIG,	ACCEL_AFS_SEL_0,				0,	0xFF},
+};
 
 /*
- *	-------------------MPU6050_Init---------------------
- *	Basic Initialization Function for MPU6050 @ default settings
+ *	-----------------MPU6050_Update_Scale---------------
+ *	Local function that picks the conversion scales for the
+ *	configured full scale ranges (shadow copy, no bus traffic once
+ *	loaded). Call whenever ACCEL_CONFIG or GYRO_CONFIG change
  *	Input: none
  * 	Output: none
  */
-void MPU6050_Init(void){
+static void MPU6050_Update_Scale(void){
 	
-	uint8_t ret;
-	char stringBuf[10];
+	uint8_t config;
+	uint8_t sel;
 	
-	//If check does not equal to their respected address, MPU is not detected
-	#ifndef USE_HIGH
-	ret = I2C0_Receive(MPU6050_ADDR_AD0_LOW, WHO_AM_I);
-	if(ret != MPU6050_ADDR_AD0_LOW){
-		UART0_OutString("MPU6050 has not been Detected\r\n");
-		return;
+	MPU6050_Accel_Scale = MPU6050_Gyro_Scale = 0.0f;
+	MPU6050_Accel_mg_Q16 = MPU6050_Gyro_mdps_Q16 = 0;
+	
+	if(RegCache_Read(&MPU6050_Cache, ACCEL_CONFIG, &config) == I2C_STATUS_OK){
+		sel = (config >> FS_SEL_SHIFT) & FS_SEL_MASK;
+		MPU6050_Accel_Scale = 1.0f / MPU6050_Accel_LSB[sel];
+		MPU6050_Accel_mg_Q16 = MPU6050_Accel_Q16[sel];
 	}
-	#else
-	ret = I2C0_Receive(MPU6050_ADDR_AD0_HIGH, WHO_AM_I);
-	if(ret != MPU6050_ADDR_AD0_HIGH){
-		UART0_OutString("MPU6050 has not been Detected\r\n");
-		return;
+	if(RegCache_Read(&MPU6050_Cache, GYRO_CONFIG, &config) == I2C_STATUS_OK){
+		sel = (config >> FS_SEL_SHIFT) & FS_SEL_MASK;
+		MPU6050_Gyro_Scale = 1.0f / MPU6050_Gyro_LSB[sel];
+		MPU6050_Gyro_mdps_Q16 = MPU6050_Gyro_Q16[sel];
 	}
-	#endif
-	
-	//Print ID out to terminal
-	sprintf(stringBuf, "ID: %x\r\n", ret);
-	UART0_OutString(stringBuf);
-	
-	UART0_OutString("MPU6050 has been Detected\r\n");
-	UART0_OutString("MPU6050 is initializing\r\n");
+}
+
+/*
+ *	------------------MPU6050_Scale_Q16-----------------
+ *	Local function, one raw reading times a Q16 multiplier, rounded
+ *	to nearest (a single 32x32->64 multiply on the Cortex-M4)
+ *	Input: Raw Reading & Q16 Multiplier
+ * 	Output: Scaled Value
+ */
+static int32_t MPU6050_Scale_Q16(int16_t raw, int32_t mult){
+	return (int32_t)(((int64_t)raw * mult + (1 << (SCALE_Q_BITS - 1))) >> SCALE_Q_BITS);
+}
+
+/*
+ *	-------------------MPU6050_Init---------------------
+ *	Basic Initialization Function for MPU6050 @ default settings
+ *	Input: Bus Handle the MPU6050 is on
+ * 	Output: none
+ */
+void MPU6050_Init(I2C_BUS_t* bus){
 	
-	/* Reset the MPU6050 Module */
-	ret = I2C0_Transmit(MPU6050_ADDR_AD0_LOW, PWR_MGMT_1, PWR_DEVICE_RESET);
-	UART0_OutString("Reset MPU6050\r\n");
+	uint8_t ret;
+	uint8_t reg;
+	char stringBuf[40];
 	
-	/* 0 to wake up sensor */
-	ret = I2C0_Transmit(MPU6050_ADDR_AD0_LOW, PWR_MGMT_1, PWR_CLK_SEL_INTERNAL);
-	if(ret != 0)
-		UART0_OutString("Error On Transmit\r\n");
-	else
-		UART0_OutString("Sensor is awake\r\n");
+	MPU6050_Bus = bus;
+	RegCache_Init(&MPU6050_Cache, bus, MPU6050_ADDR, 0, 0, MPU6050_Cached_Regs, MPU6050_Cached_Values, sizeof(MPU6050_Cached_Regs));
 	
-	/* Set Data Rate to 1kHz */
-	ret = I2C0_Transmit(MPU6050_ADDR_AD0_LOW, SMPLRT_DIV, SMPLRT_DIV_8);
-	if(ret != 0)
-		UART0_OutString("Error On Transmit\r\n");
-	else
-		UART0_OutString("Data Rate is 1kHz\r\n");
+	//If WHO_AM_I does not read back the ID (same for either AD0 address), MPU is not detected
+	ret = I2C_Receive(MPU6050_Bus, MPU6050_ADDR, WHO_AM_I);
+	if(ret != MPU6050_WHO_AM_I_ID){
+		UART0_OutString("MPU6050 has not been Detected\r\n");
+		return;
+	}
 	
-	/* Default Configuration */
-	ret = I2C0_Transmit(MPU6050_ADDR_AD0_LOW, CONFIG, CONFIG_DFPL_0);
-	if(ret != 0)
-		UART0_OutString("Error On Transmit\r\n");
-	else
-		UART0_OutString("Default Configuration\r\n");
+	/* Reset the MPU6050 Module, every register is back at its default */
+	ret = I2C_Transmit(MPU6050_Bus, MPU6050_ADDR, PWR_MGMT_1, PWR_DEVICE_RESET);
+	RegCache_Invalidate(&MPU6050_Cache);
+	MPU6050_Frame_Size = 0;
+	MPU6050_Aux_User = MPU6050_Aux_Total = 0;
+	memset(MPU6050_Aux_Len, 0, sizeof(MPU6050_Aux_Len));
+	reg = PWR_MGMT_1;
 	
-	/* Default config for Accelerometer */
-	ret = I2C0_Transmit(MPU6050_ADDR_AD0_LOW, ACCEL_CONFIG, ACCEL_AFS_SEL_0);
-	if(ret != 0)
-		UART0_OutString("Error On Transmit\r\n");
-	else
-		UART0_OutString("Default Accelerometer Configuration\r\n");
+	/* Wake up and configure from the init table */
+	if(ret == 0)
+		ret = RegCache_Run_Init(&MPU6050_Cache, MPU6050_Init_Table, sizeof(MPU6050_Init_Table)/sizeof(MPU6050_Init_Table[0]), &reg);
+	MPU6050_Update_Scale();
 	
-	/* Default config for Gyroscope */
-	ret = I2C0_Transmit(MPU6050_ADDR_AD0_LOW, GYRO_CONFIG, GYRO_FS_SEL_0);
+	//One status line for the whole bring-up
 	if(ret != 0)
-		UART0_OutString("Error On Transmit\r\n");
+		sprintf(stringBuf, "MPU6050 Init Error %x at Register %x\r\n", ret, reg);
 	else
-		UART0_OutString("Default Gyroscope Configuration\r\n");
-	
-	UART0_OutString("MPU6050 Initialized\r\n");
+		sprintf(stringBuf, "MPU6050 Initialized (ID: %x)\r\n", MPU6050_ADDR);
+	UART0_OutString(stringBuf);
 }
 
 /*
  *	-----------------MPU6050_Get_Accel------------------
  *	Receive Raw Accelerometer Data and store it in the user struct
+ *	(left as is on a bus error)
  *	Input: MPU6050 Accel User Instance Struct
  * 	Output: none
  */
 void MPU6050_Get_Accel(MPU6050_ACCEL_t* Accel_Instance){
 	
 	/* Local Variables */
+	REG_BATCH_t batch;
 	uint8_t ACCEL_X_LOW;
 	uint8_t ACCEL_X_HIGH;
 	uint8_t ACCEL_Y_LOW;
@@ -117,18 +205,16 @@ void MPU6050_Get_Accel(MPU6050_ACCEL_t* Accel_Instance){
 	uint8_t ACCEL_Z_LOW;
 	uint8_t ACCEL_Z_HIGH;
 	
-	
-
-	
-	/* Grab 16-bit Accel data of each axis by reading ACCEL data register using I2C*/
-	//CODE_FILL
-	
-	ACCEL_X_HIGH = I2C0_Receive(MPU6050_ADDR_AD0_LOW, ACCEL_XOUT_H);
-	ACCEL_X_LOW = I2C0_Receive(MPU6050_ADDR_AD0_LOW, ACCEL_XOUT_L);
-	ACCEL_Y_HIGH = I2C0_Receive(MPU6050_ADDR_AD0_LOW, ACCEL_YOUT_H);
-	ACCEL_Y_LOW = I2C0_Receive(MPU6050_ADDR_AD0_LOW, ACCEL_YOUT_L);
-	ACCEL_Z_HIGH = I2C0_Receive(MPU6050_ADDR_AD0_LOW, ACCEL_ZOUT_H);
-	ACCEL_Z_LOW = I2C0_Receive(MPU6050_ADDR_AD0_LOW, ACCEL_ZOUT_L);
+	/* Grab 16-bit Accel data of each axis by reading ACCEL data register using I2C, all six in one burst */
+	RegBatch_Init(&batch, MPU6050_Bus, MPU6050_ADDR, 0, 0, REG_BATCH_DEFAULT_GAP);
+	RegBatch_Add(&batch, ACCEL_XOUT_H, &ACCEL_X_HIGH);
+	RegBatch_Add(&batch, ACCEL_XOUT_L, &ACCEL_X_LOW);
+	RegBatch_Add(&batch, ACCEL_YOUT_H, &ACCEL_Y_HIGH);
+	RegBatch_Add(&batch, ACCEL_YOUT_L, &ACCEL_Y_LOW);
+	RegBatch_Add(&batch, ACCEL_ZOUT_H, &ACCEL_Z_HIGH);
+	RegBatch_Add(&batch, ACCEL_ZOUT_L, &ACCEL_Z_LOW);
+	if(RegBatch_Run(&batch) != I2C_STATUS_OK)
+		return;
 	
 
 	/* Concatanate and Save Into Accelerometer Struct Instance */
@@ -141,12 +227,14 @@ void MPU6050_Get_Accel(MPU6050_ACCEL_t* Accel_Instance){
 /*
  *	-----------------MPU6050_Get_Gyro-------------------
  *	Receive Raw Gyroscope Data and store it in the user struct
+ *	(left as is on a bus error)
  *	Input: MPU6050 Gyro User Instance Struct
  * 	Output: none
  */
 void MPU6050_Get_Gyro(MPU6050_GYRO_t* Gyro_Instance){
 		
 	/* Local Variables */
+	REG_BATCH_t batch;
 	uint8_t GYRO_X_LOW;
 	uint8_t GYRO_X_HIGH;
 	uint8_t GYRO_Y_LOW;
@@ -154,14 +242,16 @@ void MPU6050_Get_Gyro(MPU6050_GYRO_t* Gyro_Instance){
 	uint8_t GYRO_Z_LOW;
 	uint8_t GYRO_Z_HIGH;
 	
-	/* Grab 16-but Gyro Data of each Axis y reading GYRO data register using I2C*/
-	//CODE_FILL
-	GYRO_X_HIGH = I2C0_Receive(MPU6050_ADDR_AD0_LOW, GYRO_XOUT_H);
-	GYRO_X_LOW = I2C0_Receive(MPU6050_ADDR_AD0_LOW, GYRO_XOUT_L);
-	GYRO_Y_HIGH = I2C0_Receive(MPU6050_ADDR_AD0_LOW, GYRO_YOUT_H);
-	GYRO_Y_LOW = I2C0_Receive(MPU6050_ADDR_AD0_LOW, GYRO_YOUT_L);
-	GYRO_Z_HIGH = I2C0_Receive(MPU6050_ADDR_AD0_LOW, GYRO_ZOUT_H);
-	GYRO_Z_LOW = I2C0_Receive(MPU6050_ADDR_AD0_LOW, GYRO_ZOUT_L);
+	/* Grab 16-but Gyro Data of each Axis y reading GYRO data register using I2C, all six in one burst */
+	RegBatch_Init(&batch, MPU6050_Bus, MPU6050_ADDR, 0, 0, REG_BATCH_DEFAULT_GAP);
+	RegBatch_Add(&batch, GYRO_XOUT_H, &GYRO_X_HIGH);
+	RegBatch_Add(&batch, GYRO_XOUT_L, &GYRO_X_LOW);
+	RegBatch_Add(&batch, GYRO_YOUT_H, &GYRO_Y_HIGH);
+	RegBatch_Add(&batch, GYRO_YOUT_L, &GYRO_Y_LOW);
+	RegBatch_Add(&batch, GYRO_ZOUT_H, &GYRO_Z_HIGH);
+	RegBatch_Add(&batch, GYRO_ZOUT_L, &GYRO_Z_LOW);
+	if(RegBatch_Run(&batch) != I2C_STATUS_OK)
+		return;
 	
 	/* Concatanate and Save Into Gyro Struct Instance */
 	//CODE_FILL
@@ -170,96 +260,469 @@ void MPU6050_Get_Gyro(MPU6050_GYRO_t* Gyro_Instance){
 	(*Gyro_Instance).Gz_RAW = (GYRO_Z_HIGH << 8) + GYRO_Z_LOW;
 }
 
+/*
+ *	---------------MPU6050_Unpack_Motion----------------
+ *	Fill the raw fields of the user structs from the 14 bytes at
+ *	ACCEL_XOUT_H
+ *	Input: Data, MPU6050 Accel, Gyro & Temp User Instance Structs (Temp can be 0)
+ * 	Output: none
+ */
+void MPU6050_Unpack_Motion(const uint8_t* data, MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_TEMP_t* Temp_Instance){
+	
+	/* Concatanate and Save Into the Struct Instances */
+	Accel_Instance->Ax_RAW = (data[0] << 8) + data[1];
+	Accel_Instance->Ay_RAW = (data[2] << 8) + data[3];
+	Accel_Instance->Az_RAW = (data[4] << 8) + data[5];
+	if(Temp_Instance)
+		Temp_Instance->Temp_RAW = (data[6] << 8) + data[7];
+	Gyro_Instance->Gx_RAW = (data[8] << 8) + data[9];
+	Gyro_Instance->Gy_RAW = (data[10] << 8) + data[11];
+	Gyro_Instance->Gz_RAW = (data[12] << 8) + data[13];
+}
+
+/*
+ *	-----------------MPU6050_Get_Motion-----------------
+ *	Receive Raw Accelerometer, Temperature and Gyroscope Data as
+ *	one 14-byte burst (ACCEL_XOUT_H..GYRO_ZOUT_L), so every value
+ *	comes from the same sample. Structs are left as is on a bus error
+ *	Input: MPU6050 Accel, Gyro & Temp User Instance Structs (Temp can be 0)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Get_Motion(MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_TEMP_t* Temp_Instance){
+	
+	uint8_t data[MPU6050_MOTION_DATA_SIZE];	//Big endian pairs: Ax, Ay, Az, Temp, Gx, Gy, Gz
+	uint8_t ret;
+	
+	ret = I2C_Burst_Receive(MPU6050_Bus, MPU6050_ADDR, ACCEL_XOUT_H, data, MPU6050_MOTION_DATA_SIZE);
+	if(ret != I2C_STATUS_OK)
+		return ret;
+	
+	MPU6050_Unpack_Motion(data, Accel_Instance, Gyro_Instance, Temp_Instance);
+	return I2C_STATUS_OK;
+}
+
+/*
+ *	-------------MPU6050_Motion_Transaction-------------
+ *	Fill in a transaction descriptor for the same burst as
+ *	MPU6050_Get_Motion, for callers that run it themselves (e.g.
+ *	through the I2C scheduler). Turn the data into samples with
+ *	MPU6050_Unpack_Motion once it is done
+ *	Input: Transaction Descriptor & Data Buffer (MPU6050_MOTION_DATA_SIZE bytes)
+ * 	Output: none
+ */
+void MPU6050_Motion_Transaction(I2C_TRANSACTION_t* transaction, uint8_t* data){
+	
+	memset(transaction, 0, sizeof(*transaction));
+	transaction->slave_addr = MPU6050_ADDR;
+	transaction->slave_reg_addr = ACCEL_XOUT_H;
+	transaction->rx_data = data;
+	transaction->rx_size = MPU6050_MOTION_DATA_SIZE;
+	transaction->done = 1;
+}
+
+/*
+ *	-----------------MPU6050_Fifo_Reset-----------------
+ *	Local function that empties the FIFO and lets it fill again
+ *	(the reset only takes while the FIFO is disabled)
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+static uint8_t MPU6050_Fifo_Reset(void){
+	
+	uint8_t ret;
+	
+	ret = RegCache_Write(&MPU6050_Cache, USER_CTRL, MPU6050_Aux_User | USER_FIFO_RESET);
+	if(ret == 0)
+		ret = RegCache_Write(&MPU6050_Cache, USER_CTRL, MPU6050_Aux_User | USER_FIFO_EN);
+	return ret;
+}
+
+/*
+ *	-----------------MPU6050_Fifo_Start-----------------
+ *	Stream samples through the hardware FIFO: the chosen sensors
+ *	go in as one frame per sample (register order: accel, temp,
+ *	gyro X, Y, Z, then aux slaves 0..2), at the rate set by SMPLRT_DIV
+ *	Input: Sensors to stream (FIFO_EN_* bits, FIFO_EN_SLVn needs
+ *				 that aux slave running)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Fifo_Start(uint8_t sensors){
+	
+	uint8_t ret;
+	uint8_t i;
+	
+	/* Asserting Param: aux slaves only once they are read */
+	for(i = 0; i < 3; i++){
+		if((sensors & (FIFO_EN_SLV0 << i)) && MPU6050_Aux_Len[i] == 0)
+			return I2C_STATUS_INVALID;
+	}
+	if(sensors == 0)
+		return I2C_STATUS_INVALID;
+	
+	MPU6050_Fifo_Sensors = sensors;
+	MPU6050_Frame_Size = ((sensors & FIFO_EN_ACCEL) ? 6 : 0) + ((sensors & FIFO_EN_TEMP) ? 2 : 0) +
+											 ((sensors & FIFO_EN_XG) ? 2 : 0) + ((sensors & FIFO_EN_YG) ? 2 : 0) + ((sensors & FIFO_EN_ZG) ? 2 : 0);
+	for(i = 0; i < 3; i++){
+		if(sensors & (FIFO_EN_SLV0 << i))
+			MPU6050_Frame_Size += MPU6050_Aux_Len[i];
+	}
+	
+	//Stop, pick the sensors, then start from an empty FIFO
+	ret = RegCache_Write(&MPU6050_Cache, USER_CTRL, MPU6050_Aux_User);
+	if(ret == 0)
+		ret = RegCache_Write(&MPU6050_Cache, FIFO_EN, sensors);
+	if(ret == 0)
+		ret = MPU6050_Fifo_Reset();
+	if(ret != 0)
+		MPU6050_Frame_Size = 0;
+	
+	return ret;
+}
+
+/*
+ *	-----------------MPU6050_Fifo_Stop------------------
+ *	Stop streaming, the FIFO is left as is
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Fifo_Stop(void){
+	MPU6050_Frame_Size = 0;
+	return RegCache_Write(&MPU6050_Cache, USER_CTRL, MPU6050_Aux_User);
+}
+
+/*
+ *	-------------MPU6050_Fifo_Frame_Size----------------
+ *	Bytes per frame of the running stream
+ *	Input: none
+ * 	Output: Frame Size (0 if not streaming)
+ */
+uint8_t MPU6050_Fifo_Frame_Size(void){
+	return MPU6050_Frame_Size;
+}
+
+/*
+ *	-----------------MPU6050_Fifo_Read------------------
+ *	Drain whole frames into the buffer with one burst read. A FIFO
+ *	that filled up has lost bytes and its frame boundaries: it is
+ *	reset and the next read starts on a frame again
+ *	Input: Buffer (max_frames*Frame Size bytes), Most Frames to take
+ *				 & Frames Read (filled)
+ * 	Output: Any Errors if detected, MPU6050_FIFO_OVERFLOW after a
+ *					reset, otherwise 0
+ */
+uint8_t MPU6050_Fifo_Read(uint8_t* buf, uint16_t max_frames, uint16_t* frames){
+	
+	uint8_t count_data[2];
+	uint16_t count;
+	uint16_t n;
+	uint8_t ret;
+	
+	*frames = 0;
+	
+	/* Asserting Param */
+	if(MPU6050_Frame_Size == 0)
+		return I2C_STATUS_INVALID;
+	
+	ret = I2C_Burst_Receive(MPU6050_Bus, MPU6050_ADDR, FIFO_COUNTH, count_data, 2);
+	if(ret != I2C_STATUS_OK)
+		return ret;
+	count = (count_data[0] << 8) + count_data[1];
+	
+	/* Full means the oldest bytes were overwritten one at a time, there is no telling where a frame starts */
+	if(count >= MPU6050_FIFO_SIZE){
+		ret = MPU6050_Fifo_Reset();
+		return (ret != I2C_STATUS_OK) ? ret : MPU6050_FIFO_OVERFLOW;
+	}
+	
+	//Only whole frames, a frame still being written stays for the next read
+	n = count / MPU6050_Frame_Size;
+	if(n > max_frames)
+		n = max_frames;
+	if(n == 0)
+		return I2C_STATUS_OK;
+	
+	/* FIFO_R_W doesn't auto-increment, the whole burst comes out of the FIFO */
+	ret = I2C_Burst_Receive(MPU6050_Bus, MPU6050_ADDR, FIFO_R_W, buf, (uint32_t)n*MPU6050_Frame_Size);
+	if(ret == I2C_STATUS_OK)
+		*frames = n;
+	
+	return ret;
+}
+
+/*
+ *	----------------MPU6050_Fifo_Unpack-----------------
+ *	Fill the raw fields of the user structs from one FIFO frame,
+ *	sensors that aren't streamed are left as is. Streamed aux slave
+ *	bytes end the frame, after the gyro
+ *	Input: Frame, MPU6050 Accel, Gyro & Temp User Instance Structs (any can be 0)
+ * 	Output: none
+ */
+void MPU6050_Fifo_Unpack(const uint8_t* frame, MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_TEMP_t* Temp_Instance){
+	
+	uint8_t sensors = MPU6050_Fifo_Sensors;
+	
+	/* Same order the MPU6050 writes them in */
+	if(sensors & FIFO_EN_ACCEL){
+		if(Accel_Instance){
+			Accel_Instance->Ax_RAW = (frame[0] << 8) + frame[1];
+			Accel_Instance->Ay_RAW = (frame[2] << 8) + frame[3];
+			Accel_Instance->Az_RAW = (frame[4] << 8) + frame[5];
+		}
+		frame += 6;
+	}
+	if(sensors & FIFO_EN_TEMP){
+		if(Temp_Instance)
+			Temp_Instance->Temp_RAW = (frame[0] << 8) + frame[1];
+		frame += 2;
+	}
+	if(sensors & FIFO_EN_XG){
+		if(Gyro_Instance)
+			Gyro_Instance->Gx_RAW = (frame[0] << 8) + frame[1];
+		frame += 2;
+	}
+	if(sensors & FIFO_EN_YG){
+		if(Gyro_Instance)
+			Gyro_Instance->Gy_RAW = (frame[0] << 8) + frame[1];
+		frame += 2;
+	}
+	if((sensors & FIFO_EN_ZG) && Gyro_Instance)
+		Gyro_Instance->Gz_RAW = (frame[0] << 8) + frame[1];
+}
+
+/*
+ *	-----------MPU6050_Data_Ready_Complete--------------
+ *	Local function, bus ISR completion of the data ready read:
+ *	turns the 14 bytes into a sample record and hands it on
+ *	Input: Transaction
+ * 	Output: none
+ */
+static void MPU6050_Data_Ready_Complete(I2C_TRANSACTION_t* transaction){
+	
+	const uint8_t* data = MPU6050_DR_Data;
+	SAMPLE_t sample;
+	uint8_t i;
+	
+	if(transaction->status != I2C_STATUS_OK){
+		MPU6050_DR_Missed++;
+		return;
+	}
+	
+	memset(&sample, 0, sizeof(sample));
+	sample.timestamp_us = MPU6050_DR_Timestamp;
+	sample.flags = SAMPLE_MOTION;
+	for(i = 0; i < 3; i++){
+		sample.accel[i] = (int16_t)((data[2*i] << 8) + data[2*i + 1]);
+		sample.gyro[i] = (int16_t)((data[8 + 2*i] << 8) + data[8 + 2*i + 1]);
+	}
+	sample.temp = (int16_t)((data[6] << 8) + data[7]);
+	
+	if(MPU6050_DR_Ring)
+		Ring_Push(MPU6050_DR_Ring, &sample, 1);
+	if(MPU6050_DR_Callback)
+		MPU6050_DR_Callback(&sample);
+}
+
+/*
+ *	-----------------GPIOPortE_Handler------------------
+ *	PE1 rising edge: a new sample is in the data registers, queue
+ *	the burst read and return (it runs from the bus ISR)
+ *	Input: none
+ * 	Output: none
+ */
+void GPIOPortE_Handler(void){
+	
+	GPIO_PORTE_ICR_R = MPU6050_INT_PIN;											//Acknowledge PE1
+	
+	/* One read per sample: if the last one is still going this sample is lost */
+	if(!MPU6050_DR_Transaction.done){
+		MPU6050_DR_Missed++;
+		return;
+	}
+	
+	MPU6050_DR_Timestamp = TIMESTAMP_US();
+	if(I2C_Submit(MPU6050_Bus, &MPU6050_DR_Transaction) != I2C_STATUS_OK){
+		MPU6050_DR_Transaction.done = 1;												//Never queued, free for the next edge
+		MPU6050_DR_Missed++;
+	}
+}
+
+/*
+ *	--------------MPU6050_Data_Ready_Start--------------
+ *	Interrupt driven acquisition: the MPU6050 pulses INT once per
+ *	sample, the PE1 edge interrupt queues one 14-byte burst read and
+ *	its completion hands the sample (SAMPLE_MOTION, raw values) to
+ *	the ring and the callback. Nothing is polled
+ *	Input: Ring to push SAMPLE_t records to & Callback (either can be 0)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Data_Ready_Start(RING_t* ring, MPU6050_SAMPLE_CALLBACK_t callback){
+	
+	uint8_t ret;
+	
+	/* Asserting Param: MPU6050_Init has to pick the bus first */
+	if(MPU6050_Bus == 0)
+		return I2C_STATUS_INVALID;
+	
+	GPIO_PORTE_IM_R &= ~MPU6050_INT_PIN;										//Disarm while setting up
+	
+	MPU6050_DR_Ring = ring;
+	MPU6050_DR_Callback = callback;
+	MPU6050_DR_Missed = 0;
+	
+	/* One fixed read: ACCEL_XOUT_H..GYRO_ZOUT_L */
+	MPU6050_Motion_Transaction(&MPU6050_DR_Transaction, MPU6050_DR_Data);
+	MPU6050_DR_Transaction.callback = MPU6050_Data_Ready_Complete;
+	
+	/* PE1 as a rising edge interrupt input */
+	SYSCTL_RCGCGPIO_R |= EN_GPIOE_CLOCK;
+	while((SYSCTL_PRGPIO_R&EN_GPIOE_CLOCK) != EN_GPIOE_CLOCK);
+	GPIO_PORTE_AMSEL_R &= ~MPU6050_INT_PIN;									//disable analog function
+	GPIO_PORTE_PCTL_R &= ~(0x000000F0);											//GPIO clear bit PCTL
+	GPIO_PORTE_DIR_R &= ~MPU6050_INT_PIN;										//PE1 as Input
+	GPIO_PORTE_AFSEL_R &= ~MPU6050_INT_PIN;									//no alternate function
+	GPIO_PORTE_DEN_R |= MPU6050_INT_PIN;										//enable digital pin PE1
+	GPIO_PORTE_IS_R &= ~MPU6050_INT_PIN;										//edge sensitive
+	GPIO_PORTE_IBE_R &= ~MPU6050_INT_PIN;										//single edge
+	GPIO_PORTE_IEV_R |= MPU6050_INT_PIN;										//rising edge
+	GPIO_PORTE_ICR_R = MPU6050_INT_PIN;											//clear a stale flag
+	GPIO_PORTE_IM_R |= MPU6050_INT_PIN;											//arm PE1
+	
+	((volatile uint8_t*)&NVIC_PRI0_R)[MPU6050_INT_IRQ] = MPU6050_INT_PRIORITY << 5;
+	NVIC_EN0_R = 1U << MPU6050_INT_IRQ;
+	
+	/* Active high push-pull 50us pulse per sample, nothing to clear afterwards */
+	ret = RegCache_Write(&MPU6050_Cache, INT_PIN_CFG, 0);
+	if(ret == 0)
+		ret = RegCache_Write(&MPU6050_Cache, INT_ENABLE, INT_DATA_RDY_EN);
+	if(ret != 0)
+		GPIO_PORTE_IM_R &= ~MPU6050_INT_PIN;
+	
+	return ret;
+}
+
+/*
+ *	--------------MPU6050_Data_Ready_Stop---------------
+ *	Disarm PE1 and the data ready interrupt, a read already on the
+ *	bus still completes
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Data_Ready_Stop(void){
+	GPIO_PORTE_IM_R &= ~MPU6050_INT_PIN;
+	return RegCache_Write(&MPU6050_Cache, INT_ENABLE, 0);
+}
+
+/*
+ *	-------------MPU6050_Data_Ready_Missed--------------
+ *	Samples skipped because the read of the previous one was still
+ *	running (or failed), since MPU6050_Data_Ready_Start
+ *	Input: none
+ * 	Output: Missed Samples
+ */
+uint32_t MPU6050_Data_Ready_Missed(void){
+	return MPU6050_DR_Missed;
+}
+
 /*
  *	---------------MPU6050_Process_Accel----------------
- *	Process Raw Accelerometer Data into usable data and store
- *	it in the user stuct
+ *	Process Raw Accelerometer Data into g and store it in the user
+ *	struct: one multiply per axis by the scale picked when the full
+ *	scale range was configured. Matches dividing by the LSB value
+ *	exactly (the LSB values are powers of two). Left as is while the
+ *	range isn't known
  *	Input: MPU6050 Accel User Instance Struct
  * 	Output: none
  */
 void MPU6050_Process_Accel(MPU6050_ACCEL_t* Accel_Instance){
 	
-	char LSB_Sensitivity;
-	
-	//Read LSB Sensitivity Setting from ACCEL_CONFIG Register
-	#ifndef USE_HIGH
-		LSB_Sensitivity = I2C0_Receive(MPU6050_ADDR_AD0_LOW, ACCEL_CONFIG);
-	#else
-		LSB_Sensitivity = I2C0_Receive(MPU6050_ADDR_AD0_HIGH, ACCEL_CONFIG);
-	#endif
-	
-	//Based on setting, process raw data accordingly
-	switch(LSB_Sensitivity){
-		case ACCEL_AFS_SEL_0:
-			Accel_Instance->Ax = (float)Accel_Instance->Ax_RAW / ACCEL_LSB_0_VALUE;
-			Accel_Instance->Ay = (float)Accel_Instance->Ay_RAW / ACCEL_LSB_0_VALUE;
-			Accel_Instance->Az = (float)Accel_Instance->Az_RAW / ACCEL_LSB_0_VALUE;
-			break;
-		case ACCEL_AFS_SEL_1:
-			Accel_Instance->Ax = (float)Accel_Instance->Ax_RAW / ACCEL_LSB_1_VALUE;
-			Accel_Instance->Ay = (float)Accel_Instance->Ay_RAW / ACCEL_LSB_1_VALUE;
-			Accel_Instance->Az = (float)Accel_Instance->Az_RAW / ACCEL_LSB_1_VALUE;
-			break;
-		case ACCEL_AFS_SEL_2:
-			Accel_Instance->Ax = (float)Accel_Instance->Ax_RAW / ACCEL_LSB_2_VALUE;
-			Accel_Instance->Ay = (float)Accel_Instance->Ay_RAW / ACCEL_LSB_2_VALUE;
-			Accel_Instance->Az = (float)Accel_Instance->Az_RAW / ACCEL_LSB_2_VALUE;
-			break;
-		case ACCEL_AFS_SEL_3:
-			Accel_Instance->Ax = (float)Accel_Instance->Ax_RAW / ACCEL_LSB_3_VALUE;
-			Accel_Instance->Ay = (float)Accel_Instance->Ay_RAW / ACCEL_LSB_3_VALUE;
-			Accel_Instance->Az = (float)Accel_Instance->Az_RAW / ACCEL_LSB_3_VALUE;
-			break;
-	}
+	float scale = MPU6050_Accel_Scale;
+	
+	if(scale == 0.0f)
+		return;
+	
+	Accel_Instance->Ax = (float)Accel_Instance->Ax_RAW * scale;
+	Accel_Instance->Ay = (float)Accel_Instance->Ay_RAW * scale;
+	Accel_Instance->Az = (float)Accel_Instance->Az_RAW * scale;
 }
 
 /*
  *	---------------MPU6050_Process_Gyro----------------
- *	Process Raw Gyroscope Data into usable data and store it in
- *	the user struct
+ *	Process Raw Gyroscope Data into degrees/s and store it in the
+ *	user struct: one multiply per axis by the reciprocal picked when
+ *	the full scale range was configured. Within 2 ulp (relative
+ *	2.4e-7) of dividing by the LSB value. Left as is while the range
+ *	isn't known
  *	Input: MPU6050 Gyro User Instance Struct
  * 	Output: none
  */
 void MPU6050_Process_Gyro(MPU6050_GYRO_t* Gyro_Instance){
 	
-	char LSB_Sensitivity;
-	
-	//Read LSB Sensitivity Setting from GYRO_CONFIG Register
-	#ifndef USE_HIGH
-		LSB_Sensitivity = I2C0_Receive(MPU6050_ADDR_AD0_LOW, ACCEL_CONFIG);
-	#else
-		LSB_Sensitivity = I2C0_Receive(MPU6050_ADDR_AD0_HIGH, ACCEL_CONFIG);
-	#endif
-	
-	//Based on setting, process raw data accordingly
-	switch(LSB_Sensitivity){
-		case GYRO_FS_SEL_0:
-			Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW / GYRO_LSB_0_VALUE;
-			Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW / GYRO_LSB_0_VALUE;
-			Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW / GYRO_LSB_0_VALUE;
-			break;
-		case GYRO_FS_SEL_1:
-			Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW / GYRO_LSB_1_VALUE;
-			Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW / GYRO_LSB_1_VALUE;
-			Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW / GYRO_LSB_1_VALUE;
-			break;
-		case GYRO_FS_SEL_2:
-			Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW / GYRO_LSB_2_VALUE;
-			Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW / GYRO_LSB_2_VALUE;
-			Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW / GYRO_LSB_2_VALUE;
-			break;
-		case GYRO_FS_SEL_3:
-			Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW / GYRO_LSB_3_VALUE;
-			Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW / GYRO_LSB_3_VALUE;
-			Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW / GYRO_LSB_3_VALUE;
-			break;
-	}
+	float scale = MPU6050_Gyro_Scale;
+	
+	if(scale == 0.0f)
+		return;
+	
+	Gyro_Instance->Gx = (float)Gyro_Instance->Gx_RAW * scale;
+	Gyro_Instance->Gy = (float)Gyro_Instance->Gy_RAW * scale;
+	Gyro_Instance->Gz = (float)Gyro_Instance->Gz_RAW * scale;
+}
+
+/*
+ *	-------------MPU6050_Process_Accel_mg---------------
+ *	Integer only Accelerometer conversion into milli-g: one Q16
+ *	multiply and shift per axis, rounded to nearest. Within +-1 mg
+ *	of the float result. Left as is while the range isn't known
+ *	Input: MPU6050 Accel User Instance Struct & milli-g Struct
+ * 	Output: none
+ */
+void MPU6050_Process_Accel_mg(const MPU6050_ACCEL_t* Accel_Instance, MPU6050_ACCEL_MG_t* Accel_mg){
+	
+	int32_t mult = MPU6050_Accel_mg_Q16;
+	
+	if(mult == 0)
+		return;
+	
+	Accel_mg->Ax = MPU6050_Scale_Q16(Accel_Instance->Ax_RAW, mult);
+	Accel_mg->Ay = MPU6050_Scale_Q16(Accel_Instance->Ay_RAW, mult);
+	Accel_mg->Az = MPU6050_Scale_Q16(Accel_Instance->Az_RAW, mult);
+}
+
+/*
+ *	------------MPU6050_Process_Gyro_mdps---------------
+ *	Integer only Gyroscope conversion into milli-degrees/s: one Q16
+ *	multiply and shift per axis, rounded to nearest. Within +-1 mdps
+ *	of the float result. Left as is while the range isn't known
+ *	Input: MPU6050 Gyro User Instance Struct & milli-dps Struct
+ * 	Output: none
+ */
+void MPU6050_Process_Gyro_mdps(const MPU6050_GYRO_t* Gyro_Instance, MPU6050_GYRO_MDPS_t* Gyro_mdps){
+	
+	int32_t mult = MPU6050_Gyro_mdps_Q16;
+	
+	if(mult == 0)
+		return;
+	
+	Gyro_mdps->Gx = MPU6050_Scale_Q16(Gyro_Instance->Gx_RAW, mult);
+	Gyro_mdps->Gy = MPU6050_Scale_Q16(Gyro_Instance->Gy_RAW, mult);
+	Gyro_mdps->Gz = MPU6050_Scale_Q16(Gyro_Instance->Gz_RAW, mult);
+}
+
+/*
+ *	---------------MPU6050_Process_Temp----------------
+ *	Process Raw Temperature Data into degrees C and store it in
+ *	the user struct
+ *	Input: MPU6050 Temp User Instance Struct
+ * 	Output: none
+ */
+void MPU6050_Process_Temp(MPU6050_TEMP_t* Temp_Instance){
+	Temp_Instance->Temp = (float)Temp_Instance->Temp_RAW * (1.0f / TEMP_LSB_VALUE) + TEMP_OFFSET_VALUE;
 }
 
 /*
  *	-----------------MPU6050_Get_Angle-----------------
- *	Calculate Tilt Angle using processed Accelerometer and
- *	Gyroscope data and it in the user angle struct
+ *	Calculate Tilt Angle from processed Accelerometer data alone
+ *	and store it in the user angle struct (the gyro isn't used,
+ *	Tilt_Update in Tilt.h blends both for a steady roll/pitch)
  *	Input: MPU6050 Angle User Instance Struct
  * 	Output: none
  */
@@ -276,7 +739,345 @@ void MPU6050_Get_Angle(MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Ins
 	(*Angle_Instance).ArY *= RAD_TO_DEGREE_CONV;
 }
 
-/* Used for Debugging Purposes */
+/*
+ *	---------------MPU6050_Get_Angle_Fast---------------
+ *	Same tilt angles as MPU6050_Get_Angle, single precision through
+ *	the FastMath kernels (atan2 and hypot in place of double atan,
+ *	divide and sqrt). Within 0.001 degree of MPU6050_Get_Angle, and
+ *	a level or zero reading gives 0 or 90 instead of NaN. Gyro is
+ *	not used, it is there so this drops in for MPU6050_Get_Angle
+ *	Input: MPU6050 Accel, Gyro & Angle User Instance Structs
+ * 	Output: none
+ */
+void MPU6050_Get_Angle_Fast(MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_ANGLE_t* Angle_Instance){
+	
+	const float rad_to_degree = (float)RAD_TO_DEGREE_CONV;
+	float ax = Accel_Instance->Ax;
+	float ay = Accel_Instance->Ay;
+	float az = Accel_Instance->Az;
+	float rz = FastMath_Hypot(ax, ay);
+	
+	(void)Gyro_Instance;
+	
+	//atan(a/b) with b >= 0 is atan2(a, b), no divide by zero
+	Angle_Instance->ArX = FastMath_Atan2(ax, FastMath_Hypot(ay, az)) * rad_to_degree;
+	Angle_Instance->ArY = FastMath_Atan2(ay, FastMath_Hypot(ax, az)) * rad_to_degree;
+	
+	//atan(rz/Az) takes the sign of Az, keep it that way
+	if(az < 0.0f)
+		Angle_Instance->ArZ = -FastMath_Atan2(rz, -az) * rad_to_degree;
+	else
+		Angle_Instance->ArZ = FastMath_Atan2(rz, az) * rad_to_degree;
+}
+
+/*
+ *	--------------MPU6050_Refresh_Config---------------
+ *	Reload the shadow copy of the configuration registers and the
+ *	conversion scales, call it after the MPU6050 was reset, power
+ *	cycled or reconfigured behind the driver
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Refresh_Config(void){
+	
+	uint8_t ret;
+	
+	ret = RegCache_Refresh(&MPU6050_Cache);
+	MPU6050_Update_Scale();
+	return ret;
+}
+
+/*
+ *	-----------------MPU6050_Aux_Start------------------
+ *	Hand secondary sensors to the MPU6050's aux I2C master: from
+ *	the next sample on, each is read right after the IMU sample and
+ *	DATA_RDY waits for it. Their bytes come back behind the gyro in
+ *	MPU6050_Get_Motion_Aux, and through the FIFO (FIFO_EN_SLV0..2).
+ *	Not while the FIFO streams
+ *	Input: Slaves & Count (1..4, at most 24 bytes in all)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Aux_Start(const MPU6050_AUX_SLAVE_t* slaves, uint8_t count){
+	
+	uint8_t regs[1 + AUX_SLAVE_REGS*MPU6050_AUX_SLAVES];			//I2C_MST_CTRL, then ADDR, REG, CTRL of SLV0..3
+	uint8_t total = 0;
+	uint8_t ret;
+	uint8_t i;
+	
+	/* Asserting Params */
+	if(MPU6050_Frame_Size || count == 0 || count > MPU6050_AUX_SLAVES)
+		return I2C_STATUS_INVALID;
+	for(i = 0; i < count; i++){
+		if((slaves[i].addr & I2C_SLV_RNW) || slaves[i].len == 0 || slaves[i].len > AUX_SLV_LEN_MAX ||
+			 (slaves[i].flags & ~(I2C_SLV_BYTE_SW|I2C_SLV_GRP)))
+			return I2C_STATUS_INVALID;
+		total += slaves[i].len;
+	}
+	if(total > MPU6050_AUX_DATA_SIZE)
+		return I2C_STATUS_INVALID;
+	
+	memset(regs, 0, sizeof(regs));
+	regs[0] = I2C_MST_WAIT_FOR_ES | I2C_MST_CLK_400;
+	for(i = 0; i < count; i++){
+		regs[1 + AUX_SLAVE_REGS*i] = I2C_SLV_RNW | slaves[i].addr;
+		regs[2 + AUX_SLAVE_REGS*i] = slaves[i].reg;
+		regs[3 + AUX_SLAVE_REGS*i] = I2C_SLV_EN | slaves[i].flags | slaves[i].len;
+	}
+	
+	//Master and all four slaves in one burst (I2C_MST_CTRL..I2C_SLV3_CTRL), unused slaves off
+	MPU6050_Aux_User = MPU6050_Aux_Total = 0;
+	memset(MPU6050_Aux_Len, 0, sizeof(MPU6050_Aux_Len));
+	ret = I2C_Burst_Transmit(MPU6050_Bus, MPU6050_ADDR, I2C_MST_CTRL, regs, sizeof(regs));
+	if(ret == 0)
+		ret = RegCache_Write(&MPU6050_Cache, USER_CTRL, USER_I2C_MST_EN);
+	if(ret != 0)
+		return ret;
+	
+	MPU6050_Aux_User = USER_I2C_MST_EN;
+	MPU6050_Aux_Total = total;
+	for(i = 0; i < count; i++)
+		MPU6050_Aux_Len[i] = slaves[i].len;
+	return I2C_STATUS_OK;
+}
+
+/*
+ *	-----------------MPU6050_Aux_Stop-------------------
+ *	Stop reading the secondary sensors and turn the aux master off
+ *	(not while the FIFO streams)
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Aux_Stop(void){
+	
+	uint8_t regs[AUX_SLAVE_REGS*MPU6050_AUX_SLAVES];
+	uint8_t ret;
+	
+	/* Asserting Param */
+	if(MPU6050_Frame_Size)
+		return I2C_STATUS_INVALID;
+	
+	MPU6050_Aux_User = MPU6050_Aux_Total = 0;
+	memset(MPU6050_Aux_Len, 0, sizeof(MPU6050_Aux_Len));
+	
+	//Slaves off too, so a single transfer later on doesn't start them again
+	memset(regs, 0, sizeof(regs));
+	ret = RegCache_Write(&MPU6050_Cache, USER_CTRL, 0);
+	if(ret == 0)
+		ret = I2C_Burst_Transmit(MPU6050_Bus, MPU6050_ADDR, I2C_SLV0_ADDR, regs, sizeof(regs));
+	return ret;
+}
+
+/*
+ *	-----------------MPU6050_Aux_Size-------------------
+ *	Bytes the running slaves bring in each sample
+ *	Input: none
+ * 	Output: Size (0 if the aux master is off)
+ */
+uint8_t MPU6050_Aux_Size(void){
+	return MPU6050_Aux_Total;
+}
+
+/*
+ *	----------------MPU6050_Aux_Single------------------
+ *	Local function, one SLV4 transfer: the master is turned on for
+ *	it if the slaves aren't running, and the status polled for up
+ *	to two sample periods
+ *	Input: Address (I2C_SLV_RNW set to read), Register, Value to
+ *				 write & Value read (filled, reads only)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+static uint8_t MPU6050_Aux_Single(uint8_t addr, uint8_t reg, uint8_t value, uint8_t* read){
+	
+	uint8_t regs[4];																	//I2C_SLV4_ADDR, _REG, _DO, _CTRL
+	uint8_t fifo_user = MPU6050_Frame_Size ? USER_FIFO_EN : 0;
+	MPU6050_CONFIG_t config;
+	uint32_t timeout_ms;
+	uint32_t waited;
+	uint8_t status;
+	uint8_t ret;
+	uint8_t ret_off;
+	
+	ret = MPU6050_Get_Config(&config);
+	if(ret != 0)
+		return ret;
+	timeout_ms = 2*1000/config.rate_hz + 1;
+	
+	if(!MPU6050_Aux_User){
+		ret = RegCache_Write(&MPU6050_Cache, I2C_MST_CTRL, I2C_MST_CLK_400);
+		if(ret == 0)
+			ret = RegCache_Write(&MPU6050_Cache, USER_CTRL, USER_I2C_MST_EN | fifo_user);
+	}
+	
+	//Read I2C_MST_STATUS once to clear an old DONE/NACK, then start the transfer
+	if(ret == 0)
+		ret = I2C_Burst_Receive(MPU6050_Bus, MPU6050_ADDR, I2C_MST_STATUS, &status, 1);
+	regs[0] = addr;
+	regs[1] = reg;
+	regs[2] = value;
+	regs[3] = I2C_SLV_EN;
+	if(ret == 0)
+		ret = I2C_Burst_Transmit(MPU6050_Bus, MPU6050_ADDR, I2C_SLV4_ADDR, regs, sizeof(regs));
+	
+	for(waited = 0; ret == 0; waited++){
+		ret = I2C_Burst_Receive(MPU6050_Bus, MPU6050_ADDR, I2C_MST_STATUS, &status, 1);
+		if(ret != 0 || (status & (I2C_SLV4_DONE|I2C_SLV4_NACK)))
+			break;
+		if(waited == timeout_ms)
+			ret = I2C_STATUS_TIMEOUT;
+		else
+			DELAY_1MS(1);
+	}
+	if(ret == 0 && (status & I2C_SLV4_NACK))
+		ret = MPU6050_AUX_NACK;
+	if(ret == 0 && read)
+		ret = I2C_Burst_Receive(MPU6050_Bus, MPU6050_ADDR, I2C_SLV4_DI, read, 1);
+	
+	if(!MPU6050_Aux_User){
+		ret_off = RegCache_Write(&MPU6050_Cache, USER_CTRL, fifo_user);
+		if(ret == 0)
+			ret = ret_off;
+	}
+	return ret;
+}
+
+/*
+ *	-----------------MPU6050_Aux_Write------------------
+ *	Write one register of a secondary sensor through the aux master
+ *	(SLV4), e.g. to set it up before MPU6050_Aux_Start. Done on the
+ *	next sample, waits up to two sample periods
+ *	Input: 7-bit Address, Register & Value
+ * 	Output: Any Errors if detected (MPU6050_AUX_NACK if it didn't
+ *					answer), otherwise 0
+ */
+uint8_t MPU6050_Aux_Write(uint8_t addr, uint8_t reg, uint8_t value){
+	
+	/* Asserting Param */
+	if(addr & I2C_SLV_RNW)
+		return I2C_STATUS_INVALID;
+	return MPU6050_Aux_Single(addr, reg, value, 0);
+}
+
+/*
+ *	-----------------MPU6050_Aux_Read-------------------
+ *	Read one register of a secondary sensor through the aux master
+ *	(SLV4), done on the next sample like MPU6050_Aux_Write
+ *	Input: 7-bit Address, Register & Value (filled)
+ * 	Output: Any Errors if detected (MPU6050_AUX_NACK if it didn't
+ *					answer), otherwise 0
+ */
+uint8_t MPU6050_Aux_Read(uint8_t addr, uint8_t reg, uint8_t* value){
+	
+	/* Asserting Param */
+	if(addr & I2C_SLV_RNW)
+		return I2C_STATUS_INVALID;
+	return MPU6050_Aux_Single(I2C_SLV_RNW | addr, reg, 0, value);
+}
+
+/*
+ *	--------------MPU6050_Get_Motion_Aux----------------
+ *	MPU6050_Get_Motion with the secondary sensor bytes of the same
+ *	sample, all in one burst (ACCEL_XOUT_H..EXT_SENS_DATA)
+ *	Input: MPU6050 Accel, Gyro & Temp User Instance Structs (Temp
+ *				 can be 0) & Aux Buffer (MPU6050_Aux_Size bytes)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Get_Motion_Aux(MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_TEMP_t* Temp_Instance, uint8_t* aux){
+	
+	uint8_t data[MPU6050_MOTION_DATA_SIZE + MPU6050_AUX_DATA_SIZE];		//EXT_SENS_DATA_00 follows GYRO_ZOUT_L
+	uint8_t ret;
+	
+	ret = I2C_Burst_Receive(MPU6050_Bus, MPU6050_ADDR, ACCEL_XOUT_H, data, MPU6050_MOTION_DATA_SIZE + MPU6050_Aux_Total);
+	if(ret != I2C_STATUS_OK)
+		return ret;
+	
+	MPU6050_Unpack_Motion(data, Accel_Instance, Gyro_Instance, Temp_Instance);
+	memcpy(aux, data + MPU6050_MOTION_DATA_SIZE, MPU6050_Aux_Total);
+	return I2C_STATUS_OK;
+}
+
+/*
+ *	----------------MPU6050_Configure-----------------
+ *	Apply a configuration at runtime (sample rate, DLPF, ranges and
+ *	clock) and switch the conversion scales over. Rejected as a
+ *	whole if the rate isn't the gyro output rate divided by a whole
+ *	number (8kHz needs the DLPF off) or is below twice the DLPF
+ *	bandwidth, where it would alias. Nothing is sent when the
+ *	MPU6050 already runs this configuration
+ *	Input: Configuration
+ * 	Output: Any Errors if detected (I2C_STATUS_INVALID if rejected), otherwise 0
+ */
+uint8_t MPU6050_Configure(const MPU6050_CONFIG_t* config){
+	
+	REG_INIT_t table[CONFIG_REG_COUNT];
+	uint16_t gyro_rate;
+	uint8_t value;
+	uint8_t ret;
+	uint8_t i;
+	
+	/* Asserting Params */
+	if(config->dlpf > CONFIG_DFPL_6 || config->clock > PWR_CLK_SEL_EXT_19 ||
+		 (config->accel_range & ~(FS_SEL_MASK << FS_SEL_SHIFT)) || (config->gyro_range & ~(FS_SEL_MASK << FS_SEL_SHIFT)))
+		return I2C_STATUS_INVALID;
+	
+	gyro_rate = (config->dlpf == CONFIG_DFPL_0) ? GYRO_RATE_HZ : GYRO_RATE_DLPF_HZ;
+	if(config->rate_hz == 0 || gyro_rate % config->rate_hz != 0 || gyro_rate / config->rate_hz > SMPLRT_DIV_MAX ||
+		 config->rate_hz < 2*MPU6050_DLPF_Bandwidth[config->dlpf])
+		return I2C_STATUS_INVALID;
+	
+	ret = RegCache_Read(&MPU6050_Cache, PWR_MGMT_1, &value);
+	if(ret != 0)
+		return ret;
+	
+	//The init table with new values: clock first, then SMPLRT_DIV..ACCEL_CONFIG as one verified burst
+	memcpy(table, MPU6050_Init_Table, sizeof(table));
+	table[0].value = (value & ~PWR_CLK_SEL_MASK) | config->clock;
+	table[1].value = gyro_rate / config->rate_hz - 1;
+	table[2].value = config->dlpf;
+	table[3].value = config->gyro_range;
+	table[4].value = config->accel_range;
+	
+	for(i = 0; i < CONFIG_REG_COUNT; i++){
+		ret = RegCache_Read(&MPU6050_Cache, table[i].reg, &value);
+		if(ret != 0)
+			return ret;
+		if(value != table[i].value)
+			break;
+	}
+	if(i == CONFIG_REG_COUNT)
+		return I2C_STATUS_OK;
+	
+	ret = RegCache_Run_Init(&MPU6050_Cache, table, CONFIG_REG_COUNT, 0);
+	MPU6050_Update_Scale();
+	return ret;
+}
+
+/*
+ *	----------------MPU6050_Get_Config----------------
+ *	The running configuration, from the shadow copy
+ *	Input: Configuration to fill
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Get_Config(MPU6050_CONFIG_t* config){
+	
+	uint8_t values[CONFIG_REG_COUNT];
+	uint8_t ret;
+	uint8_t i;
+	
+	for(i = 0; i < CONFIG_REG_COUNT; i++){
+		ret = RegCache_Read(&MPU6050_Cache, MPU6050_Init_Table[i].reg, &values[i]);
+		if(ret != 0)
+			return ret;
+	}
+	
+	config->clock = values[0] & PWR_CLK_SEL_MASK;
+	config->dlpf = values[2] & CONFIG_DFPL_MASK;
+	config->gyro_range = values[3] & (FS_SEL_MASK << FS_SEL_SHIFT);
+	config->accel_range = values[4] & (FS_SEL_MASK << FS_SEL_SHIFT);
+	config->rate_hz = ((config->dlpf == CONFIG_DFPL_0 || config->dlpf == CONFIG_DFPL_MASK) ? GYRO_RATE_HZ : GYRO_RATE_DLPF_HZ) / (1 + values[1]);
+	return I2C_STATUS_OK;
+}
+
+/* Used for Debugging Purposes (always reads the device) */
 uint8_t MPU6050_Read_Reg(uint8_t reg){
-	return I2C0_Receive(MPU6050_ADDR_AD0_LOW, reg);
+	return I2C_Receive(MPU6050_Bus, MPU6050_ADDR, reg);
 }
\ No newline at end of file
@@ -15,6 +15,8 @@
 
 #include <stdint.h>
 #include "util.h"
+#include "I2C.h"
+#include "Ring.h"
 
 
 //NOTE: There will be no self-test regs
@@ -32,33 +34,33 @@ incure any penelties but will be a waste of time)
 //#define USE_HIGH
 
 /**********************************************************/
-#ifndef USE_HIGH
 #define MPU6050_ADDR_AD0_LOW		(0x68)
-#else
-//Only use if AD0 is pulled high
-#define MPU6050_ADDR_AD0_HIGH		()
-#endif
+#define MPU6050_ADDR_AD0_HIGH		(0x69)			//Only use if AD0 is pulled high
+#define MPU6050_WHO_AM_I_ID			(0x68)			//WHO_AM_I reads this whatever AD0 is
 
 /*************Sampling Rate Register*************/
+//Sample Rate = Gyro Output Rate / SMPLRT_DIV_n, Gyro Output Rate is 8kHz with the DLPF off, 1kHz with it on
 #define SMPLRT_DIV							(25)
-//	#define SMPLRT_DIV_1					()
-//	#define SMPLRT_DIV_2					()
-//	#define SMPLRT_DIV_3					()
-//	#define SMPLRT_DIV_4					()
-//	#define SMPLRT_DIV_5					()
-//	#define SMPLRT_DIV_6					()
-//	#define SMPLRT_DIV_7					()
+	#define SMPLRT_DIV_1					(0)
+	#define SMPLRT_DIV_2					(1)
+	#define SMPLRT_DIV_3					(2)
+	#define SMPLRT_DIV_4					(3)
+	#define SMPLRT_DIV_5					(4)
+	#define SMPLRT_DIV_6					(5)
+	#define SMPLRT_DIV_7					(6)
 	#define SMPLRT_DIV_8					(7)
 
 /****************Config Register****************/
+//Digital Low Pass Filter, accel/gyro bandwidth
 #define CONFIG									(26)
-	#define CONFIG_DFPL_0					(0) // disabled
-	#define CONFIG_DFPL_1					(1) // temp out
-	#define CONFIG_DFPL_2					(2)
-	#define CONFIG_DFPL_3					(3)
-	#define CONFIG_DFPL_4					(4)
-	#define CONFIG_DFPL_5					(5)
-	#define CONFIG_DFPL_6					(6)
+	#define CONFIG_DFPL_0					(0) // disabled, 260/256Hz
+	#define CONFIG_DFPL_1					(1) // 184/188Hz
+	#define CONFIG_DFPL_2					(2) // 94/98Hz
+	#define CONFIG_DFPL_3					(3) // 44/42Hz
+	#define CONFIG_DFPL_4					(4) // 21/20Hz
+	#define CONFIG_DFPL_5					(5) // 10/10Hz
+	#define CONFIG_DFPL_6					(6) // 5/5Hz
+	#define CONFIG_DFPL_MASK			(0x07)
 
 /*************Gyro Config Register*************/
 #define GYRO_CONFIG							(27)
@@ -77,8 +79,29 @@ incure any penelties but will be a waste of time)
 
 #define MOT_THR             		(0x1F)
 #define FIFO_EN             		(0x23)
+	#define FIFO_EN_TEMP					(0x80)
+	#define FIFO_EN_XG						(0x40)
+	#define FIFO_EN_YG						(0x20)
+	#define FIFO_EN_ZG						(0x10)
+	#define FIFO_EN_ACCEL					(0x08)
+	#define FIFO_EN_GYRO					(FIFO_EN_XG|FIFO_EN_YG|FIFO_EN_ZG)
+	#define FIFO_EN_SLV2					(0x04)			//Aux slave data, after the gyro in the frame
+	#define FIFO_EN_SLV1					(0x02)
+	#define FIFO_EN_SLV0					(0x01)
+	#define FIFO_EN_SLV						(FIFO_EN_SLV0|FIFO_EN_SLV1|FIFO_EN_SLV2)
 #define I2C_MST_CTRL        		(0x24)
+	#define I2C_MST_MULT_MST_EN		(0x80)
+	#define I2C_MST_WAIT_FOR_ES		(0x40)			//DATA_RDY waits for the aux slave data
+	#define I2C_MST_SLV_3_FIFO_EN	(0x20)
+	#define I2C_MST_P_NSR					(0x10)			//STOP between slave reads (default repeated START)
+	#define I2C_MST_CLK_400				(0x0D)			//Aux bus SCL 400kHz
 #define I2C_SLV0_ADDR       		(0x25)
+	#define I2C_SLV_RNW						(0x80)			//Read from the slave (SLVx_ADDR)
+	#define I2C_SLV_EN						(0x80)			//SLVx_CTRL Bits
+	#define I2C_SLV_BYTE_SW				(0x40)			//Swap the bytes of each word
+	#define I2C_SLV_REG_DIS				(0x20)			//Transfer data only, no register address
+	#define I2C_SLV_GRP						(0x10)			//Words start on odd register addresses
+	#define I2C_SLV_LEN_MASK			(0x0F)
 #define I2C_SLV0_REG        		(0x26)
 #define I2C_SLV0_CTRL       		(0x27)
 #define I2C_SLV1_ADDR       		(0x28)
@@ -95,10 +118,24 @@ incure any penelties but will be a waste of time)
 #define I2C_SLV4_DO         		(0x33)
 #define I2C_SLV4_CTRL       		(0x34)
 #define I2C_SLV4_DI         		(0x35)
-#define I2C_MST_STATUS      		(0x36)
+#define I2C_MST_STATUS      		(0x36)			//Cleared by reading it
+	#define I2C_MST_PASS_THROUGH	(0x80)
+	#define I2C_SLV4_DONE					(0x40)
+	#define I2C_MST_LOST_ARB			(0x20)
+	#define I2C_SLV4_NACK					(0x10)
+	#define I2C_SLV0_NACK					(0x01)			//SLV1..3 NACK are the next bits up
 #define INT_PIN_CFG         		(0x37)
+	#define INT_LEVEL_LOW					(0x80)			//INT active low (default active high)
+	#define INT_OPEN_DRAIN				(0x40)
+	#define INT_LATCH_EN					(0x20)			//Held until cleared (default 50us pulse)
+	#define INT_RD_CLEAR					(0x10)			//Any read clears INT_STATUS (default only reading it)
+	#define INT_I2C_BYPASS_EN			(0x02)			//Aux bus joined to the main bus, master off
 #define INT_ENABLE          		(0x38)
+	#define INT_DATA_RDY_EN				(0x01)
+	#define INT_FIFO_OFLOW_EN			(0x10)
 #define INT_STATUS          		(0x3A)
+	#define INT_DATA_RDY					(0x01)
+	#define INT_FIFO_OFLOW				(0x10)
 
 /**********************************************************/
 #define ACCEL_XOUT_H        		(59)
@@ -149,6 +186,10 @@ incure any penelties but will be a waste of time)
 #define SIGNAL_PATH_RESET   		(0x68)
 #define MOT_DETECT_CTRL     		(0x69)
 #define USER_CTRL           		(0x6A)
+	#define USER_FIFO_EN					(0x40)
+	#define USER_I2C_MST_EN				(0x20)			//Aux bus run by the MPU6050 master
+	#define USER_FIFO_RESET				(0x04)			//Only while USER_FIFO_EN is clear, clears itself
+	#define USER_I2C_MST_RESET		(0x02)
 
 /**********Power Management & ID Register**********/
 #define PWR_MGMT_1          		(107)
@@ -159,6 +200,7 @@ incure any penelties but will be a waste of time)
 	#define PWR_CLK_SEL_EXT_32		(4)
 	#define PWR_CLK_SEL_EXT_19		(5)
 	#define PWR_CLK_SEL_STOP			(7)
+	#define PWR_CLK_SEL_MASK			(0x07)
 	#define PWR_TEMP_DIS					(0x08)
 	#define PWR_CYCLE							(0x20)
 	#define PWR_SLEEP							(0x40)
@@ -182,6 +224,20 @@ incure any penelties but will be a waste of time)
 #define FIFO_COUNTL         		(0x73)
 #define FIFO_R_W            		(0x74)
 
+#define MPU6050_MOTION_DATA_SIZE	(14)			//ACCEL_XOUT_H..GYRO_ZOUT_L
+#define MPU6050_FIFO_SIZE				(1024)			//Bytes, the oldest are overwritten when full
+#define MPU6050_FIFO_OVERFLOW		(0xFA)			//FIFO filled up and was reset (next to the I2C_STATUS_* codes)
+
+/* Auxiliary I2C Master: secondary sensors on the MPU6050's own bus */
+#define MPU6050_AUX_SLAVES			(4)					//SLV0..3 read every sample, SLV4 is for single transfers
+#define MPU6050_AUX_DATA_SIZE		(24)				//EXT_SENS_DATA_00..23, shared by all slaves
+#define MPU6050_AUX_NACK				(0xF9)			//Aux slave didn't acknowledge (next to the I2C_STATUS_* codes)
+
+/* Data Ready Line: MPU6050 INT pin wired to PE1 */
+#define MPU6050_INT_PIN					(0x02)			//PE1
+#define MPU6050_INT_IRQ					(4)					//GPIO Port E interrupt number
+#define MPU6050_INT_PRIORITY		(I2C_INT_PRIORITY + 1)	//Never preempts the bus ISR it hands the read to
+
 #define RAD_TO_DEGREE_CONV			(180/3.1415)
 
 /* Data Struct to store Accelerometer Data*/
@@ -208,6 +264,28 @@ typedef struct{
 	
 } MPU6050_GYRO_t;
 
+/* Data Struct to store Accelerometer Data in milli-g (integer only path) */
+typedef struct{
+	int32_t Ax;
+	int32_t Ay;
+	int32_t Az;
+} MPU6050_ACCEL_MG_t;
+
+/* Data Struct to store Gyroscope Data in milli-degrees/s (integer only path) */
+typedef struct{
+	int32_t Gx;
+	int32_t Gy;
+	int32_t Gz;
+} MPU6050_GYRO_MDPS_t;
+
+/* Data Struct to store Temperature Data*/
+typedef struct{
+	int16_t Temp_RAW;
+	
+	float Temp;												//Degrees C
+	
+} MPU6050_TEMP_t;
+
 /* Data Struct to store Tilt Angle Data*/
 typedef struct{
 	float ArX;
@@ -215,17 +293,41 @@ typedef struct{
 	float ArZ;
 } MPU6050_ANGLE_t;
 
+/* Runtime Configuration (MPU6050_Configure), fields take the register macros above */
+typedef struct{
+	uint16_t rate_hz;									//Output data rate: 8kHz (DLPF off) or 1kHz divided by 1..256
+	uint8_t dlpf;											//CONFIG_DFPL_0 (off) .. CONFIG_DFPL_6
+	uint8_t accel_range;							//ACCEL_AFS_SEL_0 (+-2g) .. ACCEL_AFS_SEL_3 (+-16g)
+	uint8_t gyro_range;								//GYRO_FS_SEL_0 (+-250dps) .. GYRO_FS_SEL_3 (+-2000dps)
+	uint8_t clock;										//PWR_CLK_SEL_INTERNAL .. PWR_CLK_SEL_EXT_19
+} MPU6050_CONFIG_t;
+
+/* Secondary Sensor the aux master reads every sample, data lands in slave order */
+typedef struct{
+	uint8_t addr;											//7-bit address on the aux bus
+	uint8_t reg;											//First register read
+	uint8_t len;											//Bytes, 1..15
+	uint8_t flags;										//I2C_SLV_BYTE_SW, I2C_SLV_GRP (0 for none)
+} MPU6050_AUX_SLAVE_t;
+
+/* What MPU6050_Init sets up */
+#define MPU6050_CONFIG_DEFAULT	{1000, CONFIG_DFPL_0, ACCEL_AFS_SEL_0, GYRO_FS_SEL_0, PWR_CLK_SEL_INTERNAL}
+
+/* Called from the bus ISR with every sample the data ready line brought in */
+typedef void (*MPU6050_SAMPLE_CALLBACK_t)(const SAMPLE_t* sample);
+
 /*
  *	-------------------MPU6050_Init---------------------
  *	Basic Initialization Function for MPU6050 @ default settings
- *	Input: none
+ *	Input: Bus Handle the MPU6050 is on
  * 	Output: none
  */
-void MPU6050_Init(void);
+void MPU6050_Init(I2C_BUS_t* bus);
 
 /*
  *	-----------------MPU6050_Get_Accel------------------
  *	Receive Raw Accelerometer Data and store it in the user struct
+ *	(left as is on a bus error)
  *	Input: MPU6050 Accel User Instance Struct
  * 	Output: none
  */
@@ -234,15 +336,127 @@ void MPU6050_Get_Accel(MPU6050_ACCEL_t* Accel_Instance);
 /*
  *	-----------------MPU6050_Get_Gyro-------------------
  *	Receive Raw Gyroscope Data and store it in the user struct
+ *	(left as is on a bus error)
  *	Input: MPU6050 Gyro User Instance Struct
  * 	Output: none
  */
 void MPU6050_Get_Gyro(MPU6050_GYRO_t* Gyro_Instance);	
 
+/*
+ *	-----------------MPU6050_Get_Motion-----------------
+ *	Receive Raw Accelerometer, Temperature and Gyroscope Data as
+ *	one 14-byte burst (ACCEL_XOUT_H..GYRO_ZOUT_L), so every value
+ *	comes from the same sample. Structs are left as is on a bus error
+ *	Input: MPU6050 Accel, Gyro & Temp User Instance Structs (Temp can be 0)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Get_Motion(MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_TEMP_t* Temp_Instance);
+
+/*
+ *	-------------MPU6050_Motion_Transaction-------------
+ *	Fill in a transaction descriptor for the same burst as
+ *	MPU6050_Get_Motion, for callers that run it themselves (e.g.
+ *	through the I2C scheduler). Turn the data into samples with
+ *	MPU6050_Unpack_Motion once it is done
+ *	Input: Transaction Descriptor & Data Buffer (MPU6050_MOTION_DATA_SIZE bytes)
+ * 	Output: none
+ */
+void MPU6050_Motion_Transaction(I2C_TRANSACTION_t* transaction, uint8_t* data);
+
+/*
+ *	---------------MPU6050_Unpack_Motion----------------
+ *	Fill the raw fields of the user structs from the 14 bytes at
+ *	ACCEL_XOUT_H
+ *	Input: Data, MPU6050 Accel, Gyro & Temp User Instance Structs (Temp can be 0)
+ * 	Output: none
+ */
+void MPU6050_Unpack_Motion(const uint8_t* data, MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_TEMP_t* Temp_Instance);
+
+/*
+ *	-----------------MPU6050_Fifo_Start-----------------
+ *	Stream samples through the hardware FIFO: the chosen sensors
+ *	go in as one frame per sample (register order: accel, temp,
+ *	gyro X, Y, Z, then aux slaves 0..2), at the rate set by SMPLRT_DIV
+ *	Input: Sensors to stream (FIFO_EN_* bits, FIFO_EN_SLVn needs
+ *				 that aux slave running)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Fifo_Start(uint8_t sensors);
+
+/*
+ *	-----------------MPU6050_Fifo_Stop------------------
+ *	Stop streaming, the FIFO is left as is
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Fifo_Stop(void);
+
+/*
+ *	-------------MPU6050_Fifo_Frame_Size----------------
+ *	Bytes per frame of the running stream
+ *	Input: none
+ * 	Output: Frame Size (0 if not streaming)
+ */
+uint8_t MPU6050_Fifo_Frame_Size(void);
+
+/*
+ *	-----------------MPU6050_Fifo_Read------------------
+ *	Drain whole frames into the buffer with one burst read. A FIFO
+ *	that filled up has lost bytes and its frame boundaries: it is
+ *	reset and the next read starts on a frame again
+ *	Input: Buffer (max_frames*Frame Size bytes), Most Frames to take
+ *				 & Frames Read (filled)
+ * 	Output: Any Errors if detected, MPU6050_FIFO_OVERFLOW after a
+ *					reset, otherwise 0
+ */
+uint8_t MPU6050_Fifo_Read(uint8_t* buf, uint16_t max_frames, uint16_t* frames);
+
+/*
+ *	----------------MPU6050_Fifo_Unpack-----------------
+ *	Fill the raw fields of the user structs from one FIFO frame,
+ *	sensors that aren't streamed are left as is. Streamed aux slave
+ *	bytes end the frame, after the gyro
+ *	Input: Frame, MPU6050 Accel, Gyro & Temp User Instance Structs (any can be 0)
+ * 	Output: none
+ */
+void MPU6050_Fifo_Unpack(const uint8_t* frame, MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_TEMP_t* Temp_Instance);
+
+/*
+ *	--------------MPU6050_Data_Ready_Start--------------
+ *	Interrupt driven acquisition: the MPU6050 pulses INT once per
+ *	sample, the PE1 edge interrupt queues one 14-byte burst read and
+ *	its completion hands the sample (SAMPLE_MOTION, raw values) to
+ *	the ring and the callback. Nothing is polled
+ *	Input: Ring to push SAMPLE_t records to & Callback (either can be 0)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Data_Ready_Start(RING_t* ring, MPU6050_SAMPLE_CALLBACK_t callback);
+
+/*
+ *	--------------MPU6050_Data_Ready_Stop---------------
+ *	Disarm PE1 and the data ready interrupt, a read already on the
+ *	bus still completes
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Data_Ready_Stop(void);
+
+/*
+ *	-------------MPU6050_Data_Ready_Missed--------------
+ *	Samples skipped because the read of the previous one was still
+ *	running (or failed), since MPU6050_Data_Ready_Start
+ *	Input: none
+ * 	Output: Missed Samples
+ */
+uint32_t MPU6050_Data_Ready_Missed(void);
+
 /*
  *	---------------MPU6050_Process_Accel----------------
- *	Process Raw Accelerometer Data into usable data and store
- *	it in the user stuct
+ *	Process Raw Accelerometer Data into g and store it in the user
+ *	struct: one multiply per axis by the scale picked when the full
+ *	scale range was configured. Matches dividing by the LSB value
+ *	exactly (the LSB values are powers of two). Left as is while the
+ *	range isn't known
  *	Input: MPU6050 Accel User Instance Struct
  * 	Output: none
  */
@@ -250,23 +464,159 @@ void MPU6050_Process_Accel(MPU6050_ACCEL_t* Accel_Instance);
 
 /*
  *	---------------MPU6050_Process_Gyro----------------
- *	Process Raw Gyroscope Data into usable data and store it in
- *	the user struct
+ *	Process Raw Gyroscope Data into degrees/s and store it in the
+ *	user struct: one multiply per axis by the reciprocal picked when
+ *	the full scale range was configured. Within 2 ulp (relative
+ *	2.4e-7) of dividing by the LSB value. Left as is while the range
+ *	isn't known
  *	Input: MPU6050 Gyro User Instance Struct
  * 	Output: none
  */
 void MPU6050_Process_Gyro(MPU6050_GYRO_t* Gyro_Instance);
 
+/*
+ *	-------------MPU6050_Process_Accel_mg---------------
+ *	Integer only Accelerometer conversion into milli-g: one Q16
+ *	multiply and shift per axis, rounded to nearest. Within +-1 mg
+ *	of the float result. Left as is while the range isn't known
+ *	Input: MPU6050 Accel User Instance Struct & milli-g Struct
+ * 	Output: none
+ */
+void MPU6050_Process_Accel_mg(const MPU6050_ACCEL_t* Accel_Instance, MPU6050_ACCEL_MG_t* Accel_mg);
+
+/*
+ *	------------MPU6050_Process_Gyro_mdps---------------
+ *	Integer only Gyroscope conversion into milli-degrees/s: one Q16
+ *	multiply and shift per axis, rounded to nearest. Within +-1 mdps
+ *	of the float result. Left as is while the range isn't known
+ *	Input: MPU6050 Gyro User Instance Struct & milli-dps Struct
+ * 	Output: none
+ */
+void MPU6050_Process_Gyro_mdps(const MPU6050_GYRO_t* Gyro_Instance, MPU6050_GYRO_MDPS_t* Gyro_mdps);
+
+/*
+ *	---------------MPU6050_Process_Temp----------------
+ *	Process Raw Temperature Data into degrees C and store it in
+ *	the user struct
+ *	Input: MPU6050 Temp User Instance Struct
+ * 	Output: none
+ */
+void MPU6050_Process_Temp(MPU6050_TEMP_t* Temp_Instance);
+
 /*
  *	-----------------MPU6050_Get_Angle-----------------
- *	Calculate Tilt Angle using processed Accelerometer and
- *	Gyroscope data and it in the user angle struct
+ *	Calculate Tilt Angle from processed Accelerometer data alone
+ *	and store it in the user angle struct (the gyro isn't used,
+ *	Tilt_Update in Tilt.h blends both for a steady roll/pitch)
  *	Input: MPU6050 Angle User Instance Struct
  * 	Output: none
  */
 void MPU6050_Get_Angle(MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_ANGLE_t* Angle_Instance);
 
-/* Used for Debugging Purposes */
+/*
+ *	---------------MPU6050_Get_Angle_Fast---------------
+ *	Same tilt angles as MPU6050_Get_Angle, single precision through
+ *	the FastMath kernels (atan2 and hypot in place of double atan,
+ *	divide and sqrt). Within 0.001 degree of MPU6050_Get_Angle, and
+ *	a level or zero reading gives 0 or 90 instead of NaN. Gyro is
+ *	not used, it is there so this drops in for MPU6050_Get_Angle
+ *	Input: MPU6050 Accel, Gyro & Angle User Instance Structs
+ * 	Output: none
+ */
+void MPU6050_Get_Angle_Fast(MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_ANGLE_t* Angle_Instance);
+
+/*
+ *	-----------------MPU6050_Aux_Start------------------
+ *	Hand secondary sensors to the MPU6050's aux I2C master: from
+ *	the next sample on, each is read right after the IMU sample and
+ *	DATA_RDY waits for it. Their bytes come back behind the gyro in
+ *	MPU6050_Get_Motion_Aux, and through the FIFO (FIFO_EN_SLV0..2).
+ *	Not while the FIFO streams
+ *	Input: Slaves & Count (1..4, at most 24 bytes in all)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Aux_Start(const MPU6050_AUX_SLAVE_t* slaves, uint8_t count);
+
+/*
+ *	-----------------MPU6050_Aux_Stop-------------------
+ *	Stop reading the secondary sensors and turn the aux master off
+ *	(not while the FIFO streams)
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Aux_Stop(void);
+
+/*
+ *	-----------------MPU6050_Aux_Size-------------------
+ *	Bytes the running slaves bring in each sample
+ *	Input: none
+ * 	Output: Size (0 if the aux master is off)
+ */
+uint8_t MPU6050_Aux_Size(void);
+
+/*
+ *	-----------------MPU6050_Aux_Write------------------
+ *	Write one register of a secondary sensor through the aux master
+ *	(SLV4), e.g. to set it up before MPU6050_Aux_Start. Done on the
+ *	next sample, waits up to two sample periods
+ *	Input: 7-bit Address, Register & Value
+ * 	Output: Any Errors if detected (MPU6050_AUX_NACK if it didn't
+ *					answer), otherwise 0
+ */
+uint8_t MPU6050_Aux_Write(uint8_t addr, uint8_t reg, uint8_t value);
+
+/*
+ *	-----------------MPU6050_Aux_Read-------------------
+ *	Read one register of a secondary sensor through the aux master
+ *	(SLV4), done on the next sample like MPU6050_Aux_Write
+ *	Input: 7-bit Address, Register & Value (filled)
+ * 	Output: Any Errors if detected (MPU6050_AUX_NACK if it didn't
+ *					answer), otherwise 0
+ */
+uint8_t MPU6050_Aux_Read(uint8_t addr, uint8_t reg, uint8_t* value);
+
+/*
+ *	--------------MPU6050_Get_Motion_Aux----------------
+ *	MPU6050_Get_Motion with the secondary sensor bytes of the same
+ *	sample, all in one burst (ACCEL_XOUT_H..EXT_SENS_DATA)
+ *	Input: MPU6050 Accel, Gyro & Temp User Instance Structs (Temp
+ *				 can be 0) & Aux Buffer (MPU6050_Aux_Size bytes)
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Get_Motion_Aux(MPU6050_ACCEL_t* Accel_Instance, MPU6050_GYRO_t* Gyro_Instance, MPU6050_TEMP_t* Temp_Instance, uint8_t* aux);
+
+/*
+ *	----------------MPU6050_Configure-----------------
+ *	Apply a configuration at runtime (sample rate, DLPF, ranges and
+ *	clock) and switch the conversion scales over. Rejected as a
+ *	whole if the rate isn't the gyro output rate divided by a whole
+ *	number (8kHz needs the DLPF off) or is below twice the DLPF
+ *	bandwidth, where it would alias. Nothing is sent when the
+ *	MPU6050 already runs this configuration
+ *	Input: Configuration
+ * 	Output: Any Errors if detected (I2C_STATUS_INVALID if rejected), otherwise 0
+ */
+uint8_t MPU6050_Configure(const MPU6050_CONFIG_t* config);
+
+/*
+ *	----------------MPU6050_Get_Config----------------
+ *	The running configuration, from the shadow copy
+ *	Input: Configuration to fill
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Get_Config(MPU6050_CONFIG_t* config);
+
+/*
+ *	--------------MPU6050_Refresh_Config---------------
+ *	Reload the shadow copy of the configuration registers and the
+ *	conversion scales, call it after the MPU6050 was reset, power
+ *	cycled or reconfigured behind the driver
+ *	Input: none
+ * 	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t MPU6050_Refresh_Config(void);
+
+/* Used for Debugging Purposes (always reads the device) */
 uint8_t MPU6050_Read_Reg(uint8_t reg);
 
 #endif
\ No newline at end of file
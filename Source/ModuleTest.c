@@ -66,7 +66,7 @@ static void Test_UART(void){
 static void Test_I2C(void){
 	/*CODE_FILL*/						
 	/* Check if RGB Color Sensor has been detected and display the ret value on PC serial terminal. */
-	uint8_t ret = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_ID_R_ADDR);
+	uint8_t ret = I2C_Receive(&I2C0_Bus, TCS34727_ADDR, TCS34727_CMD|TCS34727_ID_R_ADDR);
 	
 	// Return in Hex
 	sprintf(printBuf, "ID: %x\r\n", ret);
@@ -189,13 +189,11 @@ static void Test_LCD(void){
 
 static void Test_Full_System(void){
 	/* Grab Accelerometer and Gyroscope Raw Data*/
-	/*CODE_FILL*/
-		
 	/* Process Raw Accelerometer and Gyroscope Data */
-	/*CODE_FILL*/
+	//Both done by the scheduled IMU read in I2CMain.c, Accel_Instance and Gyro_Instance are current
 		
 	/* Calculate Tilt Angle */
-	/*CODE_FILL*/
+	MPU6050_Get_Angle(&Accel_Instance, &Gyro_Instance, &Angle_Instance);
 		
 	/* Drive Servo Accordingly to Tilt Angle on X-Axis*/
 	/*CODE_FILL*/
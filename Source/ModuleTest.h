@@ -9,6 +9,9 @@
  *
  */
  
+#include "MPU6050.h"
+#include "TCS34727.h"
+
 typedef enum{
 	DELAY_TEST,
 	UART_TEST,
@@ -20,4 +23,9 @@ typedef enum{
 	FULL_SYSTEM_TEST
 } MODULE_TEST_NAME;
  
+/* Latest Sensor Data (FULL_SYSTEM keeps it current from the scheduled reads in I2CMain.c) */
+extern RGB_COLOR_HANDLE_t RGB_COLOR;
+extern MPU6050_ACCEL_t Accel_Instance;
+extern MPU6050_GYRO_t Gyro_Instance;
+ 
 void Module_Test(MODULE_TEST_NAME test);
\ No newline at end of file
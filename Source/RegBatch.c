@@ -0,0 +1,139 @@
+/*
+ * RegBatch.c
+ *
+ *	Main implementation of the register read batching
+ *
+ */
+
+#include "RegBatch.h"
+
+/*
+ *	-----------------RegBatch_Init------------------
+ *	Set up an empty batch for a device. Use a max_gap of 0 if
+ *	reading a register has side effects (FIFO, clear on read)
+ *	Input: Batch, Bus Handle, Slave Address, Register Prefix, Burst
+ *				 Prefix & Largest Gap to read through (or REG_BATCH_NO_AUTO_INC)
+ *	Output: None
+ */
+void RegBatch_Init(REG_BATCH_t* batch, I2C_BUS_t* bus, uint8_t slave_addr, uint8_t reg_prefix, uint8_t burst_prefix,
+									 uint8_t max_gap){
+	batch->bus = bus;
+	batch->slave_addr = slave_addr;
+	batch->reg_prefix = reg_prefix;
+	batch->burst_prefix = burst_prefix;
+	batch->max_gap = max_gap;
+	batch->count = 0;
+}
+
+/*
+ *	-----------------RegBatch_Add------------------
+ *	Ask for one more register on the next RegBatch_Run
+ *	Input: Batch, Register Address & Where its value goes
+ *	Output: I2C_STATUS_OK, or I2C_STATUS_INVALID if the batch is full
+ */
+uint8_t RegBatch_Add(REG_BATCH_t* batch, uint8_t reg, uint8_t* value){
+
+	uint8_t i;
+
+	/* Asserting Param */
+	if(batch->count >= REG_BATCH_MAX_REGS)
+		return I2C_STATUS_INVALID;
+
+	//Insert in register order so RegBatch_Run only has to walk the list
+	for(i = batch->count; i > 0 && batch->entries[i - 1].reg > reg; i--)
+		batch->entries[i] = batch->entries[i - 1];
+	batch->entries[i].reg = reg;
+	batch->entries[i].value = value;
+	batch->count++;
+
+	return I2C_STATUS_OK;
+}
+
+/*
+ *	-----------------RegBatch_Clear------------------
+ *	Drop every requested register
+ *	Input: Batch
+ *	Output: None
+ */
+void RegBatch_Clear(REG_BATCH_t* batch){
+	batch->count = 0;
+}
+
+/*
+ *	----------------RegBatch_Transfer-----------------
+ *	Local function that reads as many of the requests as fit in one
+ *	transfer, starting at *next: each burst is a register address
+ *	write followed by a read, the bursts are chained with repeated
+ *	STARTs
+ *	Input: Batch & Index of the first request (moved past the ones read)
+ *	Output: Any Errors if detected, otherwise 0
+ */
+static uint8_t RegBatch_Transfer(REG_BATCH_t* batch, uint8_t* next){
+
+	REG_BATCH_ENTRY_t* entries = batch->entries;
+	I2C_SEGMENT_t segments[2*REG_BATCH_MAX_RUNS];
+	uint8_t headers[REG_BATCH_MAX_RUNS];
+	uint8_t data[REG_BATCH_MAX_BYTES];
+	uint8_t offset[REG_BATCH_MAX_REGS];			//Where each request sits in data
+	uint8_t first = *next;
+	uint8_t i = *next;
+	uint8_t runs = 0;
+	uint8_t used = 0;
+	uint8_t start, end;
+	uint8_t ret;
+
+	while(i < batch->count && runs < REG_BATCH_MAX_RUNS && used < REG_BATCH_MAX_BYTES){
+
+		/* Grow the burst while the next request is close enough to read through and still fits */
+		start = end = entries[i].reg;
+		offset[i++] = used;
+		while(batch->max_gap != REG_BATCH_NO_AUTO_INC && i < batch->count){
+			if(entries[i].reg > end + batch->max_gap + 1 || entries[i].reg - start >= REG_BATCH_MAX_BYTES - used)
+				break;
+			end = entries[i].reg;
+			offset[i++] = used + (end - start);
+		}
+
+		headers[runs] = ((start == end) ? batch->reg_prefix : batch->burst_prefix)|start;
+		segments[2*runs].flags = I2C_SEG_WRITE;
+		segments[2*runs].buf = &headers[runs];
+		segments[2*runs].len = 1;
+		segments[2*runs + 1].flags = I2C_SEG_READ;
+		segments[2*runs + 1].buf = &data[used];
+		segments[2*runs + 1].len = end - start + 1;
+
+		used += end - start + 1;
+		runs++;
+	}
+	*next = i;
+
+	ret = I2C_Transfer(batch->bus, batch->slave_addr, segments, 2*runs);
+	if(ret != I2C_STATUS_OK)
+		return ret;
+
+	/* Hand every request its byte */
+	for(i = first; i < *next; i++)
+		*entries[i].value = data[offset[i]];
+
+	return I2C_STATUS_OK;
+}
+
+/*
+ *	------------------RegBatch_Run-------------------
+ *	Read every requested register with as few bus transactions as
+ *	possible. The requests are kept, so the same batch can run again
+ *	next tick
+ *	Input: Batch
+ *	Output: Any Errors if detected, otherwise 0 (values are only valid on 0)
+ */
+uint8_t RegBatch_Run(REG_BATCH_t* batch){
+
+	uint8_t next = 0;
+	uint8_t ret = I2C_STATUS_OK;
+
+	//Usually a single transfer, more only if the requests overflow one
+	while(next < batch->count && ret == I2C_STATUS_OK)
+		ret = RegBatch_Transfer(batch, &next);
+
+	return ret;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+ * RegBatch.h
+ *
+ *	Batches register reads. A driver declares the registers it needs
+ *	(in any order), then one call reads them all: registers close to
+ *	each other share a burst read, bursts that are far apart share
+ *	one transfer with a repeated START in between
+ *
+ */
+
+#ifndef REGBATCH_H_
+#define REGBATCH_H_
+
+#include <stdint.h>
+#include "I2C.h"
+
+/* List of Batch Macros */
+#define REG_BATCH_MAX_REGS		(16)				//Registers one batch can ask for
+#define REG_BATCH_MAX_RUNS		(4)					//Bursts in one transfer, more start another transfer
+#define REG_BATCH_MAX_BYTES		(32)				//Bytes read in one transfer (read-through gaps included)
+#define REG_BATCH_DEFAULT_GAP	(3)					//Reading up to 3 unused registers is cheaper than a new burst
+#define REG_BATCH_NO_AUTO_INC	(0xFF)			//Device has no auto-increment, every register is its own read
+
+/* Requested Register */
+typedef struct{
+	uint8_t reg;
+	uint8_t* value;										//Where the register value goes
+} REG_BATCH_ENTRY_t;
+
+/* Read Batch of one device */
+typedef struct{
+	I2C_BUS_t* bus;
+	uint8_t slave_addr;
+	uint8_t reg_prefix;								//OR'd into a single register address (e.g. command bit)
+	uint8_t burst_prefix;							//Same for bursts (e.g. command bit + auto-increment)
+	uint8_t max_gap;									//Unused registers that may be read through to join two bursts
+
+	REG_BATCH_ENTRY_t entries[REG_BATCH_MAX_REGS];		//Kept sorted by register
+	uint8_t count;
+} REG_BATCH_t;
+
+/*
+ *	-----------------RegBatch_Init------------------
+ *	Set up an empty batch for a device. Use a max_gap of 0 if
+ *	reading a register has side effects (FIFO, clear on read)
+ *	Input: Batch, Bus Handle, Slave Address, Register Prefix, Burst
+ *				 Prefix & Largest Gap to read through (or REG_BATCH_NO_AUTO_INC)
+ *	Output: None
+ */
+void RegBatch_Init(REG_BATCH_t* batch, I2C_BUS_t* bus, uint8_t slave_addr, uint8_t reg_prefix, uint8_t burst_prefix,
+									 uint8_t max_gap);
+
+/*
+ *	-----------------RegBatch_Add------------------
+ *	Ask for one more register on the next RegBatch_Run
+ *	Input: Batch, Register Address & Where its value goes
+ *	Output: I2C_STATUS_OK, or I2C_STATUS_INVALID if the batch is full
+ */
+uint8_t RegBatch_Add(REG_BATCH_t* batch, uint8_t reg, uint8_t* value);
+
+/*
+ *	-----------------RegBatch_Clear------------------
+ *	Drop every requested register
+ *	Input: Batch
+ *	Output: None
+ */
+void RegBatch_Clear(REG_BATCH_t* batch);
+
+/*
+ *	------------------RegBatch_Run-------------------
+ *	Read every requested register with as few bus transactions as
+ *	possible. The requests are kept, so the same batch can run again
+ *	next tick
+ *	Input: Batch
+ *	Output: Any Errors if detected, otherwise 0 (values are only valid on 0)
+ */
+uint8_t RegBatch_Run(REG_BATCH_t* batch);
+
+#endif //REGBATCH_H_
\ No newline at end of file
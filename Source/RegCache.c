@@ -0,0 +1,223 @@
+/*
+ * RegCache.c
+ *
+ *	Main implementation of the configuration register cache
+ *
+ */
+
+#include "RegCache.h"
+#include "util.h"
+
+/*
+ *	----------------RegCache_Index------------------
+ *	Local function that finds where a register sits in the cache
+ *	Input: Cache & Register Address
+ *	Output: Index, or count if the register isn't cached
+ */
+static uint8_t RegCache_Index(REG_CACHE_t* cache, uint8_t reg){
+	uint8_t i;
+
+	for(i = 0; i < cache->count; i++){
+		if(cache->regs[i] == reg)
+			break;
+	}
+	return i;
+}
+
+/*
+ *	-----------------RegCache_Init------------------
+ *	Set up an empty cache for a device
+ *	Input: Cache, Bus Handle, Slave Address, Register Prefix, Burst
+ *				 Prefix, Register List, Value Storage & Number of Registers
+ *	Output: None
+ */
+void RegCache_Init(REG_CACHE_t* cache, I2C_BUS_t* bus, uint8_t slave_addr, uint8_t reg_prefix, uint8_t burst_prefix,
+									 const uint8_t* regs, uint8_t* values, uint8_t count){
+
+	/* Asserting Param */
+	if(count > REG_CACHE_MAX_REGS)
+		count = REG_CACHE_MAX_REGS;
+
+	cache->bus = bus;
+	cache->slave_addr = slave_addr;
+	cache->reg_prefix = reg_prefix;
+	cache->burst_prefix = burst_prefix;
+	cache->regs = regs;
+	cache->values = values;
+	cache->count = count;
+	cache->valid = 0;
+}
+
+/*
+ *	-----------------RegCache_Read------------------
+ *	Read a register, from RAM if it is cached and valid, otherwise
+ *	from the device (and cache it)
+ *	Input: Cache, Register Address & Value to fill
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t RegCache_Read(REG_CACHE_t* cache, uint8_t reg, uint8_t* value){
+
+	uint8_t index = RegCache_Index(cache, reg);
+	uint8_t ret;
+
+	/* Hit: no bus traffic at all */
+	if(index < cache->count && (cache->valid & (1UL << index))){
+		*value = cache->values[index];
+		return I2C_STATUS_OK;
+	}
+
+	ret = I2C_Burst_Receive(cache->bus, cache->slave_addr, cache->reg_prefix|reg, value, 1);
+	if(ret == I2C_STATUS_OK && index < cache->count){
+		cache->values[index] = *value;
+		cache->valid |= (1UL << index);
+	}
+
+	return ret;
+}
+
+/*
+ *	-----------------RegCache_Write------------------
+ *	Write a register on the device and update its shadow copy
+ *	Input: Cache, Register Address & Value
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t RegCache_Write(REG_CACHE_t* cache, uint8_t reg, uint8_t value){
+
+	uint8_t index = RegCache_Index(cache, reg);
+	uint8_t ret;
+
+	ret = I2C_Transmit(cache->bus, cache->slave_addr, cache->reg_prefix|reg, value);
+	if(index < cache->count){
+		//On an error the device may or may not have taken the value
+		if(ret == I2C_STATUS_OK){
+			cache->values[index] = value;
+			cache->valid |= (1UL << index);
+		}
+		else
+			cache->valid &= ~(1UL << index);
+	}
+
+	return ret;
+}
+
+/*
+ *	---------------RegCache_Invalidate----------------
+ *	Forget every shadow value (device reset, or written behind the
+ *	cache's back)
+ *	Input: Cache
+ *	Output: None
+ */
+void RegCache_Invalidate(REG_CACHE_t* cache){
+	cache->valid = 0;
+}
+
+/*
+ *	----------------RegCache_Refresh-----------------
+ *	Reload every cached register from the device
+ *	Input: Cache
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t RegCache_Refresh(REG_CACHE_t* cache){
+
+	uint8_t ret = I2C_STATUS_OK;
+	uint8_t value;
+	uint8_t i;
+
+	RegCache_Invalidate(cache);
+	for(i = 0; i < cache->count; i++){
+		//Keep going so one bad read doesn't leave the rest stale
+		if(RegCache_Read(cache, cache->regs[i], &value) != I2C_STATUS_OK)
+			ret = I2C_STATUS_ERROR;
+	}
+
+	return ret;
+}
+
+/*
+ *	----------------RegCache_Shadow-----------------
+ *	Local function that records a value the device now holds (or
+ *	forgets it when unsure)
+ *	Input: Cache, Register Address, Value & Known Flag
+ *	Output: None
+ */
+static void RegCache_Shadow(REG_CACHE_t* cache, uint8_t reg, uint8_t value, uint8_t known){
+
+	uint8_t index = RegCache_Index(cache, reg);
+
+	if(index >= cache->count)
+		return;
+	if(known){
+		cache->values[index] = value;
+		cache->valid |= (1UL << index);
+	}
+	else
+		cache->valid &= ~(1UL << index);
+}
+
+/*
+ *	----------------RegCache_Run_Init-----------------
+ *	Run an init sequence. Consecutive registers go out as one burst
+ *	write (a delay ends the burst), verified groups are read back in
+ *	one burst too. Shadow copies follow what was written. Stops at
+ *	the first failure
+ *	Input: Cache, Init Table, Number of Entries & Failed Register
+ *				 (filled on failure, can be 0)
+ *	Output: Any Errors if detected (REG_INIT_VERIFY_FAIL on a
+ *					mismatch), otherwise 0
+ */
+uint8_t RegCache_Run_Init(REG_CACHE_t* cache, const REG_INIT_t* table, uint8_t count, uint8_t* failed_reg){
+
+	uint8_t values[REG_INIT_MAX_BURST];
+	uint8_t readback[REG_INIT_MAX_BURST];
+	uint8_t first, size, verify;
+	uint8_t failed = 0;
+	uint8_t ret = I2C_STATUS_OK;
+	uint8_t i;
+
+	for(first = 0; first < count; first += size){
+
+		/* Grow the burst while the next entry is the next register and nothing waits in between */
+		values[0] = table[first].value;
+		verify = table[first].verify_mask;
+		for(size = 1; first + size < count && size < REG_INIT_MAX_BURST; size++){
+			if(table[first + size - 1].delay_ms != 0 || table[first + size].reg != table[first].reg + size)
+				break;
+			values[size] = table[first + size].value;
+			verify |= table[first + size].verify_mask;
+		}
+
+		if(size == 1)
+			ret = I2C_Transmit(cache->bus, cache->slave_addr, cache->reg_prefix|table[first].reg, values[0]);
+		else
+			ret = I2C_Burst_Transmit(cache->bus, cache->slave_addr, cache->burst_prefix|table[first].reg, values, size);
+
+		for(i = 0; i < size; i++)
+			RegCache_Shadow(cache, table[first + i].reg, values[i], ret == I2C_STATUS_OK);
+		failed = first;
+		if(ret != I2C_STATUS_OK)
+			break;
+
+		/* Read back the whole group, compare only the bits each entry asks for */
+		if(verify){
+			ret = I2C_Burst_Receive(cache->bus, cache->slave_addr,
+															((size == 1) ? cache->reg_prefix : cache->burst_prefix)|table[first].reg, readback, size);
+			for(i = 0; i < size && ret == I2C_STATUS_OK; i++){
+				if((readback[i] ^ values[i]) & table[first + i].verify_mask){
+					RegCache_Shadow(cache, table[first + i].reg, readback[i], 1);
+					failed = first + i;
+					ret = REG_INIT_VERIFY_FAIL;
+				}
+			}
+			if(ret != I2C_STATUS_OK)
+				break;
+		}
+
+		if(table[first + size - 1].delay_ms)
+			DELAY_1MS(table[first + size - 1].delay_ms);
+	}
+
+	if(ret != I2C_STATUS_OK && failed_reg)
+		*failed_reg = table[failed].reg;
+
+	return ret;
+}
@@ -0,0 +1,103 @@
+/*
+ * RegCache.h
+ *
+ *	Provides a shadow copy of a device's configuration registers.
+ *	Every write through the cache lands in RAM as well, so reading
+ *	a cached register back costs no bus time. After a device reset
+ *	invalidate the cache (and refresh it if needed)
+ *
+ *	Also runs init sequences: a const table of register writes is
+ *	sent as few burst writes as possible, with optional read-back
+ *
+ */
+
+#ifndef REGCACHE_H_
+#define REGCACHE_H_
+
+#include <stdint.h>
+#include "I2C.h"
+
+/* List of Cache Macros */
+#define REG_CACHE_MAX_REGS		(32)				//One valid bit per register
+#define REG_INIT_MAX_BURST		(16)				//Longest run of registers sent as one burst
+#define REG_INIT_VERIFY_FAIL	(0xFB)			//Read-back didn't match (next to the I2C_STATUS_* codes)
+
+/* Register Cache of one device */
+typedef struct{
+	I2C_BUS_t* bus;
+	uint8_t slave_addr;
+	uint8_t reg_prefix;								//OR'd into every register address (e.g. command bit)
+	uint8_t burst_prefix;							//Same for bursts (e.g. command bit + auto-increment)
+
+	const uint8_t* regs;							//Cached register addresses
+	uint8_t* values;									//Shadow values, same order as regs
+	uint8_t count;
+	uint32_t valid;										//Bit n set when values[n] matches the device
+} REG_CACHE_t;
+
+/* Init Sequence Entry, tables of these live in flash */
+typedef struct{
+	uint8_t reg;
+	uint8_t value;
+	uint8_t delay_ms;									//Wait after this write (ends a burst)
+	uint8_t verify_mask;							//Bits to read back and compare, 0 to skip
+} REG_INIT_t;
+
+/*
+ *	-----------------RegCache_Init------------------
+ *	Set up an empty cache for a device
+ *	Input: Cache, Bus Handle, Slave Address, Register Prefix, Burst
+ *				 Prefix, Register List, Value Storage & Number of Registers
+ *	Output: None
+ */
+void RegCache_Init(REG_CACHE_t* cache, I2C_BUS_t* bus, uint8_t slave_addr, uint8_t reg_prefix, uint8_t burst_prefix,
+									 const uint8_t* regs, uint8_t* values, uint8_t count);
+
+/*
+ *	-----------------RegCache_Read------------------
+ *	Read a register, from RAM if it is cached and valid, otherwise
+ *	from the device (and cache it)
+ *	Input: Cache, Register Address & Value to fill
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t RegCache_Read(REG_CACHE_t* cache, uint8_t reg, uint8_t* value);
+
+/*
+ *	-----------------RegCache_Write------------------
+ *	Write a register on the device and update its shadow copy
+ *	Input: Cache, Register Address & Value
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t RegCache_Write(REG_CACHE_t* cache, uint8_t reg, uint8_t value);
+
+/*
+ *	---------------RegCache_Invalidate----------------
+ *	Forget every shadow value (device reset, or written behind the
+ *	cache's back)
+ *	Input: Cache
+ *	Output: None
+ */
+void RegCache_Invalidate(REG_CACHE_t* cache);
+
+/*
+ *	----------------RegCache_Refresh-----------------
+ *	Reload every cached register from the device
+ *	Input: Cache
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t RegCache_Refresh(REG_CACHE_t* cache);
+
+/*
+ *	----------------RegCache_Run_Init-----------------
+ *	Run an init sequence. Consecutive registers go out as one burst
+ *	write (a delay ends the burst), verified groups are read back in
+ *	one burst too. Shadow copies follow what was written. Stops at
+ *	the first failure
+ *	Input: Cache, Init Table, Number of Entries & Failed Register
+ *				 (filled on failure, can be 0)
+ *	Output: Any Errors if detected (REG_INIT_VERIFY_FAIL on a
+ *					mismatch), otherwise 0
+ */
+uint8_t RegCache_Run_Init(REG_CACHE_t* cache, const REG_INIT_t* table, uint8_t count, uint8_t* failed_reg);
+
+#endif //REGCACHE_H_
@@ -0,0 +1,131 @@
+/*
+ * Ring.c
+ *
+ *	Main implementation of the single producer, single consumer ring
+ *	buffer
+ *
+ */
+
+#include "Ring.h"
+#include "util.h"
+#include <string.h>
+
+/*
+ *	-------------------Ring_Copy------------------
+ *	Local function that copies records between a flat buffer and
+ *	the ring, in two pieces when it wraps around the end
+ *	Input: Ring, Ring Index, Flat Buffer, Number of Records & Direction (1 = into the ring)
+ *	Output: None
+ */
+static void Ring_Copy(RING_t* ring, uint32_t index, uint8_t* flat, uint32_t count, uint8_t into){
+
+	uint32_t slot = index & ring->mask;
+	uint32_t first = ring->capacity - slot;
+	uint8_t* slot_ptr = ring->storage + slot*ring->record_size;
+
+	if(first > count)
+		first = count;
+
+	if(into){
+		memcpy(slot_ptr, flat, first*ring->record_size);
+		memcpy(ring->storage, flat + first*ring->record_size, (count - first)*ring->record_size);
+	}
+	else{
+		memcpy(flat, slot_ptr, first*ring->record_size);
+		memcpy(flat + first*ring->record_size, ring->storage, (count - first)*ring->record_size);
+	}
+}
+
+/*
+ *	-------------------Ring_Init------------------
+ *	Set up an empty ring on caller storage. Call before either side
+ *	starts using it
+ *	Input: Ring, Storage, Record Size in bytes & Capacity in records (power of two)
+ *	Output: RING_OK, or RING_INVALID if the capacity isn't a power of two
+ */
+uint8_t Ring_Init(RING_t* ring, void* storage, uint32_t record_size, uint32_t capacity){
+
+	/* Asserting Param */
+	if(capacity == 0 || (capacity & (capacity - 1)) != 0 || record_size == 0)
+		return RING_INVALID;
+
+	ring->storage = storage;
+	ring->record_size = record_size;
+	ring->capacity = capacity;
+	ring->mask = capacity - 1;
+	ring->head = ring->tail = 0;
+	ring->high_water = 0;
+	ring->dropped = 0;
+
+	return RING_OK;
+}
+
+/*
+ *	-------------------Ring_Push------------------
+ *	Producer side: append up to count records. Records that don't
+ *	fit are dropped (and counted), the oldest ones are never lost
+ *	Input: Ring, Records & Number of Records
+ *	Output: Number of records appended
+ */
+uint32_t Ring_Push(RING_t* ring, const void* records, uint32_t count){
+
+	uint32_t head = ring->head;							//Own index, no one else moves it
+	uint32_t used = head - ring->tail;
+	uint32_t space = ring->capacity - used;
+
+	if(count > space){
+		ring->dropped += count - space;
+		count = space;
+	}
+	if(count == 0)
+		return 0;
+
+	Ring_Copy(ring, head, (uint8_t*)records, count, 1);
+
+	//Records have to be in place before the consumer can see the new head
+	MEMORY_BARRIER();
+	ring->head = head + count;
+
+	if(used + count > ring->high_water)
+		ring->high_water = used + count;
+
+	return count;
+}
+
+/*
+ *	-------------------Ring_Pop------------------
+ *	Consumer side: take up to count of the oldest records
+ *	Input: Ring, Buffer for the Records & Number of Records
+ *	Output: Number of records taken
+ */
+uint32_t Ring_Pop(RING_t* ring, void* records, uint32_t count){
+
+	uint32_t tail = ring->tail;							//Own index, no one else moves it
+	uint32_t used = ring->head - tail;
+
+	if(count > used)
+		count = used;
+	if(count == 0)
+		return 0;
+
+	//Don't read records from before the head that announced them
+	MEMORY_BARRIER();
+	Ring_Copy(ring, tail, (uint8_t*)records, count, 0);
+
+	//Records have to be read out before the producer can reuse their slots
+	MEMORY_BARRIER();
+	ring->tail = tail + count;
+
+	return count;
+}
+
+/*
+ *	-------------------Ring_Count------------------
+ *	Records waiting. The other side keeps moving: the consumer has
+ *	at least this many, the producer at most this many
+ *	Input: Ring
+ *	Output: Number of records
+ */
+uint32_t Ring_Count(RING_t* ring){
+	return ring->head - ring->tail;
+}
\ No newline at end of file
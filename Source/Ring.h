@@ -0,0 +1,83 @@
+/*
+ * Ring.h
+ *
+ *	Provides a fixed size ring buffer of records for one producer
+ *	and one consumer, e.g. a sensor ISR and the main loop. Neither
+ *	side masks interrupts: each index has a single writer, and the
+ *	records are ordered against the indices with memory barriers
+ *
+ */
+
+#ifndef RING_H_
+#define RING_H_
+
+#include <stdint.h>
+
+/* List of Ring Macros */
+#define RING_OK								(0)
+#define RING_INVALID					(1)
+
+/* Sample Record Flags */
+#define SAMPLE_MOTION					(0x01)			//accel, gyro and temp are valid
+#define SAMPLE_COLOR					(0x02)			//color is valid
+
+/* Sensor Sample Record (raw counts, straight from the registers) */
+typedef struct{
+	uint32_t timestamp_us;						//TIMESTAMP_US when the sample was read
+	uint8_t flags;
+	int16_t accel[3];									//MPU6050 X, Y, Z
+	int16_t temp;
+	int16_t gyro[3];									//MPU6050 X, Y, Z
+	uint16_t color[4];								//TCS34727 Clear, Red, Green, Blue
+} SAMPLE_t;
+
+/* Ring Buffer. Head and tail run freely and wrap at 2^32, the
+	 power of two capacity keeps (index & mask) continuous across it */
+typedef struct{
+	uint8_t* storage;									//capacity*record_size bytes
+	uint32_t record_size;
+	uint32_t capacity;
+	uint32_t mask;
+
+	volatile uint32_t head;						//Written by the producer only
+	volatile uint32_t tail;						//Written by the consumer only
+	volatile uint32_t high_water;			//Most records ever waiting (producer only)
+	volatile uint32_t dropped;				//Records refused because the ring was full (producer only)
+} RING_t;
+
+/*
+ *	-------------------Ring_Init------------------
+ *	Set up an empty ring on caller storage. Call before either side
+ *	starts using it
+ *	Input: Ring, Storage, Record Size in bytes & Capacity in records (power of two)
+ *	Output: RING_OK, or RING_INVALID if the capacity isn't a power of two
+ */
+uint8_t Ring_Init(RING_t* ring, void* storage, uint32_t record_size, uint32_t capacity);
+
+/*
+ *	-------------------Ring_Push------------------
+ *	Producer side: append up to count records. Records that don't
+ *	fit are dropped (and counted), the oldest ones are never lost
+ *	Input: Ring, Records & Number of Records
+ *	Output: Number of records appended
+ */
+uint32_t Ring_Push(RING_t* ring, const void* records, uint32_t count);
+
+/*
+ *	-------------------Ring_Pop------------------
+ *	Consumer side: take up to count of the oldest records
+ *	Input: Ring, Buffer for the Records & Number of Records
+ *	Output: Number of records taken
+ */
+uint32_t Ring_Pop(RING_t* ring, void* records, uint32_t count);
+
+/*
+ *	-------------------Ring_Count------------------
+ *	Records waiting. The other side keeps moving: the consumer has
+ *	at least this many, the producer at most this many
+ *	Input: Ring
+ *	Output: Number of records
+ */
+uint32_t Ring_Count(RING_t* ring);
+
+#endif //RING_H_
\ No newline at end of file
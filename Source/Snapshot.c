@@ -0,0 +1,100 @@
+/*
+ * Snapshot.c
+ *
+ *	Main implementation of the sequence locked snapshot
+ *
+ */
+
+#include "Snapshot.h"
+#include "util.h"
+#include <string.h>
+
+/*
+ *	-----------------Snapshot_Init------------------
+ *	Set up a snapshot on caller storage (generation 0, contents
+ *	are whatever storage holds)
+ *	Input: Snapshot, Storage & Size in bytes
+ *	Output: None
+ */
+void Snapshot_Init(SNAPSHOT_t* snap, void* storage, uint32_t size){
+	snap->storage = storage;
+	snap->size = size;
+	snap->seq = 0;
+}
+
+/*
+ *	-----------------Snapshot_Write------------------
+ *	Writer side: update the value, or just a part of it (use
+ *	offsetof() of a member). Never waits. Two writers must not
+ *	preempt each other
+ *	Input: Snapshot, Offset, New Value & Size in bytes
+ *	Output: None
+ */
+void Snapshot_Write(SNAPSHOT_t* snap, uint32_t offset, const void* value, uint32_t size){
+
+	uint32_t seq = snap->seq;
+
+	/* Asserting Param */
+	if(offset + size > snap->size)
+		return;
+
+	//Odd: readers that start now wait, readers already copying will retry
+	snap->seq = seq + 1;
+	MEMORY_BARRIER();
+
+	memcpy(snap->storage + offset, value, size);
+
+	MEMORY_BARRIER();
+	snap->seq = seq + 2;
+}
+
+/*
+ *	-----------------Snapshot_Read------------------
+ *	Reader side: consistent copy of the whole value
+ *	Input: Snapshot & Buffer of the snapshot size
+ *	Output: Generation of the copy (writes so far)
+ */
+uint32_t Snapshot_Read(SNAPSHOT_t* snap, void* value){
+
+	uint32_t seq;
+
+	/* Copy until no write started or finished while copying */
+	do{
+		do{
+			seq = snap->seq;
+		}while(seq & 1);
+
+		MEMORY_BARRIER();
+		memcpy(value, snap->storage, snap->size);
+		MEMORY_BARRIER();
+	}while(snap->seq != seq);
+
+	return seq >> 1;
+}
+
+/*
+ *	--------------Snapshot_Read_Changed---------------
+ *	Reader side: copy the value only if it changed since the
+ *	generation the reader last saw
+ *	Input: Snapshot, Buffer of the snapshot size & Last Generation
+ *				 (updated when a copy is made)
+ *	Output: 1 if the buffer got a new copy, otherwise 0
+ */
+uint8_t Snapshot_Read_Changed(SNAPSHOT_t* snap, void* value, uint32_t* generation){
+
+	if(Snapshot_Generation(snap) == *generation)
+		return 0;
+
+	*generation = Snapshot_Read(snap, value);
+	return 1;
+}
+
+/*
+ *	---------------Snapshot_Generation----------------
+ *	Number of writes finished so far, cheap to poll
+ *	Input: Snapshot
+ *	Output: Generation (0 until the first write)
+ */
+uint32_t Snapshot_Generation(SNAPSHOT_t* snap){
+	return snap->seq >> 1;
+}
\ No newline at end of file
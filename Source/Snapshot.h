@@ -0,0 +1,82 @@
+/*
+ * Snapshot.h
+ *
+ *	Provides a latest-value snapshot guarded by a sequence lock. The
+ *	writer never waits, a reader copies the value out and tries again
+ *	if a write landed in the middle of its copy, so neither side
+ *	masks interrupts. Readers must not preempt the writer (main loop
+ *	or a lower priority ISR), a reader would spin on a write that
+ *	can't finish
+ *
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <stdint.h>
+#include "MPU6050.h"
+#include "TCS34727.h"
+
+/* Fused Sensor State, the newest of everything */
+typedef struct{
+	uint32_t timestamp_us;						//TIMESTAMP_US of the last update
+	MPU6050_ACCEL_t accel;
+	MPU6050_GYRO_t gyro;
+	MPU6050_ANGLE_t angle;
+	RGB_COLOR_HANDLE_t color;
+} SENSOR_STATE_t;
+
+/* Snapshot. seq is odd while a write is in progress, every write
+	 adds 2, so seq/2 counts the writes */
+typedef struct{
+	volatile uint32_t seq;						//Written by the writer only
+	uint8_t* storage;
+	uint32_t size;
+} SNAPSHOT_t;
+
+/*
+ *	-----------------Snapshot_Init------------------
+ *	Set up a snapshot on caller storage (generation 0, contents
+ *	are whatever storage holds)
+ *	Input: Snapshot, Storage & Size in bytes
+ *	Output: None
+ */
+void Snapshot_Init(SNAPSHOT_t* snap, void* storage, uint32_t size);
+
+/*
+ *	-----------------Snapshot_Write------------------
+ *	Writer side: update the value, or just a part of it (use
+ *	offsetof() of a member). Never waits. Two writers must not
+ *	preempt each other
+ *	Input: Snapshot, Offset, New Value & Size in bytes
+ *	Output: None
+ */
+void Snapshot_Write(SNAPSHOT_t* snap, uint32_t offset, const void* value, uint32_t size);
+
+/*
+ *	-----------------Snapshot_Read------------------
+ *	Reader side: consistent copy of the whole value
+ *	Input: Snapshot & Buffer of the snapshot size
+ *	Output: Generation of the copy (writes so far)
+ */
+uint32_t Snapshot_Read(SNAPSHOT_t* snap, void* value);
+
+/*
+ *	--------------Snapshot_Read_Changed---------------
+ *	Reader side: copy the value only if it changed since the
+ *	generation the reader last saw
+ *	Input: Snapshot, Buffer of the snapshot size & Last Generation
+ *				 (updated when a copy is made)
+ *	Output: 1 if the buffer got a new copy, otherwise 0
+ */
+uint8_t Snapshot_Read_Changed(SNAPSHOT_t* snap, void* value, uint32_t* generation);
+
+/*
+ *	---------------Snapshot_Generation----------------
+ *	Number of writes finished so far, cheap to poll
+ *	Input: Snapshot
+ *	Output: Generation (0 until the first write)
+ */
+uint32_t Snapshot_Generation(SNAPSHOT_t* snap);
+
+#endif //SNAPSHOT_H_
\ No newline at end of file
@@ -11,74 +11,73 @@
 
 #include "TCS34727.h"
 #include "I2C.h"
+#include "RegCache.h"
+#include "RegBatch.h"
 #include "UART0.h"
 #include "util.h"
 #include <stdio.h>
+#include <string.h>
 #include "tm4c123gh6pm.h"
 
+/* Bus the TCS34727 is wired to, set by TCS34727_Init */
+static I2C_BUS_t* TCS34727_Bus;
+
+/* Shadow copy of ENABLE, ATIME and CONTROL, every write goes through it */
+static const uint8_t TCS34727_Cached_Regs[] = {TCS34727_ENABLE_R_ADDR, TCS34727_TIMING_R_ADDR, TCS34727_CTRL_R_ADDR};
+static uint8_t TCS34727_Cached_Values[sizeof(TCS34727_Cached_Regs)];
+static REG_CACHE_t TCS34727_Cache;
+
+/* Bring-up: gain, then power on with the 2.4ms integration time set in the same burst (PON needs
+	 2.4ms before the ADC is enabled), then the ADC and one integration time for the first result.
+	 Gain and integration time are read back */
+static const REG_INIT_t TCS34727_Init_Table[] = {
+	{TCS34727_CTRL_R_ADDR,		TCS34727_CTRL_AGAIN_1,											0,	TCS34727_CTRL_AGAIN_MSK},
+	{TCS34727_ENABLE_R_ADDR,	TCS34727_ENABLE_PON,												0,	0},
+	{TCS34727_TIMING_R_ADDR,	TCS34727_ATIME_2_4_MS,											3,	0xFF},
+	{TCS34727_ENABLE_R_ADDR,	TCS34727_ENABLE_PON|TCS34727_ENABLE_AEN,		3,	0},
+};
+
 /*	-------------------TCS34727_Init------------------
  *	Basic Initialization Function for TCS34727 at default settings
- *	Input: none
+ *	Input: Bus Handle the TCS34727 is on
  *	Output: none
  */
-void TCS34727_Init(void){
+void TCS34727_Init(I2C_BUS_t* bus){
 	uint8_t ret;																//Temp Variable to hold return values
-	char printBuf[20];													//String buffer to print
+	uint8_t reg;																//Register an init error happened at
+	char printBuf[48];													//String buffer to print
 	
-	/* Check if RGB Color Sensor has been detected */
-	ret = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_ID_R_ADDR);
+	TCS34727_Bus = bus;
+	RegCache_Init(&TCS34727_Cache, bus, TCS34727_ADDR, TCS34727_CMD, TCS34727_CMD|TCS34727_CMD_AUTO_INC, TCS34727_Cached_Regs, TCS34727_Cached_Values, sizeof(TCS34727_Cached_Regs));
 	
-	//Print ID or Error to Terminal
-	sprintf(printBuf, "ID: %x\r\n", ret);
-	UART0_OutString(printBuf);
+	/* Check if RGB Color Sensor has been detected */
+	ret = I2C_Receive(TCS34727_Bus, TCS34727_ADDR, TCS34727_CMD|TCS34727_ID_R_ADDR);
 	
 	if(ret != TCS34727_ID){
-		UART0_OutString("TCS34727 has not been Detected\r\n");
+		sprintf(printBuf, "TCS34727 has not been Detected (ID: %x)\r\n", ret);
+		UART0_OutString(printBuf);
 		return;
 	}
-	UART0_OutString("TCS34727 has been Detected\r\n");
 	
-	/* Set Integration Time to 2.4ms in timing register */
-	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_TIMING_R_ADDR, TCS34727_ATIME_2_4_MS);
-	if(ret != 0)
-		UART0_OutString("Error on Transmit\r\n");
-	else
-		UART0_OutString("TCS34727 Integration Time Set\r\n");
-	
-	// Necessary Delay when setting integration time/wait time. 
-	// This varies for which integration time is choosen.
-	// This project chooses 2.4ms.
-	DELAY_1MS(3);
-	
-	/* Setting Gain to 1X gain */
-	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_CTRL_R_ADDR, TCS34727_CTRL_AGAIN_1);
-	if(ret != 0)
-		UART0_OutString("Error on Transmit\r\n");
-	else
-		UART0_OutString("TCS34727 Gain Set\r\n");
+	/* Configure and power up from the init table */
+	ret = RegCache_Run_Init(&TCS34727_Cache, TCS34727_Init_Table, sizeof(TCS34727_Init_Table)/sizeof(TCS34727_Init_Table[0]), &reg);
 	
-	/* Powering On Sensor at Enable register */
-	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_ENABLE_R_ADDR, TCS34727_ENABLE_PON);
+	//One status line for the whole bring-up
 	if(ret != 0)
-		UART0_OutString("Error on Transmit\r\n");
+		sprintf(printBuf, "TCS34727 Init Error %x at Register %x\r\n", ret, reg);
 	else
-		UART0_OutString("TCS34727 Power On\r\n");
+		sprintf(printBuf, "TCS34727 Color Sensor Initialized\r\n");
+	UART0_OutString(printBuf);
+}
 
-	//Nessessary Delay When Powering On Module
-	DELAY_1MS(3);
-	
-	/* Enabling RGBC 2-Channel ADC at Enable register */
-	ret = I2C0_Transmit(TCS34727_ADDR, TCS34727_CMD|TCS34727_ENABLE_R_ADDR, TCS34727_ENABLE_PON |TCS34727_ENABLE_AEN);
-	if(ret != 0)
-		UART0_OutString("Error on Transmit\r\n");
-	else
-		UART0_OutString("TCS34727 RGBC On\r\n");
-	
-	//Integration Time Delay when Activating. Varies with Integration Time Choosen by User
-	DELAY_1MS(3);
-	
-	UART0_OutString("TCS34727 Color Sensor Initialized\r\n");
-	
+/*	--------------TCS34727_Batch_Init----------------
+ *	Local function that starts a read batch on the sensor: single
+ *	registers take the command bit, bursts auto-increment as well
+ *	Input: Batch
+ *	Output: none
+ */
+static void TCS34727_Batch_Init(REG_BATCH_t* batch){
+	RegBatch_Init(batch, TCS34727_Bus, TCS34727_ADDR, TCS34727_CMD, TCS34727_CMD|TCS34727_CMD_AUTO_INC, REG_BATCH_DEFAULT_GAP);
 }
 
 /*	---------------TCS34727_GET_RAW_CLEAR-------------
@@ -87,13 +86,16 @@ void TCS34727_Init(void){
  *	Output: Returns 16-bit RAW clear data
  */
 uint16_t TCS34727_GET_RAW_CLEAR(void){
-	uint8_t clear_low;
-	uint8_t clear_high;
+	REG_BATCH_t batch;
+	uint8_t clear_low = 0;
+	uint8_t clear_high = 0;
 	uint16_t clear_data;
 	
-	/* Use I2C to grab both HIGH and LOW data */
-	clear_low = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_CDATAL_R_ADDR);
-	clear_high = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_CDATAH_R_ADDR);
+	/* Use I2C to grab both HIGH and LOW data in one burst (0 on a bus error) */
+	TCS34727_Batch_Init(&batch);
+	RegBatch_Add(&batch, TCS34727_CDATAL_R_ADDR, &clear_low);
+	RegBatch_Add(&batch, TCS34727_CDATAH_R_ADDR, &clear_high);
+	RegBatch_Run(&batch);
 	
 	/* Concatanate into 16-bit value */
 	clear_data = (clear_high << 8) + (clear_low);
@@ -110,13 +112,16 @@ uint16_t TCS34727_GET_RAW_CLEAR(void){
  *	Output: Returns 16-bit RAW red data
  */
 uint16_t TCS34727_GET_RAW_RED(void){
-	uint8_t red_low;
-	uint8_t red_high;
+	REG_BATCH_t batch;
+	uint8_t red_low = 0;
+	uint8_t red_high = 0;
 	uint16_t red_data;
 	
-	/* Use I2C to grab both HIGH and LOW data */
-	red_low = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_RDATAL_R_ADDR);
-	red_high = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_RDATAH_R_ADDR);
+	/* Use I2C to grab both HIGH and LOW data in one burst (0 on a bus error) */
+	TCS34727_Batch_Init(&batch);
+	RegBatch_Add(&batch, TCS34727_RDATAL_R_ADDR, &red_low);
+	RegBatch_Add(&batch, TCS34727_RDATAH_R_ADDR, &red_high);
+	RegBatch_Run(&batch);
 	
 	/* Concatanate into 16-bit value */
 	red_data = (red_high << 8) + (red_low);
@@ -133,13 +138,16 @@ uint16_t TCS34727_GET_RAW_RED(void){
  *	Output: Returns 16-bit RAW green data
  */
 uint16_t TCS34727_GET_RAW_GREEN(void){
-	uint8_t green_low;
-	uint8_t green_high;
+	REG_BATCH_t batch;
+	uint8_t green_low = 0;
+	uint8_t green_high = 0;
 	uint16_t green_data;
 	
-	/* Use I2C to grab both HIGH and LOW data */
-	green_low = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_GDATAL_R_ADDR);
-	green_high = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_GDATAH_R_ADDR);
+	/* Use I2C to grab both HIGH and LOW data in one burst (0 on a bus error) */
+	TCS34727_Batch_Init(&batch);
+	RegBatch_Add(&batch, TCS34727_GDATAL_R_ADDR, &green_low);
+	RegBatch_Add(&batch, TCS34727_GDATAH_R_ADDR, &green_high);
+	RegBatch_Run(&batch);
 	
 	/* Concatanate into 16-bit value */
 	green_data = (green_high << 8) + (green_low);
@@ -156,13 +164,16 @@ uint16_t TCS34727_GET_RAW_GREEN(void){
  *	Output: Returns 16-bit RAW blue data
  */
 uint16_t TCS34727_GET_RAW_BLUE(void){
-	uint8_t blue_low;
-	uint8_t blue_high;
+	REG_BATCH_t batch;
+	uint8_t blue_low = 0;
+	uint8_t blue_high = 0;
 	uint16_t blue_data;
 	
-	/* Use I2C to grab both HIGH and LOW data */
-	blue_low = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_BDATAL_R_ADDR);
-	blue_high = I2C0_Receive(TCS34727_ADDR, TCS34727_CMD|TCS34727_BDATAH_R_ADDR);
+	/* Use I2C to grab both HIGH and LOW data in one burst (0 on a bus error) */
+	TCS34727_Batch_Init(&batch);
+	RegBatch_Add(&batch, TCS34727_BDATAL_R_ADDR, &blue_low);
+	RegBatch_Add(&batch, TCS34727_BDATAH_R_ADDR, &blue_high);
+	RegBatch_Run(&batch);
 	
 	/* Concatanate into 16-bit value*/
 	blue_data = (blue_high << 8) + (blue_low);
@@ -174,15 +185,60 @@ uint16_t TCS34727_GET_RAW_BLUE(void){
 }
 
 /*	---------------TCS34727_GET_RGB------------------
- *	Normalize RAW data into RGB range (0-255)
+ *	Normalize RAW data into RGB range (0-255). All four channels
+ *	come from one burst, so they belong to the same integration
+ *	(left as is on a bus error)
  *	Input: RGB Color Struct User Instance
  *	Output: none
  */
 void TCS34727_GET_RGB(RGB_COLOR_HANDLE_t* RGB_COLOR_Instance){
-	RGB_COLOR_Instance->R_RAW = TCS34727_GET_RAW_RED();
-	RGB_COLOR_Instance->G_RAW = TCS34727_GET_RAW_GREEN();
-	RGB_COLOR_Instance->B_RAW = TCS34727_GET_RAW_BLUE();
-	RGB_COLOR_Instance->C_RAW = TCS34727_GET_RAW_CLEAR();
+	REG_BATCH_t batch;
+	uint8_t data[TCS34727_RGBC_DATA_SIZE];
+	uint8_t i;
+	
+	TCS34727_Batch_Init(&batch);
+	for(i = 0; i < TCS34727_RGBC_DATA_SIZE; i++)
+		RegBatch_Add(&batch, TCS34727_CDATAL_R_ADDR + i, &data[i]);
+	if(RegBatch_Run(&batch) != I2C_STATUS_OK)
+		return;
+	
+	//Integration Time Delay, once per sample
+	DELAY_1MS(3);
+	
+	TCS34727_Unpack_RGBC(data, RGB_COLOR_Instance);
+}
+
+/*	------------TCS34727_RGBC_Transaction------------
+ *	Fill in a transaction descriptor for the same burst as
+ *	TCS34727_GET_RGB, for callers that run it themselves (e.g.
+ *	through the I2C scheduler). Turn the data into a color with
+ *	TCS34727_Unpack_RGBC once it is done
+ *	Input: Transaction Descriptor & Data Buffer (TCS34727_RGBC_DATA_SIZE bytes)
+ *	Output: none
+ */
+void TCS34727_RGBC_Transaction(I2C_TRANSACTION_t* transaction, uint8_t* data){
+	
+	memset(transaction, 0, sizeof(*transaction));
+	transaction->slave_addr = TCS34727_ADDR;
+	transaction->slave_reg_addr = TCS34727_CMD|TCS34727_CMD_AUTO_INC|TCS34727_CDATAL_R_ADDR;
+	transaction->rx_data = data;
+	transaction->rx_size = TCS34727_RGBC_DATA_SIZE;
+	transaction->done = 1;
+}
+
+/*	---------------TCS34727_Unpack_RGBC---------------
+ *	Fill the RAW fields from the 8 bytes at CDATAL and normalize
+ *	them into RGB range (0-255)
+ *	Input: Data & RGB Color User Instance Struct
+ *	Output: none
+ */
+void TCS34727_Unpack_RGBC(const uint8_t* data, RGB_COLOR_HANDLE_t* RGB_COLOR_Instance){
+	
+	RGB_COLOR_Instance->C_RAW = (data[1] << 8) + data[0];
+	RGB_COLOR_Instance->R_RAW = (data[3] << 8) + data[2];
+	RGB_COLOR_Instance->G_RAW = (data[5] << 8) + data[4];
+	RGB_COLOR_Instance->B_RAW = (data[7] << 8) + data[6];
+	
 	/* Prevent Dividing by 0 by checking if the C_RAW value from struct is equal to 0 */
 	if(RGB_COLOR_Instance->C_RAW == 0){
 		RGB_COLOR_Instance->R = RGB_COLOR_Instance->G = RGB_COLOR_Instance->B = 0;
@@ -199,6 +255,38 @@ void TCS34727_GET_RGB(RGB_COLOR_HANDLE_t* RGB_COLOR_Instance){
 	
 }
 
+/*	----------------TCS34727_Get_Gain----------------
+ *	Current RGBC gain setting (shadow copy, no bus traffic)
+ *	Input: none
+ *	Output: AGAIN field of the control register
+ */
+uint8_t TCS34727_Get_Gain(void){
+	uint8_t value = 0;
+	RegCache_Read(&TCS34727_Cache, TCS34727_CTRL_R_ADDR, &value);
+	return value & TCS34727_CTRL_AGAIN_MSK;
+}
+
+/*	----------------TCS34727_Get_ATIME---------------
+ *	Current integration time setting (shadow copy, no bus traffic)
+ *	Input: none
+ *	Output: ATIME register value, integration time = (256 - ATIME) * 2.4ms
+ */
+uint8_t TCS34727_Get_ATIME(void){
+	uint8_t value = 0;
+	RegCache_Read(&TCS34727_Cache, TCS34727_TIMING_R_ADDR, &value);
+	return value;
+}
+
+/*	--------------TCS34727_Refresh_Config-------------
+ *	Reload the shadow copy of ENABLE, ATIME and CONTROL, call it
+ *	after the sensor was power cycled behind the driver
+ *	Input: none
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t TCS34727_Refresh_Config(void){
+	return RegCache_Refresh(&TCS34727_Cache);
+}
+
 /*	-----------------Detect_Color--------------------
  *	Detect which color is more prominant and returns that color
  *	Input: RGB Color User Instance Struct
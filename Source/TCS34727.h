@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 #include "util.h"
+#include "I2C.h"
 
 /* List of Fill In Macros (Not all need to be filled)
 
@@ -34,6 +35,7 @@ Comment Out All Macros that are not used
 
 /*************Command Register*************/
 #define TCS34727_CMD							(0x01<<7)  // define the bit that indicates a command register
+	#define TCS34727_CMD_AUTO_INC		(0x01<<5)  // type field: auto-increment protocol for bursts
 
 /*************Enable Registers*************/
 #define TCS34727_ENABLE_R_ADDR		(0x00)  // enable register address
@@ -49,6 +51,7 @@ Comment Out All Macros that are not used
 /************Control Registers*************/
 #define TCS34727_CTRL_R_ADDR				(0x0F)  // Define control register address
 	#define TCS34727_CTRL_AGAIN_1		(0x00)
+	#define TCS34727_CTRL_AGAIN_MSK	(0x03)
 	
 /**************ID Registers****************/
 #define TCS34727_ID_R_ADDR			(0x12)
@@ -66,6 +69,8 @@ Comment Out All Macros that are not used
 /*************TCS34727 device ID Values**************/
 #define TCS34727_ID			(0x4D)
 
+#define TCS34727_RGBC_DATA_SIZE		(8)			//CDATAL..BDATAH
+
 /* Custom Return Type */
 typedef enum{
 	RED_DETECT 			= 0,
@@ -88,10 +93,10 @@ typedef struct{
 
 /*	-------------------TCS34727_Init------------------
  *	Basic Initialization Function for TCS34727 at default settings
- *	Input: none
+ *	Input: Bus Handle the TCS34727 is on
  *	Output: none
  */
-void TCS34727_Init(void);
+void TCS34727_Init(I2C_BUS_t* bus);
 
 /*	---------------TCS34727_GET_RAW_CLEAR-------------
  *	Receive RAW clear data reading from the sensor
@@ -122,12 +127,54 @@ uint16_t TCS34727_GET_RAW_GREEN(void);
 uint16_t TCS34727_GET_RAW_BLUE(void);
 
 /*	---------------TCS34727_GET_RGB------------------
- *	Normalize RAW data into RGB range (0-255)
+ *	Normalize RAW data into RGB range (0-255). All four channels
+ *	come from one burst, so they belong to the same integration
+ *	(left as is on a bus error)
  *	Input: RGB Color User Instance Struct
  *	Output: none
  */
 void TCS34727_GET_RGB(RGB_COLOR_HANDLE_t* RGB_COLOR_Instance);
 
+/*	------------TCS34727_RGBC_Transaction------------
+ *	Fill in a transaction descriptor for the same burst as
+ *	TCS34727_GET_RGB, for callers that run it themselves (e.g.
+ *	through the I2C scheduler). Turn the data into a color with
+ *	TCS34727_Unpack_RGBC once it is done
+ *	Input: Transaction Descriptor & Data Buffer (TCS34727_RGBC_DATA_SIZE bytes)
+ *	Output: none
+ */
+void TCS34727_RGBC_Transaction(I2C_TRANSACTION_t* transaction, uint8_t* data);
+
+/*	---------------TCS34727_Unpack_RGBC---------------
+ *	Fill the RAW fields from the 8 bytes at CDATAL and normalize
+ *	them into RGB range (0-255)
+ *	Input: Data & RGB Color User Instance Struct
+ *	Output: none
+ */
+void TCS34727_Unpack_RGBC(const uint8_t* data, RGB_COLOR_HANDLE_t* RGB_COLOR_Instance);
+
+/*	----------------TCS34727_Get_Gain----------------
+ *	Current RGBC gain setting (shadow copy, no bus traffic)
+ *	Input: none
+ *	Output: AGAIN field of the control register
+ */
+uint8_t TCS34727_Get_Gain(void);
+
+/*	----------------TCS34727_Get_ATIME---------------
+ *	Current integration time setting (shadow copy, no bus traffic)
+ *	Input: none
+ *	Output: ATIME register value, integration time = (256 - ATIME) * 2.4ms
+ */
+uint8_t TCS34727_Get_ATIME(void);
+
+/*	--------------TCS34727_Refresh_Config-------------
+ *	Reload the shadow copy of ENABLE, ATIME and CONTROL, call it
+ *	after the sensor was power cycled behind the driver
+ *	Input: none
+ *	Output: Any Errors if detected, otherwise 0
+ */
+uint8_t TCS34727_Refresh_Config(void);
+
 /*	-----------------Detect_Color--------------------
  *	Detect which color is more prominant and returns that color
  *	Input: RGB Color User Instance Struct
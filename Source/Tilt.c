@@ -0,0 +1,156 @@
+/*
+ * Tilt.c
+ *
+ *	Main implementation of the complementary and Kalman roll/pitch
+ *	filters
+ *
+ */
+
+#include "Tilt.h"
+#include "FastMath.h"
+#include <string.h>
+
+#define RAD_TO_DEGREE				(57.2957795f)
+#define US_TO_S							(1e-6f)
+
+/*
+ *	-------------------Tilt_Wrap------------------
+ *	Local function that brings an angle back into -180..180, roll
+ *	crosses there when the sensor turns over
+ *	Input: Angle in degrees
+ *	Output: Same angle within -180..180
+ */
+static float Tilt_Wrap(float angle){
+	if(angle > 180.0f)
+		angle -= 360.0f;
+	else if(angle < -180.0f)
+		angle += 360.0f;
+	return angle;
+}
+
+/*
+ *	----------------Tilt_Kalman_Step---------------
+ *	Local function, one predict/correct step of an axis: the gyro
+ *	rate less the bias moves the angle, the accel tilt corrects
+ *	both
+ *	Input: Filter, Axis, Gyro Rate, Accel Angle & dt in s
+ *	Output: None
+ */
+static void Tilt_Kalman_Step(const TILT_FILTER_t* filter, TILT_KALMAN_AXIS_t* axis, float rate, float measured, float dt){
+
+	float P00;
+	float P01;
+	float S;
+	float K0;
+	float K1;
+	float y;
+
+	/* Predict */
+	axis->angle = Tilt_Wrap(axis->angle + dt*(rate - axis->bias));
+	axis->P[0][0] += dt*(dt*axis->P[1][1] - axis->P[0][1] - axis->P[1][0] + filter->q_angle);
+	axis->P[0][1] -= dt*axis->P[1][1];
+	axis->P[1][0] -= dt*axis->P[1][1];
+	axis->P[1][1] += dt*filter->q_bias;
+
+	/* Correct with the accel tilt */
+	P00 = axis->P[0][0];
+	P01 = axis->P[0][1];
+	S = P00 + filter->r_accel;
+	K0 = P00 / S;
+	K1 = axis->P[1][0] / S;
+	y = Tilt_Wrap(measured - axis->angle);
+
+	axis->angle = Tilt_Wrap(axis->angle + K0*y);
+	axis->bias += K1*y;
+
+	axis->P[0][0] -= K0*P00;
+	axis->P[0][1] -= K0*P01;
+	axis->P[1][0] -= K1*P00;
+	axis->P[1][1] -= K1*P01;
+}
+
+/*
+ *	-------------------Tilt_Init------------------
+ *	Set up a filter with the default tuning, the first update starts
+ *	it from the accelerometer tilt. Tuning fields can be changed
+ *	after this
+ *	Input: Filter & Mode (TILT_COMPLEMENTARY or TILT_KALMAN)
+ *	Output: None
+ */
+void Tilt_Init(TILT_FILTER_t* filter, uint8_t mode){
+	memset(filter, 0, sizeof(*filter));
+	filter->mode = mode;
+	filter->tau = TILT_DEFAULT_TAU;
+	filter->q_angle = TILT_DEFAULT_Q_ANGLE;
+	filter->q_bias = TILT_DEFAULT_Q_BIAS;
+	filter->r_accel = TILT_DEFAULT_R_ACCEL;
+}
+
+/*
+ *	------------------Tilt_Update-----------------
+ *	One filter step from a processed sample (g, degrees/s), dt is
+ *	the time since the previous update. Stamps wrap at 2^32 us
+ *	Input: Filter, MPU6050 Accel & Gyro User Instance Structs & Sample
+ *				 Time in us (TIMESTAMP_US when it was read)
+ *	Output: None (filter->roll and filter->pitch hold the result)
+ */
+void Tilt_Update(TILT_FILTER_t* filter, const MPU6050_ACCEL_t* Accel_Instance, const MPU6050_GYRO_t* Gyro_Instance, uint32_t timestamp_us){
+
+	uint32_t elapsed_us = timestamp_us - filter->last_us;		//Unsigned difference survives the wrap
+	float accel_roll;
+	float accel_pitch;
+	float dt;
+	float alpha;
+	uint8_t i;
+
+	/* Tilt the accelerometer alone sees */
+	accel_roll = FastMath_Atan2(Accel_Instance->Ay, Accel_Instance->Az) * RAD_TO_DEGREE;
+	accel_pitch = FastMath_Atan2(-Accel_Instance->Ax, FastMath_Hypot(Accel_Instance->Ay, Accel_Instance->Az)) * RAD_TO_DEGREE;
+
+	filter->last_us = timestamp_us;
+
+	//First sample, or too long since the last one to integrate across (the gyro bias is kept)
+	if(!filter->started || elapsed_us > TILT_MAX_DT_US){
+		filter->axis[0].angle = filter->roll = accel_roll;
+		filter->axis[1].angle = filter->pitch = accel_pitch;
+		for(i = 0; i < 2; i++){
+			filter->axis[i].P[0][0] = filter->axis[i].P[0][1] = 0.0f;
+			filter->axis[i].P[1][0] = filter->axis[i].P[1][1] = 0.0f;
+		}
+		filter->started = 1;
+		return;
+	}
+
+	//Same sample again, nothing to integrate
+	if(elapsed_us == 0)
+		return;
+	dt = (float)elapsed_us * US_TO_S;
+
+	if(filter->mode == TILT_KALMAN){
+		Tilt_Kalman_Step(filter, &filter->axis[0], Gyro_Instance->Gx, accel_roll, dt);
+		Tilt_Kalman_Step(filter, &filter->axis[1], Gyro_Instance->Gy, accel_pitch, dt);
+	}
+	else{
+		//Blend weight from the time constant, the same response at any sample rate
+		alpha = filter->tau / (filter->tau + dt);
+		filter->axis[0].angle = Tilt_Wrap(filter->axis[0].angle + dt*Gyro_Instance->Gx);
+		filter->axis[0].angle = Tilt_Wrap(filter->axis[0].angle + (1.0f - alpha)*Tilt_Wrap(accel_roll - filter->axis[0].angle));
+		filter->axis[1].angle += dt*Gyro_Instance->Gy;
+		filter->axis[1].angle += (1.0f - alpha)*(accel_pitch - filter->axis[1].angle);
+	}
+
+	filter->roll = filter->axis[0].angle;
+	filter->pitch = filter->axis[1].angle;
+}
+
+/*
+ *	-------------------Tilt_Reset-----------------
+ *	Forget the state, the next update starts over from the
+ *	accelerometer tilt (tuning is kept)
+ *	Input: Filter
+ *	Output: None
+ */
+void Tilt_Reset(TILT_FILTER_t* filter){
+	filter->started = 0;
+	filter->axis[0].bias = filter->axis[1].bias = 0.0f;
+}
@@ -0,0 +1,84 @@
+/*
+ * Tilt.h
+ *
+ *	Provides a roll/pitch attitude filter for the MPU6050: the gyro
+ *	rate is integrated over the measured time between samples and
+ *	the accelerometer tilt pulls out the drift. Either a
+ *	complementary filter or a 1D Kalman filter (angle and gyro bias)
+ *	per axis
+ *
+ *	Angles follow the MPU6050 axes: roll about X from Gx, pitch about
+ *	Y from Gy. Level and face up (Az = +1g) reads 0, 0
+ *
+ */
+
+#ifndef TILT_H_
+#define TILT_H_
+
+#include <stdint.h>
+#include "MPU6050.h"
+
+/* List of Tilt Macros */
+#define TILT_COMPLEMENTARY			(0)
+#define TILT_KALMAN							(1)
+
+#define TILT_DEFAULT_TAU				(0.5f)			//s, complementary filter: accel corrects slower than this
+#define TILT_DEFAULT_Q_ANGLE		(0.001f)		//Kalman process noise of the angle, per s
+#define TILT_DEFAULT_Q_BIAS			(0.003f)		//Kalman process noise of the gyro bias, per s
+#define TILT_DEFAULT_R_ACCEL		(0.5f)			//Kalman accel tilt measurement noise, degrees^2 (~0.7 degree rms at 1kHz)
+#define TILT_MAX_DT_US					(500000)		//A longer gap restarts from the accel tilt
+
+/* One Axis of the Kalman Filter */
+typedef struct{
+	float angle;											//degrees
+	float bias;												//degrees/s the gyro reads at rest
+	float P[2][2];										//Error covariance of angle and bias
+} TILT_KALMAN_AXIS_t;
+
+/* Filter State, one per sensor */
+typedef struct{
+	uint8_t mode;											//TILT_COMPLEMENTARY or TILT_KALMAN
+	uint8_t started;
+	uint32_t last_us;
+
+	float tau;												//Complementary time constant
+	float q_angle;										//Kalman tuning
+	float q_bias;
+	float r_accel;
+
+	TILT_KALMAN_AXIS_t axis[2];				//Roll, Pitch (complementary uses the angle only)
+
+	float roll;												//Filter output, degrees
+	float pitch;
+} TILT_FILTER_t;
+
+/*
+ *	-------------------Tilt_Init------------------
+ *	Set up a filter with the default tuning, the first update starts
+ *	it from the accelerometer tilt. Tuning fields can be changed
+ *	after this
+ *	Input: Filter & Mode (TILT_COMPLEMENTARY or TILT_KALMAN)
+ *	Output: None
+ */
+void Tilt_Init(TILT_FILTER_t* filter, uint8_t mode);
+
+/*
+ *	------------------Tilt_Update-----------------
+ *	One filter step from a processed sample (g, degrees/s), dt is
+ *	the time since the previous update. Stamps wrap at 2^32 us
+ *	Input: Filter, MPU6050 Accel & Gyro User Instance Structs & Sample
+ *				 Time in us (TIMESTAMP_US when it was read)
+ *	Output: None (filter->roll and filter->pitch hold the result)
+ */
+void Tilt_Update(TILT_FILTER_t* filter, const MPU6050_ACCEL_t* Accel_Instance, const MPU6050_GYRO_t* Gyro_Instance, uint32_t timestamp_us);
+
+/*
+ *	-------------------Tilt_Reset-----------------
+ *	Forget the state, the next update starts over from the
+ *	accelerometer tilt (tuning is kept)
+ *	Input: Filter
+ *	Output: None
+ */
+void Tilt_Reset(TILT_FILTER_t* filter);
+
+#endif //TILT_H_
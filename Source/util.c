@@ -12,9 +12,7 @@
 #include "util.h"
 #include "tm4c123gh6pm.h"
 
-/* Local Macros */
-#define TIMER_32_MAX_RELOAD		(4294967295)	
- 
+
 /* The reason why Wide Timer is used instead of regular time is because
 	 of the prescaler option */
 void WTIMER0_Init(void){
@@ -35,7 +33,7 @@ void WTIMER0_Init(void){
 }
 
 void DELAY_1MS(uint32_t delay){
-	WTIMER0_TAILR_R = delay - 1;
+	WTIMER0_TAILR_R = delay;												//Counts TAILR down to 0: one tick per ms
 	WTIMER0_CTL_R |= WTIMER0_TAEN_BIT;
 	while(WTIMER0_TAR_R != 0);
 	WTIMER0_CTL_R &= ~(WTIMER0_TAEN_BIT);
@@ -50,3 +48,66 @@ int16_t map(int16_t x, int16_t x_min, int16_t x_max, int16_t out_min, int16_t ou
 	}
 	return (x - x_min) * (out_max - out_min) / (x_max - x_min) + out_min;
 }
+
+
+/* WTIMER1 free runs with a 1us tick so timestamps and timeouts
+	 don't fight DELAY_1MS over WTIMER0. Wraps every ~71 minutes,
+	 always compare timestamps by subtraction */
+void WTIMER1_Init(void){
+	SYSCTL_RCGCWTIMER_R |= EN_WTIMER1_CLOCK;						//Enable WTIMER1 Clock
+	
+	//Wait Until WTIMER1 Clock has be activated
+	while((SYSCTL_RCGCWTIMER_R&EN_WTIMER1_CLOCK)!=EN_WTIMER1_CLOCK);
+	
+	WTIMER1_CTL_R &= ~(WTIMER0_TAEN_BIT);									//Disable WTIMER1 Timer A
+	WTIMER1_CFG_R |= WTIMER0_32_BIT_CFG;								//Set WTIMER1 to be 32-bit config mode
+	WTIMER1_TAMR_R |= WTIMER0_PERIOD_MODE;							//Set WTIMER1 to be in periodic mode (count down)
+	WTIMER1_TAPR_R = US_PRESCALER_VALUE;								//Prescale down to 1MHz or 1us period
+	WTIMER1_TAILR_R = TIMER_32_MAX_RELOAD;							//Full 32-bit range
+	WTIMER1_CTL_R |= WTIMER0_TAEN_BIT;									//Start counting
+}
+
+uint32_t TIMESTAMP_US(void){
+	return TIMER_32_MAX_RELOAD - WTIMER1_TAR_R;					//Counts down, flip it into elapsed us
+}
+
+/* PRIMASK save/disable and restore. Nests, safe to call from ISRs */
+#if defined(__CC_ARM)
+uint32_t START_CRITICAL(void){
+	register uint32_t primask __asm("primask");
+	uint32_t state = primask;
+	__disable_irq();
+	return state;
+}
+
+void END_CRITICAL(uint32_t state){
+	register uint32_t primask __asm("primask");
+	primask = state;
+}
+#elif defined(__arm__) || defined(__thumb__)
+uint32_t START_CRITICAL(void){
+	uint32_t state;
+	__asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(state) :: "memory");
+	return state;
+}
+
+void END_CRITICAL(uint32_t state){
+	__asm volatile("msr primask, %0" :: "r"(state) : "memory");
+}
+#else
+//Host build: interrupts are simulated, PRIMASK is a flag the simulator checks
+volatile uint32_t HOST_PRIMASK;
+void HOST_IRQ_Unmasked(void);												//Simulator takes interrupts that came in while masked
+
+uint32_t START_CRITICAL(void){
+	uint32_t state = HOST_PRIMASK;
+	HOST_PRIMASK = 1;
+	return state;
+}
+
+void END_CRITICAL(uint32_t state){
+	HOST_PRIMASK = state;
+	if(!state)
+		HOST_IRQ_Unmasked();
+}
+#endif
\ No newline at end of file
@@ -25,8 +25,31 @@
 #define WTIMER0_PERIOD_MODE		(0x2)
 #define PRESCALER_VALUE				(16000)
 
+/* System Clock (default PIOSC, no PLL) */
+#define SYS_CLOCK_HZ					(16000000)
+
+/* Free Running Microsecond Timebase */
+#define EN_WTIMER1_CLOCK			(0x02)
+#define US_PRESCALER_VALUE		(SYS_CLOCK_HZ/1000000 - 1)
+#define TIMER_32_MAX_RELOAD		(0xFFFFFFFF)
+
 void WTIMER0_Init(void);
 void DELAY_1MS(uint32_t);
 int16_t map(int16_t, int16_t, int16_t, int16_t, int16_t);
 
+void WTIMER1_Init(void);
+uint32_t TIMESTAMP_US(void);
+
+uint32_t START_CRITICAL(void);
+void END_CRITICAL(uint32_t);
+
+/* Memory Barrier: every memory access before it is done before any after it (compiler and CPU) */
+#if defined(__CC_ARM)
+#define MEMORY_BARRIER()			__dmb(0xF)
+#elif defined(__arm__) || defined(__thumb__)
+#define MEMORY_BARRIER()			__asm volatile("dmb" ::: "memory")
+#else
+#define MEMORY_BARRIER()			__sync_synchronize()
+#endif
+
 #endif
\ No newline at end of file